@@ -0,0 +1,53 @@
+#pragma once
+
+// Timing and printing shared by the benchmarks: every run is timed separately and summarised by its best and
+// median wall clock time, and a row reports the median as throughput.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace GameProgramming::Benchmark
+{
+
+struct Result
+{
+    double bestMs;
+    double medianMs;
+};
+
+// Times `run` `iterations` times; `prepare` runs before each, outside the measurement (e.g. to evict caches).
+inline Result measure(int iterations, const std::function<void()> &prepare, const std::function<void()> &run)
+{
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    for (int i = 0; i < iterations; ++i)
+    {
+        prepare();
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return {samples.front(), samples[samples.size() / 2]};
+}
+
+inline Result measure(int iterations, const std::function<void()> &run)
+{
+    return measure(iterations, [] {}, run);
+}
+
+// "  <name>  median .. ms  best .. ms  <amount per second> <unit>/s", with `name` padded to `nameWidth`.
+inline void report(std::string_view name, int nameWidth, Result result, double amount, const char *unit)
+{
+    const std::string label{name};
+    std::printf("  %-*s median %8.3f ms  best %8.3f ms  %8.1f %s/s\n", nameWidth, label.c_str(), result.medianMs, result.bestMs,
+                amount / (result.medianMs / 1000.0), unit);
+}
+
+} // namespace GameProgramming::Benchmark
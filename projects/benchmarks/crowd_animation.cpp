@@ -0,0 +1,105 @@
+// Measures one frame of crowd animation, CrowdAnimation::update, for 10k and 100k characters of 20 bones on
+// 1, 2, 4, ... threads up to every hardware thread: advancing each character's AnimationPlayer, blending its
+// pose, walking the skeleton and writing the bone instances. The skeleton is a plain chain and the clips are
+// random poses; the work per character matches the week7 crowd's.
+// Instances go to plain memory here; in week7 they go to the mapped instance buffer.
+//
+// usage: crowd-animation-bench [iterations]
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "bench_common.hpp"
+#include "crowd_animation.hpp"
+#include "job_system.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using namespace GameProgramming::Animation;
+using GameProgramming::Benchmark::measure;
+using GameProgramming::Benchmark::Result;
+
+constexpr u32 BoneCount = 20;
+
+glm::quat randomRotation(std::mt19937 &random)
+{
+    std::normal_distribution<float> normal;
+    return glm::normalize(glm::quat(normal(random), normal(random), normal(random), normal(random)));
+}
+
+AnimationClip randomClip(std::mt19937 &random, u32 keyCount)
+{
+    AnimationClip clip(BoneCount);
+    std::vector<glm::quat> rotations(BoneCount);
+    for (u32 key = 0; key < keyCount; ++key)
+    {
+        std::generate(rotations.begin(), rotations.end(), [&] { return randomRotation(random); });
+        clip.addKey(0.5f * key, rotations.data());
+    }
+    clip.setLoop(0, 0.5f * keyCount);
+    return clip;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 50;
+    const u32 hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%d iterations, %u bones per character, %u hardware threads, %s blend\n", iterations, BoneCount, hardwareThreads,
+                bestBlendKernels().name);
+
+    std::mt19937 random(42);
+    Skeleton skeleton;
+    for (u32 bone = 0; bone < BoneCount; ++bone)
+        skeleton.addBone(static_cast<i32>(bone) - 1, glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f), glm::vec3(0.5f, 1.0f, 0.5f));
+    const std::vector<glm::vec3> colors(BoneCount, glm::vec3(1.0f));
+
+    // two looping states that keep fading into each other, like the week7 walk and greet
+    AnimationStateMachine machine(BoneCount);
+    const u32 walk = machine.addClip(randomClip(random, 4));
+    const u32 greet = machine.addClip(randomClip(random, 5));
+    machine.addState("walk", walk);
+    machine.addState("greet", greet);
+    machine.setExit(0, 2, 1, 1.5f);
+    machine.setExit(1, 2, 0, 1.0f);
+
+    std::vector<u32> threadCounts;
+    for (u32 threads = 1; threads < hardwareThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(hardwareThreads);
+
+    for (const u32 characters : {10'000u, 100'000u})
+    {
+        std::printf("%u characters, %u bones\n", characters, characters * BoneCount);
+        std::vector<BoneInstance> instances(static_cast<std::size_t>(characters) * BoneCount);
+
+        double serialMs = 0.0;
+        for (const u32 threads : threadCounts)
+        {
+            GameProgramming::Job::JobSystem jobs(threads - 1);
+            CrowdAnimation crowd(machine, skeleton, colors.data(), jobs);
+            std::uniform_real_distribution<float> start(0.0f, 20.0f);
+            for (u32 c = 0; c < characters; ++c)
+                crowd.add(glm::translate(glm::mat4(1.0f), glm::vec3(c % 100, 0.0f, c / 100)), 0, start(random));
+
+            const Result result = measure(iterations, [&] { crowd.update(1.0f / 60.0f, instances.data()); });
+            if (threads == 1)
+                serialMs = result.medianMs;
+
+            std::printf("  %3u threads  median %8.3f ms  best %8.3f ms  %6.2fx\n", threads, result.medianMs, result.bestMs,
+                        serialMs / result.medianMs);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+// Post-transform vertex cache report for the meshes the demos draw. The teapot (teapot.vbo) and the
+// 40x20 uv sphere the demos used to generate per target are measured as a triangle soup, after welding,
+// and after the vertex cache + fetch optimizer, on FIFO caches of a few common sizes. The shared sphere
+// LOD chain the demos draw now is listed level by level.
+//
+// usage: mesh-cache-report [teapot.vbo]
+
+#include "mesh_builder.hpp"
+#include "mesh_optimizer.hpp"
+#include "sphere.hpp"
+#include "teapot_loader.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <vector>
+
+#ifndef RESOURCE_PATH_PREFIX
+#define RESOURCE_PATH_PREFIX ""
+#endif
+
+using namespace GameProgramming::Mesh;
+
+namespace
+{
+
+// Same parametrization and vertex layout (position, normal, uv) as the old per-target init_sphere.
+std::vector<float> sphereSoup(int nu, int nv)
+{
+    const float pi = std::acos(-1.0f);
+    const float du = 2.0f * pi / static_cast<float>(nu);
+    const float dv = pi / static_cast<float>(nv);
+    std::vector<float> soup;
+    const auto corner = [&](int i, int j)
+    {
+        const float u = static_cast<float>(i) * du;
+        const float v = -0.5f * pi + static_cast<float>(j) * dv;
+        const float p[3] = {std::cos(v) * std::cos(u), std::cos(v) * std::sin(u), std::sin(v)};
+        soup.insert(soup.end(), {p[0], p[1], p[2], p[0], p[1], p[2], static_cast<float>(i) / static_cast<float>(nu),
+                                 static_cast<float>(j) / static_cast<float>(nv)});
+    };
+    for (int j = 1; j < nv - 1; ++j)
+    {
+        for (int i = 0; i < nu; ++i)
+        {
+            corner(i, j), corner(i + 1, j), corner(i, j + 1);
+            corner(i + 1, j), corner(i + 1, j + 1), corner(i, j + 1);
+        }
+    }
+    return soup;
+}
+
+void report(const char *name, const std::vector<float> &soup, u32 floatsPerVertex)
+{
+    const u32 corners = static_cast<u32>(soup.size() / floatsPerVertex);
+    std::vector<u32> soupIndices(corners);
+    std::iota(soupIndices.begin(), soupIndices.end(), 0u);
+
+    IndexedMesh welded = MeshBuilder::weld(soup, floatsPerVertex);
+    IndexedMesh optimized = welded;
+    const auto start = std::chrono::steady_clock::now();
+    optimizeMesh(optimized);
+    const double optimizeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%s: %u triangles, %u corners, %u unique vertices (optimized in %.2f ms)\n", name, corners / 3, corners,
+                welded.vertexCount(), optimizeMs);
+    std::printf("  %-10s %6s %8s %8s %12s\n", "", "cache", "ACMR", "ATVR", "transforms");
+    for (u32 cacheSize : {8u, 16u, 32u})
+    {
+        const VertexCacheStatistics soupStats = analyzeVertexCache(soupIndices, corners, cacheSize);
+        const VertexCacheStatistics weldedStats = analyzeVertexCache(welded.indices, welded.vertexCount(), cacheSize);
+        const VertexCacheStatistics optimizedStats = analyzeVertexCache(optimized.indices, optimized.vertexCount(), cacheSize);
+        // ATVR of the soup is relative to the welded vertex count so the three rows compare the same work
+        std::printf("  %-10s %6u %8.3f %8.3f %12u\n", "soup", cacheSize, soupStats.acmr,
+                    static_cast<float>(soupStats.vertexTransforms) / static_cast<float>(welded.vertexCount()), soupStats.vertexTransforms);
+        std::printf("  %-10s %6u %8.3f %8.3f %12u\n", "welded", cacheSize, weldedStats.acmr, weldedStats.atvr, weldedStats.vertexTransforms);
+        std::printf("  %-10s %6u %8.3f %8.3f %12u\n", "optimized", cacheSize, optimizedStats.acmr, optimizedStats.atvr,
+                    optimizedStats.vertexTransforms);
+    }
+}
+
+void reportSphereLods()
+{
+    const SphereLodChain<8, 128> sphere;
+    std::printf("sphere LOD chain: %u vertices, %u indices (%s) in one VBO/IBO\n", sphere.mesh().vertexCount(), sphere.mesh().indexCount(),
+                sphere.mesh().indexType() == IndexType::UnsignedShort ? "16-bit" : "32-bit");
+    std::printf("  %-8s %8s %10s %8s %8s %8s\n", "level", "grid", "triangles", "vertices", "ACMR", "ATVR");
+    for (u32 level = 0; level < sphere.LodCount; ++level)
+    {
+        const SphereLod &lod = sphere.lod(level);
+        const u32 end = level + 1 < sphere.LodCount ? sphere.lod(level + 1).baseVertex : sphere.mesh().vertexCount();
+        const VertexCacheStatistics stats =
+            analyzeVertexCache(std::span{sphere.mesh().indices}.subspan(lod.firstIndex, lod.indexCount), end - lod.baseVertex);
+        std::printf("  %-8u %4ux%-3u %10u %8u %8.3f %8.3f\n", level, lod.segments, lod.rings, lod.indexCount / 3, end - lod.baseVertex,
+                    stats.acmr, stats.atvr);
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const char *teapotPath = argc > 1 ? argv[1] : RESOURCE_PATH_PREFIX "other/teapot.vbo";
+
+    std::vector<float> teapot;
+    if (!Teapot{teapotPath, teapot, 8}.err)
+    {
+        std::fprintf(stderr, "Failed to read %s\n", teapotPath);
+        return EXIT_FAILURE;
+    }
+
+    report("teapot", teapot, 8);
+    report("sphere 40x20", sphereSoup(40, 20), 8);
+    reportSphereLods();
+    return EXIT_SUCCESS;
+}
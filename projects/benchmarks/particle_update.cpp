@@ -0,0 +1,172 @@
+// Measures one frame of CPU fireworks at 100k to 1M live particles:
+//   aos        : particles as one interleaved struct each, updated on one thread (the layout 70.2 started from)
+//   scalar x1  : ParticlePool, one array per component, plain C++ kernels on the calling thread only
+//   avx2 x1    : the same with the AVX2 kernels, 8 particles at a time
+//   <best> xN  : ParticlePool split in chunks over every hardware thread, with the kernels CPUID picked
+// and the spawn side: glm::gaussRand/linearRand on one thread against ParticlePool::spawn, scalar polar method
+// against the vectorized Box-Muller, first on the calling thread only and then with generators on every hardware
+// thread. AVX2 rows are skipped on CPUs without it.
+// The sort rows put the vertices back to front with DepthSorter, as the demo's depth sorted blend mode does.
+// Vertices go to plain memory here; in the demo they go to the mapped StreamBuffer.
+//
+// usage: particle-update-bench [iterations]
+
+#include <glm/glm.hpp>
+#include <glm/gtc/random.hpp>
+
+#include "bench_common.hpp"
+#include "job_system.hpp"
+#include "particle_pool.hpp"
+#include "particle_sort.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+using GameProgramming::Particle::DepthSorter;
+using GameProgramming::Particle::Kernels;
+using GameProgramming::Particle::ParticlePool;
+using GameProgramming::Particle::ParticleVertex;
+using GameProgramming::Particle::Shot;
+using GameProgramming::Benchmark::measure;
+using GameProgramming::Benchmark::Result;
+
+constexpr float DeltaTime = 1.0f / 60.0f;
+const glm::vec3 Gravity{0.0f, -0.2f, 0.0f};
+constexpr float Drag = 0.1f;
+
+// The baseline: everything about a particle side by side, as the interleaved float array had it.
+struct AosParticle
+{
+    glm::vec3 position;
+    glm::vec3 velocity;
+    u32 color; // RGB8, as the pool keeps it
+    float age;
+    float lifetime;
+};
+
+u32 packColor(const glm::vec3 &color)
+{
+    const auto channel = [](float value) { return static_cast<u32>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+    return channel(color.r) | channel(color.g) << 8 | channel(color.b) << 16;
+}
+
+void spawnAos(std::vector<AosParticle> &particles, const Shot &shot)
+{
+    for (AosParticle &particle : particles)
+    {
+        particle.position = shot.origin;
+        particle.velocity = shot.velocity + glm::gaussRand(glm::vec3(0.0f), glm::vec3(shot.velocityDeviation));
+        particle.color = packColor(shot.color + glm::linearRand(glm::vec3(-shot.colorJitter), glm::vec3(shot.colorJitter)));
+        particle.age = 0.0f;
+        particle.lifetime = shot.lifetime;
+    }
+}
+
+void updateAos(std::vector<AosParticle> &particles, ParticleVertex *vertices)
+{
+    for (AosParticle &particle : particles)
+    {
+        if (particle.age >= particle.lifetime)
+        {
+            *vertices++ = {particle.position, 0};
+            continue;
+        }
+        particle.velocity += (Gravity - Drag * particle.velocity) * DeltaTime;
+        particle.position += particle.velocity * DeltaTime;
+        particle.age += DeltaTime;
+
+        const float alpha = 1.0f - particle.age / particle.lifetime;
+        *vertices++ = {particle.position, particle.color | static_cast<u32>(alpha * 255.0f + 0.5f) << 24};
+    }
+}
+
+void report(std::string_view name, u32 particles, Result result)
+{
+    GameProgramming::Benchmark::report(name, 18, result, particles / 1e6, "Mparticles");
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 50;
+
+    // a lifetime no frame reaches, so every particle stays live the whole run
+    Shot shot;
+    shot.velocity = glm::vec3(0.0f, 0.5f, 0.0f);
+    shot.velocityDeviation = 0.04f;
+    shot.color = glm::vec3(0.65f);
+    shot.lifetime = 1e6f;
+
+    const Kernels &scalar = GameProgramming::Particle::scalarKernels();
+    const Kernels *avx2 = GameProgramming::Particle::avx2Kernels();
+    const Kernels &best = GameProgramming::Particle::bestKernels();
+
+    GameProgramming::Job::JobSystem serial(0);
+    GameProgramming::Job::JobSystem parallel;
+    std::printf("%d iterations, %u threads, %s\n", iterations, parallel.threadCount(), avx2 ? "avx2" : "no avx2");
+
+    for (const u32 count : {100'000u, 250'000u, 500'000u, 1'000'000u})
+    {
+        std::printf("%u particles\n", count);
+        shot.count = count;
+        std::vector<ParticleVertex> vertices(count);
+
+        std::vector<AosParticle> aos(count);
+        spawnAos(aos, shot);
+        report("update aos", count, measure(iterations, [&] { updateAos(aos, vertices.data()); }));
+
+        const auto updatePool = [&](const std::string &name, GameProgramming::Job::JobSystem &jobs, const Kernels &kernels)
+        {
+            ParticlePool pool(count, jobs, 1, kernels);
+            pool.spawn(shot);
+            report("update " + name, count, measure(iterations, [&] { pool.update(DeltaTime, Gravity, Drag, vertices.data()); }));
+        };
+        updatePool("scalar x1", serial, scalar);
+        if (avx2)
+            updatePool("avx2 x1", serial, *avx2);
+        updatePool(std::string(best.name) + " xN", parallel, best);
+
+        const auto spawnPool = [&](const std::string &name, GameProgramming::Job::JobSystem &jobs, const Kernels &kernels)
+        {
+            ParticlePool pool(count, jobs, 1, kernels);
+            report("spawn " + name, count, measure(iterations, [&] { pool.spawn(shot); }));
+        };
+        // a spread out shell seen from the demo's camera
+        std::vector<ParticleVertex> unsorted(count);
+        {
+            Shot wide = shot;
+            wide.velocityDeviation = 0.3f;
+            ParticlePool pool(count, parallel, 1, best);
+            pool.spawn(wide);
+            for (int frame = 0; frame < 60; ++frame)
+            {
+                pool.update(DeltaTime, Gravity, Drag, unsorted.data());
+            }
+        }
+        glm::mat4 view(1.0f);
+        view[3][2] = -3.0f;
+        DepthSorter serialSorter(serial);
+        DepthSorter parallelSorter(parallel);
+        report("sort x1", count, measure(iterations, [&] { serialSorter.sort(unsorted.data(), count, view, vertices.data()); }));
+        report("sort xN", count, measure(iterations, [&] { parallelSorter.sort(unsorted.data(), count, view, vertices.data()); }));
+
+        // x1 rows against the glm baseline isolate the generators; xN rows then add the threads
+        report("spawn glm x1", count, measure(iterations, [&] { spawnAos(aos, shot); }));
+        spawnPool("scalar x1", serial, scalar);
+        if (avx2)
+            spawnPool("avx2 x1", serial, *avx2);
+        spawnPool("scalar xN", parallel, scalar);
+        if (avx2)
+            spawnPool("avx2 xN", parallel, *avx2);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,108 @@
+// Measures blending two poses of 20 bones for 1k to 100k characters, every bone at its character's weight:
+//   glm::slerp  : quaternions side by side, one glm::slerp per bone (what Human::MixPose does per character)
+//   scalar      : QuatArray, one array per component, the corrected nlerp one quaternion at a time
+//   avx2        : the same 8 quaternions at a time; skipped on CPUs without AVX2
+// and how far the approximation lands from glm::slerp, as the largest angle between the two results.
+//
+// usage: pose-blend-bench [iterations]
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "bench_common.hpp"
+#include "pose_blend.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+using GameProgramming::Animation::BlendKernels;
+using GameProgramming::Animation::QuatArray;
+using GameProgramming::Benchmark::measure;
+using GameProgramming::Benchmark::Result;
+
+constexpr u32 BonesPerCharacter = 20;
+
+void report(std::string_view name, u32 bones, Result result)
+{
+    GameProgramming::Benchmark::report(name, 12, result, bones / 1e6, "Mbones");
+}
+
+glm::quat randomRotation(std::mt19937 &random)
+{
+    std::normal_distribution<float> normal;
+    return glm::normalize(glm::quat(normal(random), normal(random), normal(random), normal(random)));
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 50;
+
+    const BlendKernels &scalar = GameProgramming::Animation::scalarBlendKernels();
+    const BlendKernels *avx2 = GameProgramming::Animation::avx2BlendKernels();
+    std::printf("%d iterations, %u bones per character, %s\n", iterations, BonesPerCharacter, avx2 ? "avx2" : "no avx2");
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    for (const u32 characters : {1'000u, 10'000u, 100'000u})
+    {
+        const u32 bones = characters * BonesPerCharacter;
+        std::printf("%u characters, %u bones\n", characters, bones);
+
+        std::vector<glm::quat> from(bones), to(bones), blended(bones);
+        std::vector<float> characterWeights(characters);
+        QuatArray fromSoA(bones), toSoA(bones), blendedSoA(bones);
+        std::vector<float> weights(bones);
+        for (u32 i = 0; i < bones; ++i)
+        {
+            from[i] = randomRotation(random);
+            to[i] = randomRotation(random);
+            fromSoA.set(i, from[i]);
+            toSoA.set(i, to[i]);
+        }
+        for (u32 c = 0; c < characters; ++c)
+        {
+            characterWeights[c] = uniform(random);
+            std::fill_n(weights.begin() + c * BonesPerCharacter, BonesPerCharacter, characterWeights[c]);
+        }
+
+        report("glm::slerp", bones, measure(iterations, [&] {
+            for (u32 c = 0; c < characters; ++c)
+            {
+                const u32 first = c * BonesPerCharacter;
+                for (u32 b = first; b < first + BonesPerCharacter; ++b)
+                    blended[b] = glm::slerp(from[b], to[b], characterWeights[c]);
+            }
+        }));
+
+        const auto blendSoA = [&](const BlendKernels &kernels)
+        {
+            report(kernels.name, bones, measure(iterations, [&] {
+                kernels.blend(fromSoA.streams(), toSoA.streams(), weights.data(), bones, blendedSoA.streams());
+            }));
+
+            float worst = 0.0f;
+            for (u32 i = 0; i < bones; ++i)
+            {
+                const float cosine = std::min(1.0f, std::abs(glm::dot(blended[i], blendedSoA.get(i))));
+                worst = std::max(worst, 2.0f * std::acos(cosine));
+            }
+            std::printf("  %-12s largest error %.5f rad\n", "", worst);
+        };
+        blendSoA(scalar);
+        if (avx2)
+            blendSoA(*avx2);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,152 @@
+// Measures how fast teapot.vbo is turned into floats:
+//   iostream : the original `input >> double` loop Teapot used to run
+//   chunked  : Teapot::loadVertexData (single read + from_chars)
+//   mapped   : the binary teapot.mesh through MeshFile (mmap + checksum), for reference
+// Each is timed on a cold page cache (Linux only, via POSIX_FADV_DONTNEED) and a warm one.
+//
+// usage: vbo-parse-bench [teapot.vbo] [teapot.mesh] [iterations]
+
+#include "bench_common.hpp"
+#include "mesh_file.hpp"
+#include "teapot_loader.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifndef RESOURCE_PATH_PREFIX
+#define RESOURCE_PATH_PREFIX ""
+#endif
+
+namespace
+{
+
+using GameProgramming::Benchmark::measure;
+using GameProgramming::Benchmark::Result;
+
+// The parse loop Teapot::loadVertexData used before the chunked reader, kept as the baseline.
+bool loadWithIostream(const std::string &filename, std::vector<float> &data, unsigned int nVertFloats)
+{
+    std::ifstream input(filename.c_str());
+    if (!input)
+        return false;
+
+    int numFloats;
+    double vertData;
+    if (input >> numFloats)
+    {
+        if (numFloats > 0)
+        {
+            data.resize(numFloats);
+            int i = 0;
+            while (input >> vertData && i < numFloats)
+            {
+                data[i] = float(vertData);
+                i++;
+            }
+            if (i != numFloats || numFloats % nVertFloats)
+                return false;
+        }
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+// Drops the file's pages from the page cache so the next read has to hit the disk.
+bool evictFromPageCache(const std::filesystem::path &path)
+{
+#if defined(__linux__)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    ::fdatasync(fd);
+    bool ok = ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    ::close(fd);
+    return ok;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+void report(const char *name, const char *cache, std::uintmax_t bytes, Result result)
+{
+    char label[32];
+    std::snprintf(label, sizeof(label), "%-9s %-5s", name, cache);
+    GameProgramming::Benchmark::report(label, 16, result, static_cast<double>(bytes) / (1024.0 * 1024.0), "MB");
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::filesystem::path vboPath = argc > 1 ? argv[1] : RESOURCE_PATH_PREFIX "other/teapot.vbo";
+    const std::filesystem::path meshPath = argc > 2 ? argv[2] : RESOURCE_PATH_PREFIX "other/teapot.mesh";
+    const int iterations = argc > 3 ? std::max(1, std::atoi(argv[3])) : 20;
+
+    if (!std::filesystem::exists(vboPath))
+    {
+        std::fprintf(stderr, "Missing %s\n", vboPath.string().c_str());
+        return EXIT_FAILURE;
+    }
+    const std::uintmax_t vboBytes = std::filesystem::file_size(vboPath);
+
+    // both text paths have to agree before their speed means anything
+    std::vector<float> reference, chunked;
+    if (!loadWithIostream(vboPath.string(), reference, 8) || !Teapot{vboPath.string().c_str(), chunked, 8}.err || reference != chunked)
+    {
+        std::fprintf(stderr, "iostream and chunked parsers disagree on %s\n", vboPath.string().c_str());
+        return EXIT_FAILURE;
+    }
+    std::printf("%s: %ju bytes, %zu floats, %d iterations\n", vboPath.string().c_str(), vboBytes, reference.size(), iterations);
+
+    const bool canEvict = evictFromPageCache(vboPath);
+    if (!canEvict)
+        std::printf("  (cold cache runs skipped: page cache eviction is not supported here)\n");
+
+    const auto nothing = [] {};
+    const auto evictVbo = [&] { evictFromPageCache(vboPath); };
+
+    const auto runIostream = [&]
+    {
+        std::vector<float> data;
+        loadWithIostream(vboPath.string(), data, 8);
+    };
+    const auto runChunked = [&]
+    {
+        std::vector<float> data;
+        Teapot teapot{vboPath.string().c_str(), data, 8};
+    };
+
+    if (canEvict)
+    {
+        report("iostream", "cold", vboBytes, measure(iterations, evictVbo, runIostream));
+        report("chunked", "cold", vboBytes, measure(iterations, evictVbo, runChunked));
+    }
+    report("iostream", "warm", vboBytes, measure(iterations, nothing, runIostream));
+    report("chunked", "warm", vboBytes, measure(iterations, nothing, runChunked));
+
+    if (std::filesystem::exists(meshPath))
+    {
+        // MB/s is relative to the text file so all rows compare the same mesh
+        const auto evictMesh = [&] { evictFromPageCache(meshPath); };
+        const auto runMapped = [&] { GameProgramming::Mesh::MeshFile mesh{meshPath}; };
+        if (canEvict)
+            report("mapped", "cold", vboBytes, measure(iterations, evictMesh, runMapped));
+        report("mapped", "warm", vboBytes, measure(iterations, nothing, runMapped));
+    }
+
+    return EXIT_SUCCESS;
+}
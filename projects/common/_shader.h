@@ -4,10 +4,17 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include "constant_buffers.hpp"
+#include "gl_extensions.hpp"
+#include "program_cache.hpp"
+#include "uniform_table.hpp"
+
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 class Shader
 {
@@ -17,6 +24,9 @@ public:
 	// ------------------------------------------------------------------------
 	Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr)
 	{
+		sourcePaths = {vertexPath, fragmentPath};
+		if (geometryPath != nullptr)
+			sourcePaths.push_back(geometryPath);
 		// 1. retrieve the vertex/fragment source code from filePath
 		std::string vertexCode;
 		std::string fragmentCode;
@@ -57,119 +67,293 @@ public:
 		{
 			std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
 		}
-		const char* vShaderCode = vertexCode.c_str();
-		const char * fShaderCode = fragmentCode.c_str();
-		// 2. compile shaders
-		unsigned int vertex, fragment;
-		// vertex shader
-		vertex = glCreateShader(GL_VERTEX_SHADER);
-		glShaderSource(vertex, 1, &vShaderCode, NULL);
-		glCompileShader(vertex);
-		checkCompileErrors(vertex, "VERTEX");
-		// fragment Shader
-		fragment = glCreateShader(GL_FRAGMENT_SHADER);
-		glShaderSource(fragment, 1, &fShaderCode, NULL);
-		glCompileShader(fragment);
-		checkCompileErrors(fragment, "FRAGMENT");
-		// if geometry shader is given, compile geometry shader
-		unsigned int geometry;
-		if (geometryPath != nullptr)
-		{
-			const char * gShaderCode = geometryCode.c_str();
-			geometry = glCreateShader(GL_GEOMETRY_SHADER);
-			glShaderSource(geometry, 1, &gShaderCode, NULL);
-			glCompileShader(geometry);
-			checkCompileErrors(geometry, "GEOMETRY");
-		}
 		// shader Program
 		ID = glCreateProgram();
-		glAttachShader(ID, vertex);
-		glAttachShader(ID, fragment);
-		if (geometryPath != nullptr)
-			glAttachShader(ID, geometry);
-		glLinkProgram(ID);
-		checkCompileErrors(ID, "PROGRAM");
-		// delete the shaders as they're linked into our program now and no longer necessery
-		glDeleteShader(vertex);
-		glDeleteShader(fragment);
-		if (geometryPath != nullptr)
-			glDeleteShader(geometry);
-
+		// a warm start links straight from the binary an earlier run left in the program cache
+		using GameProgramming::Shader::ProgramBinaryCache;
+		const u64 cacheKey = geometryPath != nullptr ? ProgramBinaryCache::key({vertexCode, fragmentCode, geometryCode})
+		                                             : ProgramBinaryCache::key({vertexCode, fragmentCode});
+		if (ProgramBinaryCache::load(ID, cacheKey))
+			programLinked();
+		else
+		{
+			submitCompileAndLink(ID, pendingShaders, vertexCode, fragmentCode, geometryPath != nullptr ? &geometryCode : nullptr);
+			pendingCacheKey = cacheKey;
+		}
+	}
+	// a copy would link, detach and delete the same in-flight shaders twice; moves leave the source empty
+	// ------------------------------------------------------------------------
+	Shader(const Shader &) = delete;
+	Shader &operator=(const Shader &) = delete;
+	Shader(Shader &&other) noexcept
+		: ID(std::exchange(other.ID, 0)),
+		  pendingShaders(std::exchange(other.pendingShaders, {})),
+		  pendingCacheKey(other.pendingCacheKey),
+		  uniforms(std::move(other.uniforms)),
+		  sourcePaths(std::move(other.sourcePaths)),
+		  reloadProgram(std::exchange(other.reloadProgram, 0)),
+		  reloadShaders(std::exchange(other.reloadShaders, {})),
+		  reloadCacheKey(other.reloadCacheKey)
+	{
+	}
+	Shader &operator=(Shader &&other) noexcept
+	{
+		if (this != &other)
+		{
+			discardShaders(ID, pendingShaders);
+			discardShaders(reloadProgram, reloadShaders);
+			glDeleteProgram(reloadProgram);
+			glDeleteProgram(ID);
+			ID = std::exchange(other.ID, 0);
+			pendingShaders = std::exchange(other.pendingShaders, {});
+			pendingCacheKey = other.pendingCacheKey;
+			uniforms = std::move(other.uniforms);
+			sourcePaths = std::move(other.sourcePaths);
+			reloadProgram = std::exchange(other.reloadProgram, 0);
+			reloadShaders = std::exchange(other.reloadShaders, {});
+			reloadCacheKey = other.reloadCacheKey;
+		}
+		return *this;
 	}
 	// activate the shader
 	// ------------------------------------------------------------------------
 	void use()
 	{
+		finishLink();
 		glUseProgram(ID);
 	}
 
 	void use() const
 	{
+		finishLink();
 		glUseProgram(ID);
 	}
+	// typed uniform handles: look up once, then set every frame without a name lookup
+	// ------------------------------------------------------------------------
+	template <typename T>
+	GameProgramming::Shader::Uniform<T> uniform(const std::string &name) const
+	{
+		finishLink();
+		return uniforms.uniform<T>(name);
+	}
+	// every active uniform of the current program, for helpers that set several of them
+	const GameProgramming::Shader::UniformTable &uniformTable() const
+	{
+		finishLink();
+		return uniforms;
+	}
+	template <typename T>
+	void set(GameProgramming::Shader::Uniform<T> uniform, const T &value) const
+	{
+		GameProgramming::Shader::setUniform(uniform, value);
+	}
 	// utility uniform functions
 	// ------------------------------------------------------------------------
+	GLint getUniformLocation(const std::string &name) const
+	{
+		finishLink();
+		return uniforms.location(name);
+	}
+	// ------------------------------------------------------------------------
 	void setBool(const std::string &name, bool value) const
 	{
-		glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+		glUniform1i(getUniformLocation(name), (int)value);
 	}
 	// ------------------------------------------------------------------------
 	void setInt(const std::string &name, int value) const
 	{
-		glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+		glUniform1i(getUniformLocation(name), value);
 	}
 	// ------------------------------------------------------------------------
 	void setFloat(const std::string &name, float value) const
 	{
-		glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+		glUniform1f(getUniformLocation(name), value);
 	}
 	// ------------------------------------------------------------------------
 	void setVec2(const std::string &name, const glm::vec2 &value) const
 	{
-		glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		glUniform2fv(getUniformLocation(name), 1, &value[0]);
 	}
 	void setVec2(const std::string &name, float x, float y) const
 	{
-		glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+		glUniform2f(getUniformLocation(name), x, y);
 	}
 	// ------------------------------------------------------------------------
 	void setVec3(const std::string &name, const glm::vec3 &value) const
 	{
-		glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		glUniform3fv(getUniformLocation(name), 1, &value[0]);
 	}
 	void setVec3(const std::string &name, float x, float y, float z) const
 	{
-		glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+		glUniform3f(getUniformLocation(name), x, y, z);
 	}
 	// ------------------------------------------------------------------------
 	void setVec4(const std::string &name, const glm::vec4 &value) const
 	{
-		glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		glUniform4fv(getUniformLocation(name), 1, &value[0]);
 	}
 	void setVec4(const std::string &name, float x, float y, float z, float w)
 	{
-		glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+		glUniform4f(getUniformLocation(name), x, y, z, w);
 	}
 	// ------------------------------------------------------------------------
 	void setMat2(const std::string &name, const glm::mat2 &mat) const
 	{
-		glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		glUniformMatrix2fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 	}
 	// ------------------------------------------------------------------------
 	void setMat3(const std::string &name, const glm::mat3 &mat) const
 	{
-		glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 	}
 	// ------------------------------------------------------------------------
 	void setMat4(const std::string &name, const glm::mat4 &mat) const
 	{
-		glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
+	}
+	// hot reload, driven by GameProgramming::Shader::ShaderWatcher. The rebuilt program only replaces ID once
+	// it has linked; uniform values carry over, uniform handles do not.
+	// ------------------------------------------------------------------------
+	const std::vector<std::string> &sourceFiles() const
+	{
+		return sourcePaths;
+	}
+	void beginReload(const std::vector<std::string> &sources)
+	{
+		// a newer edit supersedes a rebuild still in flight
+		discardShaders(reloadProgram, reloadShaders);
+		glDeleteProgram(reloadProgram);
+
+		reloadProgram = glCreateProgram();
+		using GameProgramming::Shader::ProgramBinaryCache;
+		reloadCacheKey = sources.size() > 2 ? ProgramBinaryCache::key({sources[0], sources[1], sources[2]})
+		                                    : ProgramBinaryCache::key({sources[0], sources[1]});
+		submitCompileAndLink(reloadProgram, reloadShaders, sources[0], sources[1], sources.size() > 2 ? &sources[2] : nullptr);
+	}
+	// false while the driver is still linking
+	bool pollReload()
+	{
+		if (reloadProgram == 0)
+			return true;
+		if (GameProgramming::GL::extensions().KHR_parallel_shader_compile)
+		{
+			GLint completed;
+			glGetProgramiv(reloadProgram, GL_COMPLETION_STATUS_KHR, &completed);
+			if (!completed)
+				return false;
+		}
+		if (!linkShaders(reloadProgram, reloadShaders))
+		{
+			std::cout << "ERROR::SHADER::RELOAD_FAILED keeping the previous program of " << sourcePaths[1] << std::endl;
+			glDeleteProgram(std::exchange(reloadProgram, 0));
+			return true;
+		}
+		finishLink();
+		GameProgramming::Shader::UniformTable reloaded{reloadProgram};
+		GameProgramming::Shader::copyUniformValues(ID, uniforms, reloadProgram, reloaded);
+		GameProgramming::Shader::bindConstantBlocks(reloadProgram);
+		GameProgramming::Shader::ProgramBinaryCache::store(reloadProgram, reloadCacheKey);
+		glDeleteProgram(ID);
+		ID = std::exchange(reloadProgram, 0);
+		uniforms = std::move(reloaded);
+		std::cout << "SHADER::RELOADED " << sourcePaths[1] << std::endl;
+		return true;
 	}
 
 private:
+	struct PendingShader
+	{
+		unsigned int id;
+		const char *type;
+	};
+	mutable std::vector<PendingShader> pendingShaders; // compiled and linked, status not asked for yet
+	u64 pendingCacheKey = 0;
+	mutable GameProgramming::Shader::UniformTable uniforms;
+	std::vector<std::string> sourcePaths; // vertex, fragment[, geometry]
+	unsigned int reloadProgram = 0;       // rebuilt program waiting to replace ID
+	std::vector<PendingShader> reloadShaders;
+	u64 reloadCacheKey = 0;
+
+	// compile and link are only submitted: asking for their status right away would make the driver finish this
+	// program before the caller gets to submit the next one. finishLink() asks on first use instead.
+	// ------------------------------------------------------------------------
+	static void submitCompileAndLink(unsigned int program, std::vector<PendingShader> &shaders, const std::string &vertexCode,
+	                                 const std::string &fragmentCode, const std::string *geometryCode)
+	{
+		const char* vShaderCode = vertexCode.c_str();
+		const char * fShaderCode = fragmentCode.c_str();
+		// 2. compile shaders
+		unsigned int vertex, fragment;
+		// vertex shader
+		vertex = glCreateShader(GL_VERTEX_SHADER);
+		glShaderSource(vertex, 1, &vShaderCode, NULL);
+		glCompileShader(vertex);
+		shaders.push_back({vertex, "VERTEX"});
+		// fragment Shader
+		fragment = glCreateShader(GL_FRAGMENT_SHADER);
+		glShaderSource(fragment, 1, &fShaderCode, NULL);
+		glCompileShader(fragment);
+		shaders.push_back({fragment, "FRAGMENT"});
+		// if geometry shader is given, compile geometry shader
+		if (geometryCode != nullptr)
+		{
+			const char * gShaderCode = geometryCode->c_str();
+			unsigned int geometry = glCreateShader(GL_GEOMETRY_SHADER);
+			glShaderSource(geometry, 1, &gShaderCode, NULL);
+			glCompileShader(geometry);
+			shaders.push_back({geometry, "GEOMETRY"});
+		}
+		for (const PendingShader &shader : shaders)
+			glAttachShader(program, shader.id);
+		GameProgramming::Shader::ProgramBinaryCache::prepare(program);
+		glLinkProgram(program);
+	}
+	// waits for a submitted link, reports errors and stores the binary in the program cache
+	// ------------------------------------------------------------------------
+	void finishLink() const
+	{
+		if (pendingShaders.empty())
+			return;
+		if (linkShaders(ID, pendingShaders))
+		{
+			GameProgramming::Shader::ProgramBinaryCache::store(ID, pendingCacheKey);
+			programLinked();
+		}
+	}
+	static bool linkShaders(unsigned int program, std::vector<PendingShader> &shaders)
+	{
+		GLint linked;
+		glGetProgramiv(program, GL_LINK_STATUS, &linked);
+		if (!linked)
+		{
+			for (const PendingShader &shader : shaders)
+				checkCompileErrors(shader.id, shader.type);
+			checkCompileErrors(program, "PROGRAM");
+		}
+		discardShaders(program, shaders);
+		return linked;
+	}
+	static void discardShaders(unsigned int program, std::vector<PendingShader> &shaders)
+	{
+		// delete the shaders as they're linked into our program now and no longer necessery
+		for (const PendingShader &shader : shaders)
+		{
+			glDetachShader(program, shader.id);
+			glDeleteShader(shader.id);
+		}
+		shaders.clear();
+	}
+	void programLinked() const
+	{
+		// look every active uniform up once, the setters below only search this table
+		uniforms.reflect(ID);
+		// FrameConstants / PassConstants blocks read from the shared uniform buffer bindings
+		GameProgramming::Shader::bindConstantBlocks(ID);
+	}
+
 	// utility function for checking shader compilation/linking errors.
 	// ------------------------------------------------------------------------
-	void checkCompileErrors(GLuint shader, std::string type)
+	static void checkCompileErrors(GLuint shader, std::string type)
 	{
 		GLint success;
 		GLchar infoLog[1024];
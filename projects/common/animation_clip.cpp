@@ -0,0 +1,51 @@
+#include "animation_clip.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace GameProgramming::Animation
+{
+
+void blendPose(const PoseSample &sample, u32 boneCount, glm::quat *rotations) noexcept
+{
+    for (u32 bone = 0; bone < boneCount; ++bone)
+    {
+        rotations[bone] = glm::slerp(sample.from[bone], sample.to[bone], sample.t);
+    }
+}
+
+void AnimationClip::addKey(float time, const glm::quat *rotations)
+{
+    if (m_times.empty() ? time != 0.0f : time <= m_times.back())
+        throw std::invalid_argument{"A clip's keys start at time 0 and ascend"};
+    if (loops())
+        throw std::invalid_argument{"A looping clip takes no more keys"};
+
+    m_times.push_back(time);
+    m_rotations.insert(m_rotations.end(), rotations, rotations + m_boneCount);
+}
+
+void AnimationClip::setLoop(u32 key, float duration)
+{
+    if (key >= keyCount() || duration <= m_times.back())
+        throw std::invalid_argument{"A clip loops back to one of its keys after its last key"};
+
+    m_loopKey = key;
+    m_loopDuration = duration;
+}
+
+PoseSample AnimationClip::sample(float time) const noexcept
+{
+    // the key at or before `time`
+    const u32 last = keyCount() - 1;
+    const u32 index = static_cast<u32>(std::upper_bound(m_times.begin() + 1, m_times.end(), time) - m_times.begin()) - 1;
+    if (index < last)
+        return {key(index), key(index + 1), (time - m_times[index]) / (m_times[index + 1] - m_times[index])};
+    if (loops())
+        return {key(last), key(m_loopKey), std::min(1.0f, (time - m_times[last]) / (m_loopDuration - m_times[last]))};
+    return {key(last), key(last), 0.0f};
+}
+
+} // namespace GameProgramming::Animation
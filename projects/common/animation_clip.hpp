@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glm/ext/quaternion_float.hpp>
+
+#include "type.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace GameProgramming::Animation
+{
+
+// A pose between two key poses: rotation b is slerp(from[b], to[b], t). Both point into the clips, so taking a
+// sample copies nothing.
+struct PoseSample
+{
+    const glm::quat *from;
+    const glm::quat *to;
+    float t;
+};
+
+// Blends `sample` into `boneCount` rotations with glm::slerp, as Human::MixPose does.
+void blendPose(const PoseSample &sample, u32 boneCount, glm::quat *rotations) noexcept;
+
+// Key poses at ascending times, every key holding one rotation per bone, stored key after key in one array.
+// A clip plays from its first key (at time 0) to its last and then holds it, unless it loops: then it blends
+// on from the last key back to the loop key, arrives there at duration() and repeats [loopStart(), duration()).
+class AnimationClip
+{
+public:
+    explicit AnimationClip(u32 boneCount) noexcept : m_boneCount(boneCount) {}
+
+    // Appends a key of boneCount() `rotations`. The first key is at time 0, later ones after the previous key;
+    // throws std::invalid_argument otherwise.
+    void addKey(float time, const glm::quat *rotations);
+    // Loops back to `key`, reaching it `duration` seconds into the clip. Throws std::invalid_argument unless
+    // `key` exists and `duration` lies after the last key.
+    void setLoop(u32 key, float duration);
+
+    [[nodiscard]] u32 boneCount() const noexcept { return m_boneCount; }
+    [[nodiscard]] u32 keyCount() const noexcept { return static_cast<u32>(m_times.size()); }
+    [[nodiscard]] const glm::quat *key(u32 index) const noexcept { return &m_rotations[static_cast<std::size_t>(index) * m_boneCount]; }
+
+    [[nodiscard]] bool loops() const noexcept { return m_loopDuration > 0.0f; }
+    // the end of one pass: the loop's end for a looping clip, the last key otherwise
+    [[nodiscard]] float duration() const noexcept { return loops() ? m_loopDuration : m_times.back(); }
+    [[nodiscard]] float loopStart() const noexcept { return m_times[m_loopKey]; }
+    // the pose a pass ends in
+    [[nodiscard]] const glm::quat *endPose() const noexcept { return key(loops() ? m_loopKey : keyCount() - 1); }
+
+    // The keys around `time`, which lies in [0, duration()].
+    [[nodiscard]] PoseSample sample(float time) const noexcept;
+
+private:
+    u32 m_boneCount;
+    std::vector<float> m_times;
+    std::vector<glm::quat> m_rotations;
+    u32 m_loopKey = 0;
+    float m_loopDuration = 0.0f;
+};
+
+} // namespace GameProgramming::Animation
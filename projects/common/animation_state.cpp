@@ -0,0 +1,90 @@
+#include "animation_state.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace GameProgramming::Animation
+{
+
+u32 AnimationStateMachine::addClip(AnimationClip clip)
+{
+    if (clip.keyCount() == 0 || clip.boneCount() != m_boneCount)
+        throw std::invalid_argument{"A state machine's clips need keys for each of its bones"};
+
+    m_clips.push_back(std::move(clip));
+    return static_cast<u32>(m_clips.size() - 1);
+}
+
+u32 AnimationStateMachine::addState(const char *name, u32 clip)
+{
+    if (clip >= m_clips.size())
+        throw std::invalid_argument{"A state plays a clip of its state machine"};
+
+    m_states.push_back({name, clip});
+    return static_cast<u32>(m_states.size() - 1);
+}
+
+void AnimationStateMachine::setExit(u32 state, u32 loops, u32 next, float fadeDuration)
+{
+    // a fade always takes time, so advancing can never go round a cycle of exits without returning
+    if (state >= m_states.size() || next >= m_states.size() || loops == 0 || !(fadeDuration > 0.0f))
+        throw std::invalid_argument{"An exit leads between states of the state machine after at least one loop, with a fade"};
+
+    AnimationState &exiting = m_states[state];
+    exiting.exitLoops = loops;
+    exiting.next = next;
+    exiting.fadeDuration = fadeDuration;
+}
+
+AnimationPlayer::AnimationPlayer(const AnimationStateMachine &machine, u32 state, float time) noexcept
+    : m_machine(&machine), m_state(state), m_time(0.0f)
+{
+    advance(time);
+}
+
+PoseSample AnimationPlayer::advance(float deltaTime) noexcept
+{
+    m_time += deltaTime;
+    for (;;)
+    {
+        const AnimationClip &clip = m_machine->clip(m_machine->state(m_state).clip);
+        if (m_fadeFrom)
+        {
+            if (m_time < m_fadeDuration)
+                return {m_fadeFrom, clip.key(0), m_time / m_fadeDuration};
+            m_time -= m_fadeDuration;
+            m_fadeFrom = nullptr;
+            continue;
+        }
+
+        if (m_time < clip.duration())
+            return clip.sample(m_time);
+
+        // a pass is over
+        const AnimationState &state = m_machine->state(m_state);
+        const bool exits = state.exitLoops > 0 && (!clip.loops() || m_loops + 1 >= state.exitLoops);
+        if (exits)
+        {
+            m_time -= clip.duration();
+            m_fadeFrom = clip.endPose();
+            m_fadeDuration = state.fadeDuration;
+            m_state = state.next;
+            m_loops = 0;
+            continue;
+        }
+        if (!clip.loops())
+        {
+            m_time = clip.duration();
+            return clip.sample(m_time);
+        }
+        ++m_loops;
+        m_time -= clip.duration() - clip.loopStart();
+    }
+}
+
+void AnimationPlayer::update(float deltaTime, glm::quat *rotations) noexcept
+{
+    blendPose(advance(deltaTime), m_machine->boneCount(), rotations);
+}
+
+} // namespace GameProgramming::Animation
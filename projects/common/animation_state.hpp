@@ -0,0 +1,77 @@
+#pragma once
+
+#include <glm/ext/quaternion_float.hpp>
+
+#include "animation_clip.hpp"
+#include "type.hpp"
+
+#include <vector>
+
+namespace GameProgramming::Animation
+{
+
+// A state plays one clip. With an exit, after `exitLoops` passes of the clip (one, if the clip does not loop)
+// it cross-fades to `next` over `fadeDuration` seconds: from the pose the pass ended in to the first key of
+// the next clip, which starts playing once the fade is over.
+struct AnimationState
+{
+    const char *name;
+    u32 clip;
+    u32 exitLoops = 0; // 0: no exit, play forever
+    u32 next = 0;
+    float fadeDuration = 0.0f;
+};
+
+// Clips and the states playing them; shared, read only, by any number of AnimationPlayers.
+class AnimationStateMachine
+{
+public:
+    explicit AnimationStateMachine(u32 boneCount) noexcept : m_boneCount(boneCount) {}
+
+    // Throws std::invalid_argument for a clip without keys or of another bone count.
+    u32 addClip(AnimationClip clip);
+    // Throws std::invalid_argument for a clip that was not added.
+    u32 addState(const char *name, u32 clip);
+    // Throws std::invalid_argument for a state that was not added, no loops or no fade.
+    void setExit(u32 state, u32 loops, u32 next, float fadeDuration);
+
+    [[nodiscard]] u32 boneCount() const noexcept { return m_boneCount; }
+    [[nodiscard]] const AnimationClip &clip(u32 index) const noexcept { return m_clips[index]; }
+    [[nodiscard]] const AnimationState &state(u32 index) const noexcept { return m_states[index]; }
+
+private:
+    u32 m_boneCount;
+    std::vector<AnimationClip> m_clips;
+    std::vector<AnimationState> m_states;
+};
+
+// One character's place in an AnimationStateMachine: a few words, and advancing it allocates nothing, so
+// every character of a crowd can run its own. Cross-fades start where a pass of a clip ends, in one of the
+// clip's keys, so the pose faded from is a pointer into the clip rather than a copy.
+class AnimationPlayer
+{
+public:
+    // Starts `time` seconds into `state`, taking whatever exits lie on the way.
+    AnimationPlayer(const AnimationStateMachine &machine, u32 state, float time = 0.0f) noexcept;
+
+    // Moves `deltaTime` seconds on and returns the pose there.
+    PoseSample advance(float deltaTime) noexcept;
+    // advance() blended into machine().boneCount() `rotations`.
+    void update(float deltaTime, glm::quat *rotations) noexcept;
+
+    [[nodiscard]] const AnimationStateMachine &machine() const noexcept { return *m_machine; }
+    [[nodiscard]] u32 state() const noexcept { return m_state; }
+    // while fading, state() is the state faded to
+    [[nodiscard]] bool fading() const noexcept { return m_fadeFrom != nullptr; }
+    [[nodiscard]] u32 loops() const noexcept { return m_loops; }
+
+private:
+    const AnimationStateMachine *m_machine;
+    u32 m_state;
+    u32 m_loops = 0;
+    float m_time;                          // into the clip, or into the fade
+    const glm::quat *m_fadeFrom = nullptr; // set while fading
+    float m_fadeDuration = 0.0f;
+};
+
+} // namespace GameProgramming::Animation
@@ -0,0 +1,49 @@
+#include "baked_animation.hpp"
+
+#include <glm/ext/quaternion_float.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+namespace GameProgramming::Animation
+{
+
+BakedAnimation::BakedAnimation(const Skeleton &skeleton, const glm::mat4 *inverseBind, float framesPerSecond)
+    : m_skeleton(&skeleton), m_inverseBind(inverseBind, inverseBind + skeleton.boneCount()), m_framesPerSecond(framesPerSecond)
+{
+    if (!(framesPerSecond > 0.0f))
+        throw std::invalid_argument{"An animation is baked at a positive frame rate"};
+}
+
+u32 BakedAnimation::addClip(AnimationPlayer player, float period)
+{
+    if (player.machine().boneCount() != boneCount() || !(period > 0.0f))
+        throw std::invalid_argument{"A baked clip is a positive period of a player animating the skeleton's bones"};
+
+    // whole frames, so the clip's frame rate stays the texture's; the period stretches by under half a frame
+    const u32 frameCount = std::max(1u, static_cast<u32>(std::lround(period * m_framesPerSecond)));
+    const float frameTime = period / frameCount;
+    m_clips.push_back({this->frameCount(), frameCount});
+
+    const u32 bones = boneCount();
+    std::vector<glm::quat> rotations(bones);
+    std::vector<glm::mat4> palette(bones);
+    m_texels.reserve(m_texels.size() + static_cast<std::size_t>(frameCount) * width());
+    for (u32 frame = 0; frame < frameCount; ++frame)
+    {
+        player.update(frame == 0 ? 0.0f : frameTime, rotations.data());
+        m_skeleton->computeWorld(glm::mat4(1.0f), rotations.data(), palette.data());
+        m_skeleton->computeSkinning(palette.data(), m_inverseBind.data(), palette.data());
+        for (const glm::mat4 &matrix : palette)
+        {
+            // rows, since glm stores columns
+            for (int row = 0; row < 3; ++row)
+                m_texels.emplace_back(matrix[0][row], matrix[1][row], matrix[2][row], matrix[3][row]);
+        }
+    }
+    return static_cast<u32>(m_clips.size() - 1);
+}
+
+} // namespace GameProgramming::Animation
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/ext/vector_float4.hpp>
+
+#include "animation_state.hpp"
+#include "skeleton.hpp"
+#include "type.hpp"
+
+#include <vector>
+
+namespace GameProgramming::Animation
+{
+
+// Skinning palettes of whole animation cycles sampled at a fixed rate ahead of time, laid out as the rows of a
+// float texture so a vertex shader can look up any character's palette from nothing but a clip and a time.
+//
+// A row is one frame: boneCount() matrices, each stored as its top three rows (the bottom one of a skinning
+// matrix is always 0 0 0 1), three RGBA texels per bone. A clip is a run of consecutive rows that loops: its
+// last frame is followed by its first.
+class BakedAnimation
+{
+public:
+    struct Clip
+    {
+        u32 firstFrame;
+        u32 frameCount;
+    };
+
+    // Palettes for meshes bound with `inverseBind`, one per bone of `skeleton`, sampled `framesPerSecond`.
+    BakedAnimation(const Skeleton &skeleton, const glm::mat4 *inverseBind, float framesPerSecond);
+
+    // Bakes `period` seconds of `player` from where it stands and returns the clip's index. `period` should be
+    // what it takes the player to come back to the pose it started in, for the clip to loop seamlessly.
+    // Throws std::invalid_argument unless the player animates the skeleton's bones and period is positive.
+    u32 addClip(AnimationPlayer player, float period);
+
+    [[nodiscard]] u32 boneCount() const noexcept { return m_skeleton->boneCount(); }
+    [[nodiscard]] float framesPerSecond() const noexcept { return m_framesPerSecond; }
+    [[nodiscard]] u32 clipCount() const noexcept { return static_cast<u32>(m_clips.size()); }
+    [[nodiscard]] const Clip &clip(u32 index) const noexcept { return m_clips[index]; }
+
+    // the texture: width() texels by frameCount() rows
+    [[nodiscard]] u32 width() const noexcept { return 3 * boneCount(); }
+    [[nodiscard]] u32 frameCount() const noexcept { return static_cast<u32>(m_texels.size() / width()); }
+    [[nodiscard]] const glm::vec4 *texels() const noexcept { return m_texels.data(); }
+
+private:
+    const Skeleton *m_skeleton;
+    std::vector<glm::mat4> m_inverseBind;
+    float m_framesPerSecond;
+    std::vector<Clip> m_clips;
+    std::vector<glm::vec4> m_texels;
+};
+
+} // namespace GameProgramming::Animation
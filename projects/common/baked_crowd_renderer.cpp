@@ -0,0 +1,109 @@
+#include "baked_crowd_renderer.hpp"
+
+#include "skinned_renderer.hpp"
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+namespace GameProgramming::Animation
+{
+
+namespace
+{
+constexpr GLuint PlacementAttribute = 5; // position and time offset
+constexpr GLuint ClipAttribute = 6;
+} // namespace
+
+BakedCrowdRenderer::BakedCrowdRenderer(const SkinnedMesh &mesh, const BakedAnimation &baked, const std::vector<BakedInstance> &instances)
+    : m_indexCount(static_cast<GLsizei>(mesh.indices.size())), m_instanceCount(static_cast<u32>(instances.size())),
+      m_boneCount(baked.boneCount()), m_framesPerSecond(baked.framesPerSecond())
+{
+    if (baked.clipCount() > MaxClips)
+        throw std::invalid_argument{"A baked crowd plays at most BakedCrowdRenderer::MaxClips clips"};
+    for (const BakedInstance &instance : instances)
+    {
+        if (instance.clip >= baked.clipCount())
+            throw std::invalid_argument{"A baked crowd's instances play clips of its baked animation"};
+    }
+    for (u32 clip = 0; clip < baked.clipCount(); ++clip)
+    {
+        m_clips.push_back(baked.clip(clip));
+    }
+
+    glGenVertexArrays(1, &m_vao);
+    glBindVertexArray(m_vao);
+
+    glGenBuffers(1, &m_vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mesh.vertices.size() * sizeof(SkinnedVertex)), mesh.vertices.data(),
+                 GL_STATIC_DRAW);
+    pointSkinnedVertexAttributes();
+    glGenBuffers(1, &m_indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(mesh.indices.size() * sizeof(u16)), mesh.indices.data(),
+                 GL_STATIC_DRAW);
+
+    glGenBuffers(1, &m_instanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(instances.size() * sizeof(BakedInstance)), instances.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(PlacementAttribute, 4, GL_FLOAT, GL_FALSE, sizeof(BakedInstance),
+                          reinterpret_cast<void *>(offsetof(BakedInstance, position)));
+    glVertexAttribIPointer(ClipAttribute, 1, GL_UNSIGNED_INT, sizeof(BakedInstance), reinterpret_cast<void *>(offsetof(BakedInstance, clip)));
+    for (GLuint attribute : {PlacementAttribute, ClipAttribute})
+    {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+    glBindVertexArray(0);
+
+    // every texel is fetched exactly, frames are blended in the shader
+    glGenTextures(1, &m_paletteTexture);
+    glBindTexture(GL_TEXTURE_2D, m_paletteTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, static_cast<GLsizei>(baked.width()), static_cast<GLsizei>(baked.frameCount()), 0, GL_RGBA,
+                 GL_FLOAT, baked.texels());
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+BakedCrowdRenderer::~BakedCrowdRenderer()
+{
+    glDeleteTextures(1, &m_paletteTexture);
+    glDeleteBuffers(1, &m_instanceBuffer);
+    glDeleteBuffers(1, &m_indexBuffer);
+    glDeleteBuffers(1, &m_vertexBuffer);
+    glDeleteVertexArrays(1, &m_vao);
+}
+
+void BakedCrowdRenderer::setUniforms(const Shader::UniformTable &uniforms) const
+{
+    Shader::setUniform(uniforms.uniform<int>("bakedPalettes"), static_cast<int>(PaletteUnit));
+    Shader::setUniform(uniforms.uniform<int>("boneCount"), static_cast<int>(m_boneCount));
+    Shader::setUniform(uniforms.uniform<float>("framesPerSecond"), m_framesPerSecond);
+
+    // the whole array at once, from the location of its first element
+    std::array<GLint, 2 * MaxClips> clipFrames{};
+    for (std::size_t clip = 0; clip < m_clips.size(); ++clip)
+    {
+        clipFrames[2 * clip] = static_cast<GLint>(m_clips[clip].firstFrame);
+        clipFrames[2 * clip + 1] = static_cast<GLint>(m_clips[clip].frameCount);
+    }
+    glUniform2iv(uniforms.location("clipFrames"), static_cast<GLsizei>(m_clips.size()), clipFrames.data());
+}
+
+void BakedCrowdRenderer::draw(float time, GLint timeLocation)
+{
+    glUniform1f(timeLocation, time);
+    glActiveTexture(GL_TEXTURE0 + PaletteUnit);
+    glBindTexture(GL_TEXTURE_2D, m_paletteTexture);
+
+    glBindVertexArray(m_vao);
+    if (m_instanceCount > 0)
+        glDrawElementsInstanced(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_SHORT, nullptr, static_cast<GLsizei>(m_instanceCount));
+    glBindVertexArray(0);
+}
+
+} // namespace GameProgramming::Animation
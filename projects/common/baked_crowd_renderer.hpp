@@ -0,0 +1,70 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/ext/vector_float3.hpp>
+
+#include "baked_animation.hpp"
+#include "skinned_mesh.hpp"
+#include "type.hpp"
+#include "uniform_table.hpp"
+
+#include <vector>
+
+namespace GameProgramming::Animation
+{
+
+// One character of a baked crowd: where it stands, the baked clip it plays and how far into it it started.
+struct BakedInstance
+{
+    glm::vec3 position;
+    float timeOffset;
+    u32 clip;
+};
+static_assert(sizeof(BakedInstance) == 20);
+
+// Draws a crowd of one SkinnedMesh playing BakedAnimation clips with a single glDrawElementsInstanced, and no
+// CPU work per character after construction: the instances are uploaded once, and each vertex finds its
+// palette in the baked texture from its instance's clip and time offset plus the shared `time` uniform,
+// blending the two frames around it.
+//
+// The program reads attributes 0..4 as for SkinnedRenderer, per instance 5 (position and time offset, vec4)
+// and 6 (clip, uint), and the baked palettes as `sampler2D bakedPalettes` on texture unit PaletteUnit; see
+// setUniforms() for the rest.
+class BakedCrowdRenderer
+{
+public:
+    static constexpr GLuint PaletteUnit = 0;
+    static constexpr u32 MaxClips = 8; // the length of the program's `clipFrames` array
+
+    // Throws std::invalid_argument if `baked` holds more than MaxClips clips or an instance plays a clip it
+    // does not hold.
+    BakedCrowdRenderer(const SkinnedMesh &mesh, const BakedAnimation &baked, const std::vector<BakedInstance> &instances);
+    ~BakedCrowdRenderer();
+    BakedCrowdRenderer(const BakedCrowdRenderer &) = delete;
+    BakedCrowdRenderer &operator=(const BakedCrowdRenderer &) = delete;
+    BakedCrowdRenderer(BakedCrowdRenderer &&) = delete;
+    BakedCrowdRenderer &operator=(BakedCrowdRenderer &&) = delete;
+
+    [[nodiscard]] u32 instanceCount() const noexcept { return m_instanceCount; }
+
+    // Sets the uniforms that stay: `bakedPalettes`, `boneCount`, `framesPerSecond` and `clipFrames[i]` (ivec2:
+    // first frame, frame count), on the program `uniforms` was reflected from, which must be in use.
+    void setUniforms(const Shader::UniformTable &uniforms) const;
+    // Draws every instance at `time` seconds; `timeLocation` is the program's float uniform `time`.
+    void draw(float time, GLint timeLocation);
+
+private:
+    GLuint m_vao = 0;
+    GLuint m_vertexBuffer = 0;
+    GLuint m_indexBuffer = 0;
+    GLuint m_instanceBuffer = 0;
+    GLuint m_paletteTexture = 0;
+    GLsizei m_indexCount;
+    u32 m_instanceCount;
+    u32 m_boneCount;
+    float m_framesPerSecond;
+    std::vector<BakedAnimation::Clip> m_clips;
+};
+
+} // namespace GameProgramming::Animation
@@ -0,0 +1,51 @@
+#include "billboard_renderer.hpp"
+
+#include "particle_kernels.hpp"
+
+#include <cstddef>
+
+namespace GameProgramming::Particle
+{
+
+BillboardRenderer::BillboardRenderer(GLuint instanceBuffer) : m_instanceBuffer(instanceBuffer)
+{
+    glGenVertexArrays(1, &m_vao);
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    pointAttributes(0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribDivisor(0, 1);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glBindVertexArray(0);
+}
+
+BillboardRenderer::~BillboardRenderer()
+{
+    glDeleteVertexArrays(1, &m_vao);
+}
+
+void BillboardRenderer::draw(GLintptr offset, GLsizei count)
+{
+    if (count <= 0)
+        return;
+
+    glBindVertexArray(m_vao);
+    if (offset != m_offset)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+        pointAttributes(offset);
+    }
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count);
+    glBindVertexArray(0);
+}
+
+void BillboardRenderer::pointAttributes(GLintptr offset)
+{
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex),
+                          reinterpret_cast<void *>(offset + offsetof(ParticleVertex, position)));
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ParticleVertex), reinterpret_cast<void *>(offset + offsetof(ParticleVertex, color)));
+    m_offset = offset;
+}
+
+} // namespace GameProgramming::Particle
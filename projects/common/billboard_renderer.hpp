@@ -0,0 +1,37 @@
+#pragma once
+
+#include <glad/glad.h>
+
+namespace GameProgramming::Particle
+{
+
+// Draws particles as camera-facing quads, one instance each, with position and color read per instance straight
+// from the buffer the simulation wrote (ParticleVertex layout: attribute 0 = vec3 position, attribute 1 = RGBA8
+// color whose alpha is 1 - age / lifetime). The quad corners come from gl_VertexID, so there is no per-vertex
+// buffer and a particle costs 4 vertices and a screen area set by the shader's size uniforms, not by the
+// implementation's point size range.
+//
+// The billboard vertex shader builds the corner as vec2(gl_VertexID & 1, gl_VertexID >> 1) of a triangle strip.
+class BillboardRenderer
+{
+public:
+    explicit BillboardRenderer(GLuint instanceBuffer);
+    ~BillboardRenderer();
+    BillboardRenderer(const BillboardRenderer &) = delete;
+    BillboardRenderer &operator=(const BillboardRenderer &) = delete;
+    BillboardRenderer(BillboardRenderer &&) = delete;
+    BillboardRenderer &operator=(BillboardRenderer &&) = delete;
+
+    // Draws `count` particles starting `offset` bytes into the instance buffer with the program in use.
+    void draw(GLintptr offset, GLsizei count);
+
+private:
+    // GL 3.3 has no base instance: the attributes are pointed at `offset` instead
+    void pointAttributes(GLintptr offset);
+
+    GLuint m_vao = 0;
+    GLuint m_instanceBuffer;
+    GLintptr m_offset = 0;
+};
+
+} // namespace GameProgramming::Particle
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/ext/vector_float3.hpp>
+
+namespace GameProgramming::Animation
+{
+
+// One drawn bone: the cube's model matrix (joint frame times the bone's shape scale) and its color.
+struct BoneInstance
+{
+    glm::mat4 model;
+    glm::vec3 color;
+    float padding;
+};
+static_assert(sizeof(BoneInstance) == 80);
+
+} // namespace GameProgramming::Animation
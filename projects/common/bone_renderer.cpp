@@ -0,0 +1,78 @@
+#include "bone_renderer.hpp"
+
+#include <glm/ext/vector_float4.hpp>
+
+#include <cstddef>
+
+namespace GameProgramming::Animation
+{
+
+namespace
+{
+constexpr GLuint ModelAttribute = 2; // four consecutive locations, one per column
+constexpr GLuint ColorAttribute = 6;
+} // namespace
+
+BoneRenderer::BoneRenderer(GLuint meshBuffer, GLsizei meshVertexCount, u32 capacity, u32 regionCount)
+    : m_meshVertexCount(meshVertexCount), m_capacity(capacity),
+      m_instances(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity) * sizeof(BoneInstance), regionCount)
+{
+    glGenVertexArrays(1, &m_vao);
+    glBindVertexArray(m_vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, meshBuffer);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), reinterpret_cast<void *>(0));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), reinterpret_cast<void *>(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_instances.buffer());
+    pointInstanceAttributes(0);
+    for (GLuint column = 0; column < 4; ++column)
+    {
+        glEnableVertexAttribArray(ModelAttribute + column);
+        glVertexAttribDivisor(ModelAttribute + column, 1);
+    }
+    glEnableVertexAttribArray(ColorAttribute);
+    glVertexAttribDivisor(ColorAttribute, 1);
+    glBindVertexArray(0);
+}
+
+BoneRenderer::~BoneRenderer()
+{
+    glDeleteVertexArrays(1, &m_vao);
+}
+
+BoneInstance *BoneRenderer::beginFrame()
+{
+    return static_cast<BoneInstance *>(m_instances.beginWrite());
+}
+
+void BoneRenderer::draw(u32 count)
+{
+    const GLintptr offset = m_instances.endWrite();
+    glBindVertexArray(m_vao);
+    if (offset != m_offset)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, m_instances.buffer());
+        pointInstanceAttributes(offset);
+    }
+    if (count > 0)
+        glDrawArraysInstanced(GL_TRIANGLES, 0, m_meshVertexCount, static_cast<GLsizei>(count < m_capacity ? count : m_capacity));
+    glBindVertexArray(0);
+    m_instances.fence();
+}
+
+void BoneRenderer::pointInstanceAttributes(GLintptr offset)
+{
+    for (GLuint column = 0; column < 4; ++column)
+    {
+        const GLintptr columnOffset = offset + offsetof(BoneInstance, model) + column * sizeof(glm::vec4);
+        glVertexAttribPointer(ModelAttribute + column, 4, GL_FLOAT, GL_FALSE, sizeof(BoneInstance), reinterpret_cast<void *>(columnOffset));
+    }
+    glVertexAttribPointer(ColorAttribute, 3, GL_FLOAT, GL_FALSE, sizeof(BoneInstance),
+                          reinterpret_cast<void *>(offset + offsetof(BoneInstance, color)));
+    m_offset = offset;
+}
+
+} // namespace GameProgramming::Animation
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "bone_instance.hpp"
+#include "stream_buffer.hpp"
+#include "type.hpp"
+
+namespace GameProgramming::Animation
+{
+
+// Draws every bone of every character with a single glDrawArraysInstanced of one shared mesh. The mesh
+// buffer holds interleaved vec3 position, vec3 normal (attributes 0 and 1); the instances stream per frame
+// through a StreamBuffer and arrive as attribute 2..5 (model matrix columns) and 6 (color).
+//
+// Per frame: fill beginFrame() with up to `capacity` instances, then draw(count) with the program in use.
+// beginFrame() hands out one of `regionCount` regions round robin, so worker threads may fill one frame while
+// the GPU still reads the previous ones; only the GL calls need the render thread.
+class BoneRenderer
+{
+public:
+    BoneRenderer(GLuint meshBuffer, GLsizei meshVertexCount, u32 capacity, u32 regionCount = GL::StreamBuffer::DefaultRegionCount);
+    ~BoneRenderer();
+    BoneRenderer(const BoneRenderer &) = delete;
+    BoneRenderer &operator=(const BoneRenderer &) = delete;
+    BoneRenderer(BoneRenderer &&) = delete;
+    BoneRenderer &operator=(BoneRenderer &&) = delete;
+
+    [[nodiscard]] u32 capacity() const noexcept { return m_capacity; }
+
+    // Write-only, see StreamBuffer::beginWrite().
+    [[nodiscard]] BoneInstance *beginFrame();
+    // Draws the first `count` instances written since beginFrame().
+    void draw(u32 count);
+
+private:
+    // GL 3.3 has no base instance: the instance attributes are pointed at `offset` instead
+    void pointInstanceAttributes(GLintptr offset);
+
+    GLuint m_vao = 0;
+    GLsizei m_meshVertexCount;
+    u32 m_capacity;
+    GL::StreamBuffer m_instances;
+    GLintptr m_offset = -1;
+};
+
+} // namespace GameProgramming::Animation
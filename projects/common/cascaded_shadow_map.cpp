@@ -0,0 +1,217 @@
+#include "cascaded_shadow_map.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "constant_buffers.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace GameProgramming::GL
+{
+
+namespace
+{
+
+void validate(u32 cascadeCount, GLsizei resolution)
+{
+    if (cascadeCount == 0 || cascadeCount > MaxShadowCascades)
+        throw std::invalid_argument{"A cascaded shadow map has 1 to MaxShadowCascades cascades"};
+
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    if (resolution <= 0 || resolution > maxSize)
+        throw std::invalid_argument{"Shadow map resolution exceeds GL_MAX_TEXTURE_SIZE"};
+}
+
+} // namespace
+
+CascadedShadowMap::CascadedShadowMap(u32 cascadeCount, GLsizei resolution)
+    : m_cascadeCount(cascadeCount), m_resolution(resolution)
+{
+    validate(cascadeCount, resolution);
+    create();
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(CascadeConstants), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+CascadedShadowMap::~CascadedShadowMap()
+{
+    destroy();
+    glDeleteBuffers(1, &m_buffer);
+}
+
+void CascadedShadowMap::configure(u32 cascadeCount, GLsizei resolution)
+{
+    if (cascadeCount == m_cascadeCount && resolution == m_resolution)
+        return;
+
+    validate(cascadeCount, resolution);
+    m_cascadeCount = cascadeCount;
+    m_resolution = resolution;
+    destroy();
+    create();
+}
+
+void CascadedShadowMap::update(const glm::mat4 &view, float fovY, float aspect, float nearDepth, float shadowDistance,
+                               const glm::vec3 &lightDirection)
+{
+    const glm::mat4 cameraToWorld = glm::inverse(view);
+    const glm::vec3 up = std::abs(lightDirection.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    m_lightView = glm::lookAt(glm::vec3(0.0f), lightDirection, up);
+
+    // a frustum corner at view depth d lies d * sqrt(k) off the view axis
+    const float tanY = std::tan(0.5f * fovY);
+    const float tanX = tanY * aspect;
+    const float k = tanX * tanX + tanY * tanY;
+
+    m_constants.count = static_cast<i32>(m_cascadeCount);
+    float splitNear = nearDepth;
+    for (u32 i = 0; i < m_cascadeCount; ++i)
+    {
+        const float t = static_cast<float>(i + 1) / m_cascadeCount;
+        const float uniform = nearDepth + (shadowDistance - nearDepth) * t;
+        const float logarithmic = nearDepth * std::pow(shadowDistance / nearDepth, t);
+        const float splitFar = uniform + (logarithmic - uniform) * m_splitLambda;
+
+        // The smallest sphere around the slice's corners is centred on the view axis, where the near and far
+        // corners are equally far, or at the far plane once that point lies beyond it.
+        float depth = 0.5f * (splitNear + splitFar) * (1.0f + k);
+        float radius;
+        if (depth < splitFar)
+        {
+            radius = std::sqrt((splitFar - depth) * (splitFar - depth) + splitFar * splitFar * k);
+        }
+        else
+        {
+            depth = splitFar;
+            radius = splitFar * std::sqrt(k);
+        }
+        // rounded up, so float noise in the above never changes the texel size
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        const glm::vec3 center = glm::vec3(m_lightView * cameraToWorld * glm::vec4(0.0f, 0.0f, -depth, 1.0f));
+        const float texel = 2.0f * radius / static_cast<float>(m_resolution);
+        const float x = std::floor(center.x / texel) * texel;
+        const float y = std::floor(center.y / texel) * texel;
+        // depth too, so a camera moving less than a texel leaves the matrix, and the static cache, as it was
+        const float z = std::floor(center.z / texel) * texel;
+
+        m_projections[i] = glm::ortho(x - radius, x + radius, y - radius, y + radius, -z - radius, -z + radius);
+        m_constants.matrices[i] = m_projections[i] * m_lightView;
+        m_constants.splits[i] = glm::vec4(splitFar, texel, 0.5f / radius, 0.0f);
+        splitNear = splitFar;
+    }
+}
+
+void CascadedShadowMap::upload() const noexcept
+{
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(CascadeConstants), &m_constants, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Shader::ShadowCascadesBinding, m_buffer);
+}
+
+void CascadedShadowMap::beginCascade(u32 cascade) const noexcept
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_texture, 0, static_cast<GLint>(cascade));
+    glViewport(0, 0, m_resolution, m_resolution);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_DEPTH_CLAMP);
+}
+
+bool CascadedShadowMap::beginStatic(u32 cascade) noexcept
+{
+    if (m_staticValid[cascade] && m_staticMatrices[cascade] == matrix(cascade))
+        return false;
+
+    m_staticValid[cascade] = true;
+    m_staticMatrices[cascade] = matrix(cascade);
+    ++m_staticRenders;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_staticFramebuffer);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_staticTexture, 0, static_cast<GLint>(cascade));
+    glViewport(0, 0, m_resolution, m_resolution);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_DEPTH_CLAMP);
+    return true;
+}
+
+void CascadedShadowMap::beginDynamic(u32 cascade) const noexcept
+{
+    // GL 3.3 has no glCopyImageSubData (4.3); a blit between equal depth formats copies the values unchanged
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_staticFramebuffer);
+    glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_staticTexture, 0, static_cast<GLint>(cascade));
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_texture, 0, static_cast<GLint>(cascade));
+    glBlitFramebuffer(0, 0, m_resolution, m_resolution, 0, 0, m_resolution, m_resolution, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, m_resolution, m_resolution);
+    glEnable(GL_DEPTH_CLAMP);
+}
+
+void CascadedShadowMap::end(GLuint framebuffer) const noexcept
+{
+    glDisable(GL_DEPTH_CLAMP);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+}
+
+void CascadedShadowMap::bindTexture(GLuint unit) const noexcept
+{
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void CascadedShadowMap::create()
+{
+    const auto depthArray = [this](GLuint &texture, GLuint &framebuffer) {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, m_resolution, m_resolution, static_cast<GLsizei>(m_cascadeCount), 0,
+                     GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        // outside a cascade reads as the far plane: unshadowed
+        constexpr GLfloat border[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, border);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, 0);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return status == GL_FRAMEBUFFER_COMPLETE;
+    };
+    const bool complete = depthArray(m_texture, m_framebuffer);
+    const bool staticComplete = depthArray(m_staticTexture, m_staticFramebuffer);
+    invalidateStatic();
+
+    if (!complete || !staticComplete)
+    {
+        destroy();
+        throw std::runtime_error{"Shadow map framebuffer is incomplete"};
+    }
+}
+
+void CascadedShadowMap::destroy() noexcept
+{
+    glDeleteFramebuffers(1, &m_framebuffer);
+    glDeleteTextures(1, &m_texture);
+    glDeleteFramebuffers(1, &m_staticFramebuffer);
+    glDeleteTextures(1, &m_staticTexture);
+    m_framebuffer = m_texture = m_staticFramebuffer = m_staticTexture = 0;
+}
+
+} // namespace GameProgramming::GL
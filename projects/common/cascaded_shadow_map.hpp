@@ -0,0 +1,136 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/ext/vector_float3.hpp>
+#include <glm/ext/vector_float4.hpp>
+
+#include "type.hpp"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace GameProgramming::GL
+{
+
+inline constexpr u32 MaxShadowCascades = 4;
+
+// Mirrors this std140 block, bound at Shader::ShadowCascadesBinding by bindConstantBlocks():
+//
+//   layout (std140) uniform ShadowCascades
+//   {
+//       mat4 cascadeMatrices[4]; // world to the [-1, 1] clip space of each cascade
+//       vec4 cascadeSplits[4];   // x: view depth the cascade ends at, y: world size of one of its texels,
+//                                // z: 1 / its depth range, to turn a bias in world units into depth
+//       int cascadeCount;
+//   };
+//
+// A fragment uses the first cascade whose split lies beyond its view depth and is unshadowed past the last.
+struct CascadeConstants
+{
+    std::array<glm::mat4, MaxShadowCascades> matrices{};
+    std::array<glm::vec4, MaxShadowCascades> splits{};
+    i32 count = 0;
+    float padding[3] = {};
+};
+
+static_assert(offsetof(CascadeConstants, splits) == 256);
+static_assert(offsetof(CascadeConstants, count) == 320);
+static_assert(sizeof(CascadeConstants) == 336);
+
+// Cascaded shadow maps for a directional light: the camera frustum, up to a shadow distance, is cut into
+// cascadeCount() slices, each rendered into its own layer of one depth texture array at resolution()^2.
+// Near slices cover little ground and so get fine texels; far ones trade them for reach.
+//
+// Each slice is bounded by the smallest sphere around its corners, whose radius only depends on the camera's
+// field of view and the split depths, and its light space origin is snapped to whole texels. Moving or
+// turning the camera therefore moves the shadow map by whole texels and never resizes it, so shadow edges
+// do not shimmer. The depth pass runs with GL_DEPTH_CLAMP: casters between the light and a slice are
+// flattened onto its near plane instead of being clipped away.
+//
+// Casters that never move can be cached: a second texture array keeps their depth per cascade, rendered again
+// only when the cascade's matrix changed (the camera moved by a texel or the light turned) or after
+// invalidateStatic(). Each frame then starts a cascade from a copy of that layer and draws just the moving
+// casters on top:
+//
+//   if (shadows.beginStatic(i))
+//       drawStaticCasters();
+//   shadows.beginDynamic(i);
+//   drawDynamicCasters();
+class CascadedShadowMap
+{
+public:
+    // Throws std::invalid_argument unless 1 <= cascadeCount <= MaxShadowCascades and the resolution is a
+    // texture size the driver supports, std::runtime_error if the driver cannot render to the texture.
+    CascadedShadowMap(u32 cascadeCount, GLsizei resolution);
+    ~CascadedShadowMap();
+    CascadedShadowMap(const CascadedShadowMap &) = delete;
+    CascadedShadowMap &operator=(const CascadedShadowMap &) = delete;
+    CascadedShadowMap(CascadedShadowMap &&) = delete;
+    CascadedShadowMap &operator=(CascadedShadowMap &&) = delete;
+
+    // Reallocates the texture array when the count or resolution changed; throws as the constructor.
+    void configure(u32 cascadeCount, GLsizei resolution);
+
+    [[nodiscard]] u32 cascadeCount() const noexcept { return m_cascadeCount; }
+    [[nodiscard]] GLsizei resolution() const noexcept { return m_resolution; }
+    [[nodiscard]] GLuint texture() const noexcept { return m_texture; }
+
+    // Blends logarithmic split depths (1) with evenly spaced ones (0); logarithmic gives every cascade the same
+    // texels per screen pixel but makes the first one very short.
+    [[nodiscard]] float splitLambda() const noexcept { return m_splitLambda; }
+    void setSplitLambda(float lambda) noexcept { m_splitLambda = lambda; }
+
+    // Fits the cascades to the part of a perspective camera's frustum (vertical `fovY` in radians) between
+    // `nearDepth` and `shadowDistance`, for light travelling along `lightDirection`.
+    void update(const glm::mat4 &view, float fovY, float aspect, float nearDepth, float shadowDistance, const glm::vec3 &lightDirection);
+
+    [[nodiscard]] const CascadeConstants &constants() const noexcept { return m_constants; }
+    // world to light space, the same for every cascade; each one adds its own projection
+    [[nodiscard]] const glm::mat4 &lightView() const noexcept { return m_lightView; }
+    [[nodiscard]] const glm::mat4 &projection(u32 cascade) const noexcept { return m_projections[cascade]; }
+    [[nodiscard]] const glm::mat4 &matrix(u32 cascade) const noexcept { return m_constants.matrices[cascade]; }
+
+    // Writes constants() into the uniform buffer and binds it to its binding point.
+    void upload() const noexcept;
+
+    // Renders into layer `cascade`: binds it, sets the viewport, clears it and enables GL_DEPTH_CLAMP.
+    void beginCascade(u32 cascade) const noexcept;
+
+    // Marks every cached static layer stale, for when a static caster moved.
+    void invalidateStatic() noexcept { m_staticValid = {}; }
+    // When the static layer of `cascade` is stale, renders into it as beginCascade() does and returns true; the
+    // static casters are to be drawn next. Returns false, binding nothing, while the cached layer still holds.
+    [[nodiscard]] bool beginStatic(u32 cascade) noexcept;
+    // Copies the static layer into layer `cascade` and renders into it as beginCascade() does, without the clear.
+    void beginDynamic(u32 cascade) const noexcept;
+    // static layers rendered since the last call, to see how well the cache holds
+    [[nodiscard]] u32 takeStaticRenderCount() noexcept { return std::exchange(m_staticRenders, 0u); }
+    // Disables GL_DEPTH_CLAMP and binds `framebuffer` again; the caller restores its viewport.
+    void end(GLuint framebuffer = 0) const noexcept;
+
+    void bindTexture(GLuint unit) const noexcept;
+
+private:
+    void create();
+    void destroy() noexcept;
+
+    u32 m_cascadeCount;
+    GLsizei m_resolution;
+    float m_splitLambda = 0.75f;
+    GLuint m_texture = 0;
+    GLuint m_framebuffer = 0;
+    GLuint m_staticTexture = 0;
+    GLuint m_staticFramebuffer = 0;
+    GLuint m_buffer = 0;
+    glm::mat4 m_lightView{1.0f};
+    std::array<glm::mat4, MaxShadowCascades> m_projections{};
+    CascadeConstants m_constants;
+    std::array<glm::mat4, MaxShadowCascades> m_staticMatrices{}; // what each static layer was rendered with
+    std::array<bool, MaxShadowCascades> m_staticValid{};
+    u32 m_staticRenders = 0;
+};
+
+} // namespace GameProgramming::GL
@@ -0,0 +1,69 @@
+#include "constant_buffers.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace GameProgramming::Shader
+{
+
+namespace
+{
+
+GLintptr alignUp(GLintptr size, GLintptr alignment) noexcept
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+ConstantBuffers::ConstantBuffers(u32 passCount)
+    : m_passes(passCount)
+{
+    if (passCount == 0)
+    {
+        throw std::invalid_argument{"ConstantBuffers needs at least one pass"};
+    }
+
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    alignment = alignment > 0 ? alignment : 256;
+    m_frameSize = alignUp(sizeof(FrameConstants), alignment);
+    m_passSize = alignUp(sizeof(PassConstants), alignment);
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, passOffset(passCount), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+ConstantBuffers::~ConstantBuffers()
+{
+    glDeleteBuffers(1, &m_buffer);
+}
+
+void ConstantBuffers::upload() const noexcept
+{
+    const GLsizeiptr size = passOffset(passCount());
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    // invalidating lets the driver hand out new storage instead of waiting for last frame's draws
+    auto *data = static_cast<std::byte *>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    if (data)
+    {
+        std::memcpy(data, &m_frame, sizeof(FrameConstants));
+        for (u32 i = 0; i < passCount(); ++i)
+        {
+            std::memcpy(data + passOffset(i), &m_passes[i], sizeof(PassConstants));
+        }
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    glBindBufferRange(GL_UNIFORM_BUFFER, FrameConstantsBinding, m_buffer, 0, sizeof(FrameConstants));
+}
+
+void ConstantBuffers::bindPass(u32 index) const noexcept
+{
+    glBindBufferRange(GL_UNIFORM_BUFFER, PassConstantsBinding, m_buffer, passOffset(index), sizeof(PassConstants));
+}
+
+} // namespace GameProgramming::Shader
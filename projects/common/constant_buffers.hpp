@@ -0,0 +1,119 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/ext/vector_float3.hpp>
+
+#include "type.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace GameProgramming::Shader
+{
+
+// Uniform buffer binding points, the same for every program. GLSL 3.30 cannot declare them
+// (layout(binding) is 4.20), so bindConstantBlocks() assigns them after link.
+inline constexpr GLuint FrameConstantsBinding = 0;
+inline constexpr GLuint PassConstantsBinding = 1;
+inline constexpr GLuint ShadowCascadesBinding = 2; // GL::CascadeConstants, filled by GL::CascadedShadowMap
+
+// Mirrors, member for member, these std140 blocks; shaders declare whichever of them they read:
+//
+//   layout (std140) uniform FrameConstants
+//   {
+//       mat4 lightSpaceMatrix;
+//       vec3 lightPos;
+//       float time;
+//   };
+//
+//   layout (std140) uniform PassConstants
+//   {
+//       mat4 view;
+//       mat4 projection;
+//       mat4 viewProjection;
+//       vec3 viewPos;
+//   };
+//
+// Blocks without an instance name put their members in the global scope, so shader code keeps using
+// `view`, `lightPos`, ... as before.
+
+// Values shared by every pass of a frame.
+struct FrameConstants
+{
+    glm::mat4 lightSpaceMatrix{1.0f};
+    glm::vec3 lightPos{0.0f};
+    float time = 0.0f; // std140 packs a scalar into the last component of a vec3
+};
+
+// Camera of one render pass: the viewer for the lit pass, the light for a shadow map pass.
+struct PassConstants
+{
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+    glm::mat4 viewProjection{1.0f};
+    glm::vec3 viewPos{0.0f};
+    float padding = 0.0f;
+};
+
+static_assert(sizeof(glm::mat4) == 64 && sizeof(glm::vec3) == 12, "std140 mirrors need tightly packed glm types");
+static_assert(offsetof(FrameConstants, lightSpaceMatrix) == 0);
+static_assert(offsetof(FrameConstants, lightPos) == 64);
+static_assert(offsetof(FrameConstants, time) == 76);
+static_assert(sizeof(FrameConstants) == 80);
+static_assert(offsetof(PassConstants, view) == 0);
+static_assert(offsetof(PassConstants, projection) == 64);
+static_assert(offsetof(PassConstants, viewProjection) == 128);
+static_assert(offsetof(PassConstants, viewPos) == 192);
+static_assert(sizeof(PassConstants) == 208);
+
+// Points the FrameConstants / PassConstants / ShadowCascades blocks of a linked program, if it has them, at their binding.
+inline void bindConstantBlocks(GLuint program) noexcept
+{
+    if (const GLuint block = glGetUniformBlockIndex(program, "FrameConstants"); block != GL_INVALID_INDEX)
+    {
+        glUniformBlockBinding(program, block, FrameConstantsBinding);
+    }
+    if (const GLuint block = glGetUniformBlockIndex(program, "PassConstants"); block != GL_INVALID_INDEX)
+    {
+        glUniformBlockBinding(program, block, PassConstantsBinding);
+    }
+    if (const GLuint block = glGetUniformBlockIndex(program, "ShadowCascades"); block != GL_INVALID_INDEX)
+    {
+        glUniformBlockBinding(program, block, ShadowCascadesBinding);
+    }
+}
+
+// One uniform buffer holding the frame block followed by a block per pass, each at the
+// GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT the driver asks for. Fill frame() and pass(i) on the CPU, upload() once
+// per frame, then bindPass(i) before drawing pass i; programs never see an individual glUniform call for these.
+class ConstantBuffers
+{
+public:
+    explicit ConstantBuffers(u32 passCount = 1);
+    ~ConstantBuffers();
+    ConstantBuffers(const ConstantBuffers &) = delete;
+    ConstantBuffers &operator=(const ConstantBuffers &) = delete;
+    ConstantBuffers(ConstantBuffers &&) = delete;
+    ConstantBuffers &operator=(ConstantBuffers &&) = delete;
+
+    [[nodiscard]] FrameConstants &frame() noexcept { return m_frame; }
+    [[nodiscard]] PassConstants &pass(u32 index) noexcept { return m_passes[index]; }
+    [[nodiscard]] u32 passCount() const noexcept { return static_cast<u32>(m_passes.size()); }
+
+    // Writes every block into a fresh (orphaned) buffer store and binds the frame block.
+    void upload() const noexcept;
+    void bindPass(u32 index) const noexcept;
+
+private:
+    [[nodiscard]] GLintptr passOffset(u32 index) const noexcept { return m_frameSize + static_cast<GLintptr>(index) * m_passSize; }
+
+    GLuint m_buffer = 0;
+    GLintptr m_frameSize = 0; // block sizes rounded up to the offset alignment
+    GLintptr m_passSize = 0;
+    FrameConstants m_frame;
+    std::vector<PassConstants> m_passes;
+};
+
+} // namespace GameProgramming::Shader
@@ -0,0 +1,43 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace GameProgramming::Utility
+{
+
+// Whether the CPU runs AVX2 and FMA code and the OS saves the ymm registers, asked of CPUID once. Always false
+// when the build is not for x86-64.
+[[nodiscard]] inline bool cpuHasAvx2() noexcept
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    static const bool supported = [] {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+        __cpuid(info, 1);
+        const bool fma = info[2] & (1 << 12);
+        const bool osxsave = info[2] & (1 << 27);
+        const bool avx = info[2] & (1 << 28);
+        // the OS has to save the upper halves of the ymm registers too
+        if (!fma || !osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+            return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    }();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+} // namespace GameProgramming::Utility
@@ -0,0 +1,93 @@
+#include "crowd_animation.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+namespace GameProgramming::Animation
+{
+
+CrowdAnimation::CrowdAnimation(const AnimationStateMachine &machine, const Skeleton &skeleton, const glm::vec3 *boneColors,
+                               Job::JobSystem &jobs, const BlendKernels &kernels)
+    : m_skeleton(&skeleton), m_jobs(jobs), m_kernels(&kernels), m_machine(&machine),
+      m_boneColors(boneColors, boneColors + skeleton.boneCount())
+{
+    if (machine.boneCount() != skeleton.boneCount())
+        throw std::invalid_argument{"A crowd's state machine animates the bones of its skeleton"};
+
+    const u32 bones = skeleton.boneCount();
+    m_scratch.resize(jobs.threadCount());
+    for (ThreadScratch &scratch : m_scratch)
+    {
+        scratch.rotations.resize(ChunkSize * bones);
+        scratch.targets.resize(ChunkSize * bones);
+        scratch.weights.resize(ChunkSize * bones);
+        scratch.pose.resize(bones);
+        scratch.world.resize(bones);
+    }
+}
+
+void CrowdAnimation::add(const glm::mat4 &model, u32 state, float time)
+{
+    m_players.emplace_back(*m_machine, state, time);
+    m_models.push_back(model);
+}
+
+void CrowdAnimation::update(float deltaTime, BoneInstance *out)
+{
+    animate(deltaTime, [&](u32 character, glm::mat4 *world) {
+        m_skeleton->computeShapes(world, world);
+        BoneInstance *instance = out + static_cast<std::size_t>(character) * boneCount();
+        for (u32 bone = 0; bone < boneCount(); ++bone)
+            instance[bone] = {world[bone], m_boneColors[bone], 0.0f};
+    });
+}
+
+void CrowdAnimation::updateSkinning(float deltaTime, const glm::mat4 *inverseBind, glm::mat4 *palettes)
+{
+    animate(deltaTime, [&](u32 character, glm::mat4 *world) {
+        m_skeleton->computeSkinning(world, inverseBind, palettes + static_cast<std::size_t>(character) * boneCount());
+    });
+}
+
+template <typename Write>
+void CrowdAnimation::animate(float deltaTime, const Write &write)
+{
+    // without workers the JobSystem hands the calling thread the whole range at once
+    m_jobs.parallelFor(size(), ChunkSize, [&](u32 begin, u32 end, u32 thread) {
+        for (; begin < end; begin += ChunkSize)
+            animateChunk(begin, std::min(end, begin + ChunkSize), deltaTime, m_scratch[thread], write);
+    });
+}
+
+template <typename Write>
+void CrowdAnimation::animateChunk(u32 begin, u32 end, float deltaTime, ThreadScratch &scratch, const Write &write) noexcept
+{
+    const u32 bones = boneCount();
+
+    for (u32 character = begin; character < end; ++character)
+    {
+        const PoseSample sample = m_players[character].advance(deltaTime);
+        const u32 first = (character - begin) * bones;
+        for (u32 bone = 0; bone < bones; ++bone)
+        {
+            scratch.rotations.set(first + bone, sample.from[bone]);
+            scratch.targets.set(first + bone, sample.to[bone]);
+            scratch.weights[first + bone] = sample.t;
+        }
+    }
+    const u32 count = (end - begin) * bones;
+    m_kernels->blend(scratch.rotations.streams(), scratch.targets.streams(), scratch.weights.data(), count, scratch.rotations.streams());
+
+    for (u32 character = begin; character < end; ++character)
+    {
+        const u32 first = (character - begin) * bones;
+        for (u32 bone = 0; bone < bones; ++bone)
+            scratch.pose[bone] = scratch.rotations.get(first + bone);
+
+        m_skeleton->computeWorld(m_models[character], scratch.pose.data(), scratch.world.data());
+        write(character, scratch.world.data());
+    }
+}
+
+} // namespace GameProgramming::Animation
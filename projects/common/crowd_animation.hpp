@@ -0,0 +1,78 @@
+#pragma once
+
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/ext/quaternion_float.hpp>
+#include <glm/ext/vector_float3.hpp>
+
+#include "animation_state.hpp"
+#include "bone_instance.hpp"
+#include "job_system.hpp"
+#include "pose_blend.hpp"
+#include "skeleton.hpp"
+#include "type.hpp"
+
+#include <vector>
+
+namespace GameProgramming::Animation
+{
+
+// Characters sharing one skeleton and one state machine, each with its own AnimationPlayer and model matrix.
+// update() splits the crowd into chunks of characters run on every thread of a JobSystem: each chunk advances
+// its players, blends their poses in one SoA batch, walks the skeleton per character and writes the bones
+// out, as instances of the rigid bone shapes or as skinning palettes. Scratch lives per thread and is sized up
+// front, so a frame allocates nothing.
+class CrowdAnimation
+{
+public:
+    // characters one job animates: enough to amortize claiming the chunk and to fill the blend kernel's lanes,
+    // few enough that a thread's scratch stays in its cache
+    static constexpr u32 ChunkSize = 128;
+
+    // `boneColors` holds one color per bone of `skeleton`. Throws std::invalid_argument if the skeleton and the
+    // state machine disagree on the bone count.
+    CrowdAnimation(const AnimationStateMachine &machine, const Skeleton &skeleton, const glm::vec3 *boneColors,
+                   Job::JobSystem &jobs, const BlendKernels &kernels = bestBlendKernels());
+
+    // Adds a character standing at `model`, `time` seconds into `state`.
+    void add(const glm::mat4 &model, u32 state, float time);
+
+    [[nodiscard]] u32 size() const noexcept { return static_cast<u32>(m_players.size()); }
+    [[nodiscard]] u32 boneCount() const noexcept { return m_skeleton->boneCount(); }
+    [[nodiscard]] const AnimationPlayer &player(u32 character) const noexcept { return m_players[character]; }
+    [[nodiscard]] const BlendKernels &kernels() const noexcept { return *m_kernels; }
+
+    // Advances every character by `deltaTime` and writes size() * boneCount() instances to `out`, character
+    // after character in Skeleton order. Written front to back exactly once per chunk, so `out` can be
+    // write-combined mapped memory, e.g. BoneRenderer::beginFrame().
+    void update(float deltaTime, BoneInstance *out);
+    // The same, but writes every character's skinning palette to `palettes` instead, boneCount() matrices each
+    // (Skeleton::computeSkinning with `inverseBind`), e.g. to SkinnedRenderer::beginFrame().
+    void updateSkinning(float deltaTime, const glm::mat4 *inverseBind, glm::mat4 *palettes);
+
+private:
+    struct ThreadScratch
+    {
+        QuatArray rotations; // the chunk's poses, blended in place
+        QuatArray targets;
+        std::vector<float> weights;
+        std::vector<glm::quat> pose; // one character's rotations, gathered back out of the arrays
+        std::vector<glm::mat4> world;
+    };
+
+    // every character's world matrices, handed to `write(character, world)` in order
+    template <typename Write>
+    void animate(float deltaTime, const Write &write);
+    template <typename Write>
+    void animateChunk(u32 begin, u32 end, float deltaTime, ThreadScratch &scratch, const Write &write) noexcept;
+
+    const Skeleton *m_skeleton;
+    Job::JobSystem &m_jobs;
+    const BlendKernels *m_kernels;
+    const AnimationStateMachine *m_machine;
+    std::vector<glm::vec3> m_boneColors;
+    std::vector<AnimationPlayer> m_players;
+    std::vector<glm::mat4> m_models;
+    std::vector<ThreadScratch> m_scratch;
+};
+
+} // namespace GameProgramming::Animation
@@ -0,0 +1,80 @@
+#include "gl_extensions.hpp"
+
+namespace GameProgramming::GL
+{
+
+namespace
+{
+
+Extensions g_extensions;
+
+bool hasVersion(int major, int minor) noexcept
+{
+    return GLVersion.major > major || (GLVersion.major == major && GLVersion.minor >= minor);
+}
+
+template <typename Proc>
+Proc resolve(GLADloadproc load, const char *name) noexcept
+{
+    return reinterpret_cast<Proc>(load(name));
+}
+
+} // namespace
+
+void loadExtensions(GLADloadproc load) noexcept
+{
+    g_extensions = {};
+
+    if (hasVersion(4, 1) || hasExtension("GL_ARB_get_program_binary"))
+    {
+        g_extensions.GetProgramBinary = resolve<PFNGLGETPROGRAMBINARYPROC>(load, "glGetProgramBinary");
+        g_extensions.ProgramBinary = resolve<PFNGLPROGRAMBINARYPROC>(load, "glProgramBinary");
+        g_extensions.ProgramParameteri = resolve<PFNGLPROGRAMPARAMETERIPROC>(load, "glProgramParameteri");
+
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        g_extensions.ARB_get_program_binary =
+            formats > 0 && g_extensions.GetProgramBinary && g_extensions.ProgramBinary && g_extensions.ProgramParameteri;
+    }
+
+    if (hasExtension("GL_KHR_parallel_shader_compile"))
+    {
+        g_extensions.MaxShaderCompilerThreads = resolve<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(load, "glMaxShaderCompilerThreadsKHR");
+    }
+    else if (hasExtension("GL_ARB_parallel_shader_compile"))
+    {
+        g_extensions.MaxShaderCompilerThreads = resolve<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(load, "glMaxShaderCompilerThreadsARB");
+    }
+    g_extensions.KHR_parallel_shader_compile = g_extensions.MaxShaderCompilerThreads != nullptr;
+    if (g_extensions.KHR_parallel_shader_compile)
+    {
+        // let the driver pick the thread count; the default may be a single thread
+        g_extensions.MaxShaderCompilerThreads(0xFFFFFFFFu);
+    }
+
+    if (hasVersion(4, 4) || hasExtension("GL_ARB_buffer_storage"))
+    {
+        g_extensions.BufferStorage = resolve<PFNGLBUFFERSTORAGEPROC>(load, "glBufferStorage");
+        g_extensions.ARB_buffer_storage = g_extensions.BufferStorage != nullptr;
+    }
+}
+
+const Extensions &extensions() noexcept
+{
+    return g_extensions;
+}
+
+bool hasExtension(std::string_view name) noexcept
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i)
+    {
+        const auto *extension = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (extension && name == extension)
+            return true;
+    }
+    return false;
+}
+
+} // namespace GameProgramming::GL
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string_view>
+
+// glad was generated for the GL 3.3 core profile without extensions; the few newer entry points the
+// common code can take advantage of are declared and loaded here instead.
+
+#ifndef GL_ARB_get_program_binary
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+#endif
+
+#ifndef GL_KHR_parallel_shader_compile
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+#endif
+
+#ifndef GL_ARB_buffer_storage
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+#endif
+
+namespace GameProgramming::GL
+{
+
+struct Extensions
+{
+    // GL_ARB_get_program_binary, core in 4.1; also false when the driver offers no binary format
+    bool ARB_get_program_binary = false;
+    PFNGLGETPROGRAMBINARYPROC GetProgramBinary = nullptr;
+    PFNGLPROGRAMBINARYPROC ProgramBinary = nullptr;
+    PFNGLPROGRAMPARAMETERIPROC ProgramParameteri = nullptr;
+
+    // GL_KHR_parallel_shader_compile (or the ARB twin): compiles and links run on driver threads and
+    // GL_COMPLETION_STATUS_KHR can be polled without blocking
+    bool KHR_parallel_shader_compile = false;
+    PFNGLMAXSHADERCOMPILERTHREADSKHRPROC MaxShaderCompilerThreads = nullptr;
+
+    // GL_ARB_buffer_storage, core in 4.4: immutable buffers that can stay mapped while the GPU reads them
+    bool ARB_buffer_storage = false;
+    PFNGLBUFFERSTORAGEPROC BufferStorage = nullptr;
+};
+
+// Resolves the extension entry points the current context supports. Call it once, right after
+// gladLoadGLLoader, with the same loader; until then every extension reads as unsupported.
+void loadExtensions(GLADloadproc load) noexcept;
+
+[[nodiscard]] const Extensions &extensions() noexcept;
+
+// Whether the current context advertises `name` (e.g. "GL_ARB_get_program_binary") in its extension list.
+[[nodiscard]] bool hasExtension(std::string_view name) noexcept;
+
+} // namespace GameProgramming::GL
@@ -0,0 +1,124 @@
+#include "gpu_particles.hpp"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace GameProgramming::Particle
+{
+
+GpuParticleSystem::GpuParticleSystem(u32 capacity) : m_ring(capacity)
+{
+    if (capacity == 0)
+        throw std::invalid_argument{"A particle system needs at least one slot"};
+
+    glGenBuffers(2, m_buffers.data());
+    glGenVertexArrays(2, m_vaos.data());
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+        glBindVertexArray(m_vaos[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffers[i]);
+        // written by transform feedback, read by the next update and the draw: never touched by the CPU
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity) * sizeof(ParticleState), nullptr, GL_DYNAMIC_COPY);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleState), reinterpret_cast<void *>(offsetof(ParticleState, positionAge)));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleState), reinterpret_cast<void *>(offsetof(ParticleState, velocityLife)));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleState), reinterpret_cast<void *>(offsetof(ParticleState, color)));
+        glEnableVertexAttribArray(2);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+GpuParticleSystem::~GpuParticleSystem()
+{
+    glDeleteVertexArrays(2, m_vaos.data());
+    glDeleteBuffers(2, m_buffers.data());
+}
+
+void GpuParticleSystem::emit(const Burst &burst)
+{
+    if (burst.count != 0)
+        m_queued.push_back(burst);
+}
+
+void GpuParticleSystem::update(const Shader::ShaderProgram &updateProgram, float deltaTime, const glm::vec3 &gravity)
+{
+    m_ring.advance(deltaTime);
+
+    std::array<glm::vec4, MaxBurstsPerUpdate> origins;
+    std::array<glm::vec4, MaxBurstsPerUpdate> velocities;
+    std::array<glm::vec4, MaxBurstsPerUpdate> colors;
+    std::array<GLint, MaxBurstsPerUpdate> firsts;
+    std::array<GLint, MaxBurstsPerUpdate> sizes;
+    const u32 burstCount = static_cast<u32>(std::min<std::size_t>(m_queued.size(), MaxBurstsPerUpdate));
+    for (u32 i = 0; i < burstCount; ++i)
+    {
+        const Burst &burst = m_queued[i];
+        const SlotRange slots = m_ring.claim(burst.count, burst.lifetime);
+        origins[i] = glm::vec4(burst.origin, burst.lifetime);
+        velocities[i] = glm::vec4(burst.velocity, burst.spread);
+        colors[i] = glm::vec4(burst.color, burst.colorJitter);
+        firsts[i] = static_cast<GLint>(slots.first);
+        sizes[i] = static_cast<GLint>(slots.count);
+    }
+    m_queued.erase(m_queued.begin(), m_queued.begin() + burstCount);
+
+    std::array<SlotRange, 2> ranges;
+    const u32 rangeCount = m_ring.ranges(ranges);
+    if (rangeCount == 0)
+        return;
+
+    updateProgram.use();
+    glUniform1f(updateProgram.getUniformLocation("deltaTime"), deltaTime);
+    glUniform3fv(updateProgram.getUniformLocation("gravity"), 1, glm::value_ptr(gravity));
+    glUniform1i(updateProgram.getUniformLocation("capacity"), static_cast<GLint>(m_ring.capacity()));
+    glUniform1i(updateProgram.getUniformLocation("seed"), static_cast<GLint>(m_seed++));
+    glUniform1i(updateProgram.getUniformLocation("burstCount"), static_cast<GLint>(burstCount));
+    if (burstCount != 0)
+    {
+        glUniform4fv(updateProgram.getUniformLocation("burstOrigin"), static_cast<GLsizei>(burstCount), glm::value_ptr(origins[0]));
+        glUniform4fv(updateProgram.getUniformLocation("burstVelocity"), static_cast<GLsizei>(burstCount), glm::value_ptr(velocities[0]));
+        glUniform4fv(updateProgram.getUniformLocation("burstColor"), static_cast<GLsizei>(burstCount), glm::value_ptr(colors[0]));
+        glUniform1iv(updateProgram.getUniformLocation("burstFirst"), static_cast<GLsizei>(burstCount), firsts.data());
+        glUniform1iv(updateProgram.getUniformLocation("burstSize"), static_cast<GLsizei>(burstCount), sizes.data());
+    }
+
+    // slot i of the source buffer lands in slot i of the destination: each range is captured into the same
+    // range of the other buffer
+    const GLuint destination = m_buffers[m_current ^ 1];
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindVertexArray(m_vaos[m_current]);
+    for (u32 i = 0; i < rangeCount; ++i)
+    {
+        glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, destination, static_cast<GLintptr>(ranges[i].first) * sizeof(ParticleState),
+                          static_cast<GLsizeiptr>(ranges[i].count) * sizeof(ParticleState));
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, static_cast<GLint>(ranges[i].first), static_cast<GLsizei>(ranges[i].count));
+        glEndTransformFeedback();
+    }
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glBindVertexArray(0);
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    m_current ^= 1;
+}
+
+void GpuParticleSystem::draw() const
+{
+    std::array<SlotRange, 2> ranges;
+    const u32 rangeCount = m_ring.ranges(ranges);
+
+    glBindVertexArray(m_vaos[m_current]);
+    for (u32 i = 0; i < rangeCount; ++i)
+    {
+        glDrawArrays(GL_POINTS, static_cast<GLint>(ranges[i].first), static_cast<GLsizei>(ranges[i].count));
+    }
+    glBindVertexArray(0);
+}
+
+} // namespace GameProgramming::Particle
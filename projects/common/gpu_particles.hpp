@@ -0,0 +1,82 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/ext/vector_float3.hpp>
+#include <glm/ext/vector_float4.hpp>
+
+#include "particle_ring.hpp"
+#include "shader.hpp"
+#include "type.hpp"
+
+#include <array>
+#include <vector>
+
+namespace GameProgramming::Particle
+{
+
+// One firework shell: `count` particles leave `origin` at `velocity` plus a random offset of up to `spread`,
+// tinted `color` +- `colorJitter`, and live between 3/4 of `lifetime` and `lifetime` seconds.
+struct Burst
+{
+    glm::vec3 origin{0.0f};
+    glm::vec3 velocity{0.0f};
+    float spread = 0.2f;
+    glm::vec3 color{1.0f};
+    float colorJitter = 0.2f;
+    float lifetime = 5.0f;
+    u32 count = 1000;
+};
+
+// Per-particle state as written by transform feedback and read back as vertex attributes 0, 1, 2.
+struct ParticleState
+{
+    glm::vec4 positionAge;   // xyz, seconds since emission
+    glm::vec4 velocityLife;  // xyz, seconds it lives
+    glm::vec4 color;         // rgb, a unused
+};
+static_assert(sizeof(ParticleState) == 48);
+
+// Particles simulated entirely on the GPU. The state lives in two buffers of `capacity` slots that the update
+// program ping-pongs between with transform feedback, so nothing is read back and nothing is reallocated.
+// Bursts take the next slots of an EmissionRing and are spawned by the update program itself from a handful
+// of uniforms: emitting costs no per-particle upload. Only the ring's live range is updated and drawn.
+class GpuParticleSystem
+{
+public:
+    // outputs of the update program, in ParticleState order
+    static constexpr std::array<const char *, 3> FeedbackVaryings{"outPositionAge", "outVelocityLife", "outColor"};
+    // bursts the update program can spawn in one update; more wait for the next one
+    static constexpr u32 MaxBurstsPerUpdate = 16;
+
+    explicit GpuParticleSystem(u32 capacity);
+    ~GpuParticleSystem();
+    GpuParticleSystem(const GpuParticleSystem &) = delete;
+    GpuParticleSystem &operator=(const GpuParticleSystem &) = delete;
+    GpuParticleSystem(GpuParticleSystem &&) = delete;
+    GpuParticleSystem &operator=(GpuParticleSystem &&) = delete;
+
+    // Queued for the next update().
+    void emit(const Burst &burst);
+
+    // Spawns the queued bursts and advances every live particle by `deltaTime`. `updateProgram` is a
+    // ShaderProgram built from the update shader with FeedbackVaryings.
+    void update(const Shader::ShaderProgram &updateProgram, float deltaTime, const glm::vec3 &gravity);
+
+    // Draws the live particles as GL_POINTS with the program currently in use.
+    void draw() const;
+
+    [[nodiscard]] u32 capacity() const noexcept { return m_ring.capacity(); }
+    // particles in the live range, some of which may have died a little earlier than their burst
+    [[nodiscard]] u32 liveCount() const noexcept { return m_ring.liveCount(); }
+
+private:
+    EmissionRing m_ring;
+    std::array<GLuint, 2> m_buffers{};
+    std::array<GLuint, 2> m_vaos{};
+    u32 m_current = 0; // buffer holding the latest state
+    u32 m_seed = 0;
+    std::vector<Burst> m_queued;
+};
+
+} // namespace GameProgramming::Particle
@@ -0,0 +1,66 @@
+#include "gpu_timer.hpp"
+
+namespace GameProgramming::GL
+{
+
+GpuTimer::GpuTimer()
+{
+    glGenQueries(QueryCount, m_queries.data());
+}
+
+GpuTimer::~GpuTimer()
+{
+    glDeleteQueries(QueryCount, m_queries.data());
+}
+
+void GpuTimer::begin()
+{
+    // every query is in flight: only the oldest, which this begin() reuses, has to be waited for
+    if (m_pending == QueryCount)
+        readOldest();
+    poll();
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[m_next]);
+}
+
+void GpuTimer::end()
+{
+    glEndQuery(GL_TIME_ELAPSED);
+    m_next = (m_next + 1) % QueryCount;
+    ++m_pending;
+}
+
+void GpuTimer::poll(bool wait)
+{
+    while (m_pending != 0)
+    {
+        if (!wait)
+        {
+            const GLuint query = m_queries[(m_next + QueryCount - m_pending) % QueryCount];
+            GLint available = GL_FALSE;
+            glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                return;
+        }
+
+        readOldest();
+    }
+}
+
+void GpuTimer::readOldest()
+{
+    const GLuint query = m_queries[(m_next + QueryCount - m_pending) % QueryCount];
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+    m_lastMs = static_cast<double>(nanoseconds) / 1e6;
+    m_totalMs += m_lastMs;
+    ++m_samples;
+    --m_pending;
+}
+
+void GpuTimer::reset() noexcept
+{
+    m_totalMs = 0.0;
+    m_samples = 0;
+}
+
+} // namespace GameProgramming::GL
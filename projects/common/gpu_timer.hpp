@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "type.hpp"
+
+#include <array>
+
+namespace GameProgramming::GL
+{
+
+// GPU time spent on the commands between begin() and end(), from GL_TIME_ELAPSED queries. Results are
+// picked up a few frames later, once the GPU has them, so measuring never stalls the pipeline unless more
+// than QueryCount measurements are in flight. Timers cannot nest: only one may be between begin() and end().
+class GpuTimer
+{
+public:
+    static constexpr u32 QueryCount = 4;
+
+    GpuTimer();
+    ~GpuTimer();
+    GpuTimer(const GpuTimer &) = delete;
+    GpuTimer &operator=(const GpuTimer &) = delete;
+    GpuTimer(GpuTimer &&) = delete;
+    GpuTimer &operator=(GpuTimer &&) = delete;
+
+    void begin();
+    void end();
+
+    // Collects the finished measurements; with `wait`, blocks until all of them finished.
+    void poll(bool wait = false);
+
+    // the latest finished measurement and the mean of all of them since reset(), in milliseconds
+    [[nodiscard]] double lastMs() const noexcept { return m_lastMs; }
+    [[nodiscard]] double averageMs() const noexcept { return m_samples ? m_totalMs / m_samples : 0.0; }
+    void reset() noexcept;
+
+private:
+    // reads the oldest pending query, blocking until the GPU finished it
+    void readOldest();
+
+    std::array<GLuint, QueryCount> m_queries{};
+    u32 m_next = 0;    // query the next begin() uses
+    u32 m_pending = 0; // ended, result not read yet
+    double m_lastMs = 0.0;
+    double m_totalMs = 0.0;
+    u32 m_samples = 0;
+};
+
+} // namespace GameProgramming::GL
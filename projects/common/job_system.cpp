@@ -0,0 +1,93 @@
+#include "job_system.hpp"
+
+#include <algorithm>
+
+namespace GameProgramming::Job
+{
+
+u32 JobSystem::defaultWorkerCount() noexcept
+{
+    const u32 hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+JobSystem::JobSystem(u32 workerCount)
+{
+    m_workers.reserve(workerCount);
+    for (u32 i = 0; i < workerCount; ++i)
+    {
+        m_workers.emplace_back(&JobSystem::workerLoop, this, i + 1);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    m_stop.store(true, std::memory_order_relaxed);
+    m_generation.fetch_add(1, std::memory_order_release);
+    m_generation.notify_all();
+    for (std::thread &worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+void JobSystem::dispatch(u32 count, u32 chunkSize, ChunkFunction function, const void *job)
+{
+    if (count == 0)
+        return;
+
+    chunkSize = std::max(chunkSize, 1u);
+    if (m_workers.empty() || count <= chunkSize)
+    {
+        function(job, 0, count, 0);
+        return;
+    }
+
+    m_function = function;
+    m_job = job;
+    m_count = count;
+    m_chunkSize = chunkSize;
+    m_chunkCount = (count + chunkSize - 1) / chunkSize;
+    m_nextChunk.store(0, std::memory_order_relaxed);
+    m_busyWorkers.store(static_cast<u32>(m_workers.size()), std::memory_order_relaxed);
+
+    m_generation.fetch_add(1, std::memory_order_release);
+    m_generation.notify_all();
+
+    runChunks(0);
+
+    // every worker checks in once per loop, even if the others took all the chunks, so the next loop cannot
+    // start while one of them still reads this one's parameters
+    for (u32 busy = m_busyWorkers.load(std::memory_order_acquire); busy != 0; busy = m_busyWorkers.load(std::memory_order_acquire))
+    {
+        m_busyWorkers.wait(busy, std::memory_order_acquire);
+    }
+}
+
+void JobSystem::runChunks(u32 thread) noexcept
+{
+    for (u32 chunk = m_nextChunk.fetch_add(1, std::memory_order_relaxed); chunk < m_chunkCount;
+         chunk = m_nextChunk.fetch_add(1, std::memory_order_relaxed))
+    {
+        const u32 begin = chunk * m_chunkSize;
+        m_function(m_job, begin, std::min(begin + m_chunkSize, m_count), thread);
+    }
+}
+
+void JobSystem::workerLoop(u32 thread) noexcept
+{
+    u32 seen = 0;
+    while (true)
+    {
+        m_generation.wait(seen, std::memory_order_acquire);
+        seen = m_generation.load(std::memory_order_acquire);
+        if (m_stop.load(std::memory_order_relaxed))
+            return;
+
+        runChunks(thread);
+        if (m_busyWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            m_busyWorkers.notify_one();
+    }
+}
+
+} // namespace GameProgramming::Job
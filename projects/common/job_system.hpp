@@ -0,0 +1,70 @@
+#pragma once
+
+#include "type.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace GameProgramming::Job
+{
+
+// Fixed set of worker threads for data-parallel loops. A loop is split into chunks that every thread, the
+// calling one included, claims with one atomic increment each; handing out a loop and waiting for it takes no
+// lock. Idle workers sleep on an atomic wait instead of spinning.
+class JobSystem
+{
+public:
+    // one thread per hardware thread, counting the caller
+    [[nodiscard]] static u32 defaultWorkerCount() noexcept;
+
+    explicit JobSystem(u32 workerCount = defaultWorkerCount());
+    ~JobSystem();
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+    JobSystem(JobSystem &&) = delete;
+    JobSystem &operator=(JobSystem &&) = delete;
+
+    // workers plus the calling thread
+    [[nodiscard]] u32 threadCount() const noexcept { return static_cast<u32>(m_workers.size()) + 1; }
+
+    // Calls `job(begin, end, thread)` for consecutive chunks [begin, end) of [0, count), at most `chunkSize`
+    // long, and returns once all of them ran. `thread` is below threadCount() and never shared by two chunks
+    // running at the same time, so it can index per-thread state; the caller is thread 0. `job` must not throw
+    // and must not call parallelFor itself.
+    template <typename Job>
+    void parallelFor(u32 count, u32 chunkSize, const Job &job)
+    {
+        dispatch(count, chunkSize, &callJob<Job>, &job);
+    }
+
+private:
+    using ChunkFunction = void (*)(const void *job, u32 begin, u32 end, u32 thread);
+
+    template <typename Job>
+    static void callJob(const void *job, u32 begin, u32 end, u32 thread)
+    {
+        (*static_cast<const Job *>(job))(begin, end, thread);
+    }
+
+    void dispatch(u32 count, u32 chunkSize, ChunkFunction function, const void *job);
+    void runChunks(u32 thread) noexcept;
+    void workerLoop(u32 thread) noexcept;
+
+    std::vector<std::thread> m_workers;
+
+    // the loop being run, published to the workers by the release increment of m_generation
+    ChunkFunction m_function = nullptr;
+    const void *m_job = nullptr;
+    u32 m_count = 0;
+    u32 m_chunkSize = 1;
+    u32 m_chunkCount = 0;
+
+    alignas(64) std::atomic<u32> m_nextChunk{0};
+    alignas(64) std::atomic<u32> m_generation{0};
+    alignas(64) std::atomic<u32> m_busyWorkers{0};
+    std::atomic<bool> m_stop{false};
+};
+
+} // namespace GameProgramming::Job
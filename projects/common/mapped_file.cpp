@@ -0,0 +1,140 @@
+#include "mapped_file.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace GameProgramming::Utility
+{
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::filesystem::path &path)
+{
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error{"Failed to open file: " + path.string()};
+    }
+    m_file = file;
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        unmap();
+        throw std::runtime_error{"Failed to map empty or unreadable file: " + path.string()};
+    }
+    m_size = static_cast<std::size_t>(fileSize.QuadPart);
+
+    m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping == nullptr)
+    {
+        unmap();
+        throw std::runtime_error{"Failed to create file mapping: " + path.string()};
+    }
+
+    m_data = static_cast<const std::byte *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr)
+    {
+        unmap();
+        throw std::runtime_error{"Failed to map view of file: " + path.string()};
+    }
+}
+
+void MappedFile::unmap() noexcept
+{
+    if (m_data != nullptr)
+        UnmapViewOfFile(m_data);
+    if (m_mapping != nullptr)
+        CloseHandle(m_mapping);
+    if (m_file != nullptr)
+        CloseHandle(m_file);
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error{"Failed to open file: " + path.string()};
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        ::close(fd);
+        throw std::runtime_error{"Failed to map empty or unreadable file: " + path.string()};
+    }
+    m_size = static_cast<std::size_t>(st.st_size);
+
+    void *addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+    if (addr == MAP_FAILED)
+    {
+        m_size = 0;
+        throw std::runtime_error{"Failed to mmap file: " + path.string()};
+    }
+    // the whole file is consumed right after mapping, so start paging it in now
+    ::madvise(addr, m_size, MADV_WILLNEED);
+    m_data = static_cast<const std::byte *>(addr);
+}
+
+void MappedFile::unmap() noexcept
+{
+    if (m_data != nullptr)
+        ::munmap(const_cast<std::byte *>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0))
+#ifdef _WIN32
+    , m_file(std::exchange(other.m_file, nullptr)), m_mapping(std::exchange(other.m_mapping, nullptr))
+#endif
+{
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+        m_file = std::exchange(other.m_file, nullptr);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+    }
+    return *this;
+}
+
+} // namespace GameProgramming::Utility
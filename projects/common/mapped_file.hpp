@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace GameProgramming::Utility
+{
+
+// Read-only memory mapping of a whole file. The mapping stays valid for the lifetime of the object.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path &path);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    [[nodiscard]] const std::byte *data() const noexcept { return m_data; }
+    [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+private:
+    void unmap() noexcept;
+
+    const std::byte *m_data = nullptr;
+    std::size_t m_size = 0;
+#ifdef _WIN32
+    void *m_file = nullptr;
+    void *m_mapping = nullptr;
+#endif
+};
+
+} // namespace GameProgramming::Utility
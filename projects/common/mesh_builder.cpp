@@ -0,0 +1,149 @@
+#include "mesh_builder.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <utility>
+
+namespace GameProgramming::Mesh
+{
+
+namespace
+{
+
+// -0.0f and +0.0f describe the same vertex, everything else is compared bit for bit
+u32 canonicalBits(float value) noexcept
+{
+    const u32 bits = std::bit_cast<u32>(value);
+    return bits == 0x80000000u ? 0u : bits;
+}
+
+} // namespace
+
+void IndexedMesh::uploadVertexData(GLenum usage) const noexcept
+{
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size() * sizeof(float)), vertices.data(), usage);
+}
+
+void IndexedMesh::uploadIndexData(GLenum usage) const
+{
+    if (indexType() == IndexType::UnsignedShort)
+    {
+        const std::vector<u16> narrow(indices.begin(), indices.end());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(narrow.size() * sizeof(u16)), narrow.data(), usage);
+    }
+    else
+    {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indices.size() * sizeof(u32)), indices.data(), usage);
+    }
+}
+
+MeshBuilder::MeshBuilder(u32 floatsPerVertex, std::size_t expectedVertices)
+    : m_floatsPerVertex(floatsPerVertex)
+{
+    if (floatsPerVertex == 0)
+    {
+        throw std::invalid_argument{"A vertex needs at least one float"};
+    }
+    m_vertices.reserve(expectedVertices * floatsPerVertex);
+    m_indices.reserve(expectedVertices);
+    rehash(std::bit_ceil(std::max<std::size_t>(expectedVertices * 2, 64)));
+}
+
+u32 MeshBuilder::addVertex(std::span<const float> vertex)
+{
+    if (vertex.size() != m_floatsPerVertex)
+    {
+        throw std::invalid_argument{"Vertex size does not match the builder layout"};
+    }
+
+    // keep the load factor at or below one half
+    if ((vertexCount() + 1) * 2 > m_slots.size())
+    {
+        rehash(m_slots.size() * 2);
+    }
+
+    const std::size_t mask = m_slots.size() - 1;
+    std::size_t slot = hash(vertex.data()) & mask;
+    while (m_slots[slot] != EmptySlot)
+    {
+        const u32 candidate = m_slots[slot];
+        if (equal(m_vertices.data() + std::size_t{candidate} * m_floatsPerVertex, vertex.data()))
+        {
+            m_indices.push_back(candidate);
+            return candidate;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    const u32 index = vertexCount();
+    m_vertices.insert(m_vertices.end(), vertex.begin(), vertex.end());
+    m_slots[slot] = index;
+    m_indices.push_back(index);
+    return index;
+}
+
+IndexedMesh MeshBuilder::build() &&
+{
+    IndexedMesh mesh;
+    mesh.vertices = std::move(m_vertices);
+    mesh.indices = std::move(m_indices);
+    mesh.floatsPerVertex = m_floatsPerVertex;
+    mesh.vertices.shrink_to_fit();
+    m_slots.clear();
+    return mesh;
+}
+
+IndexedMesh MeshBuilder::weld(std::span<const float> vertices, u32 floatsPerVertex)
+{
+    if (floatsPerVertex == 0 || vertices.size() % floatsPerVertex != 0)
+    {
+        throw std::invalid_argument{"Vertex data is not a whole number of vertices"};
+    }
+
+    const std::size_t corners = vertices.size() / floatsPerVertex;
+    MeshBuilder builder{floatsPerVertex, corners};
+    for (std::size_t i = 0; i < corners; ++i)
+    {
+        builder.addVertex(vertices.subspan(i * floatsPerVertex, floatsPerVertex));
+    }
+    return std::move(builder).build();
+}
+
+u64 MeshBuilder::hash(const float *vertex) const noexcept
+{
+    u64 h = 0x9e3779b97f4a7c15ull;
+    for (u32 i = 0; i < m_floatsPerVertex; ++i)
+    {
+        h = (h ^ canonicalBits(vertex[i])) * 0xff51afd7ed558ccdull;
+        h ^= h >> 32;
+    }
+    return h;
+}
+
+bool MeshBuilder::equal(const float *a, const float *b) const noexcept
+{
+    for (u32 i = 0; i < m_floatsPerVertex; ++i)
+    {
+        if (canonicalBits(a[i]) != canonicalBits(b[i]))
+            return false;
+    }
+    return true;
+}
+
+void MeshBuilder::rehash(std::size_t slotCount)
+{
+    m_slots.assign(slotCount, EmptySlot);
+    const std::size_t mask = slotCount - 1;
+    for (u32 index = 0; index < vertexCount(); ++index)
+    {
+        std::size_t slot = hash(m_vertices.data() + std::size_t{index} * m_floatsPerVertex) & mask;
+        while (m_slots[slot] != EmptySlot)
+        {
+            slot = (slot + 1) & mask;
+        }
+        m_slots[slot] = index;
+    }
+}
+
+} // namespace GameProgramming::Mesh
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "type.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace GameProgramming::Mesh
+{
+
+enum class IndexType : u32
+{
+    UnsignedShort = GL_UNSIGNED_SHORT,
+    UnsignedInt = GL_UNSIGNED_INT
+};
+
+// The narrowest index type that can address every vertex of a mesh with `vertexCount` vertices.
+[[nodiscard]] constexpr IndexType indexTypeFor(std::size_t vertexCount) noexcept
+{
+    return vertexCount <= std::size_t{std::numeric_limits<u16>::max()} + 1 ? IndexType::UnsignedShort : IndexType::UnsignedInt;
+}
+
+[[nodiscard]] constexpr u32 indexSize(IndexType type) noexcept
+{
+    return type == IndexType::UnsignedShort ? sizeof(u16) : sizeof(u32);
+}
+
+// Interleaved vertices plus a triangle list indexing them.
+struct IndexedMesh
+{
+    std::vector<float> vertices;
+    std::vector<u32> indices;
+    u32 floatsPerVertex = 0;
+
+    [[nodiscard]] u32 vertexCount() const noexcept { return floatsPerVertex ? static_cast<u32>(vertices.size() / floatsPerVertex) : 0; }
+    [[nodiscard]] u32 indexCount() const noexcept { return static_cast<u32>(indices.size()); }
+    [[nodiscard]] IndexType indexType() const noexcept { return indexTypeFor(vertexCount()); }
+
+    // Fills the currently bound GL_ARRAY_BUFFER.
+    void uploadVertexData(GLenum usage = GL_STATIC_DRAW) const noexcept;
+    // Fills the GL_ELEMENT_ARRAY_BUFFER bound to the current VAO, narrowing to 16-bit indices when they fit.
+    void uploadIndexData(GLenum usage = GL_STATIC_DRAW) const;
+};
+
+// Collects vertices one triangle corner at a time and welds bitwise identical ones through a hash table,
+// so shared corners are stored once and referenced by index.
+class MeshBuilder
+{
+public:
+    explicit MeshBuilder(u32 floatsPerVertex, std::size_t expectedVertices = 0);
+
+    // Appends one corner to the index list and returns its vertex index; reuses an identical vertex if one was added before.
+    u32 addVertex(std::span<const float> vertex);
+
+    [[nodiscard]] u32 vertexCount() const noexcept { return static_cast<u32>(m_vertices.size() / m_floatsPerVertex); }
+    [[nodiscard]] IndexedMesh build() &&;
+
+    // Welds an un-indexed triangle soup (`floatsPerVertex` floats per corner).
+    [[nodiscard]] static IndexedMesh weld(std::span<const float> vertices, u32 floatsPerVertex);
+
+private:
+    static constexpr u32 EmptySlot = std::numeric_limits<u32>::max();
+
+    [[nodiscard]] u64 hash(const float *vertex) const noexcept;
+    [[nodiscard]] bool equal(const float *a, const float *b) const noexcept;
+    void rehash(std::size_t slotCount);
+
+    u32 m_floatsPerVertex;
+    std::vector<float> m_vertices;
+    std::vector<u32> m_indices;
+    std::vector<u32> m_slots; // open addressing, power of two sized, holds vertex indices
+};
+
+} // namespace GameProgramming::Mesh
@@ -0,0 +1,234 @@
+#include "mesh_file.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace GameProgramming::Mesh
+{
+
+namespace
+{
+
+constexpr u64 PayloadAlignment = 16;
+
+constexpr u64 alignPayload(u64 offset) noexcept
+{
+    return (offset + PayloadAlignment - 1) / PayloadAlignment * PayloadAlignment;
+}
+
+// IEEE 754 binary32 -> binary16, round to nearest even
+u16 floatToHalf(float value) noexcept
+{
+    const u32 bits = std::bit_cast<u32>(value);
+    const u32 sign = (bits >> 16) & 0x8000u;
+    const u32 exponent = (bits >> 23) & 0xffu;
+    u32 mantissa = bits & 0x7fffffu;
+
+    if (exponent == 0xffu) // inf, nan
+        return static_cast<u16>(sign | 0x7c00u | (mantissa != 0 ? 0x200u : 0u));
+
+    const i32 halfExponent = static_cast<i32>(exponent) - 127 + 15;
+    if (halfExponent >= 0x1f) // overflow
+        return static_cast<u16>(sign | 0x7c00u);
+
+    u32 shift = 13;
+    u32 half = 0;
+    if (halfExponent <= 0) // subnormal or zero
+    {
+        if (halfExponent < -10)
+            return static_cast<u16>(sign);
+        mantissa |= 0x800000u;
+        shift = static_cast<u32>(14 - halfExponent);
+        half = mantissa >> shift;
+    }
+    else
+    {
+        half = (static_cast<u32>(halfExponent) << 10) | (mantissa >> shift);
+    }
+
+    const u32 remainder = mantissa & ((1u << shift) - 1u);
+    const u32 halfway = 1u << (shift - 1u);
+    if (remainder > halfway || (remainder == halfway && (half & 1u)))
+        ++half; // a carry into the exponent is the correct result
+
+    return static_cast<u16>(sign | half);
+}
+
+} // namespace
+
+MeshFile::MeshFile(const std::filesystem::path &path)
+    : m_file(path), m_header{}
+{
+    const std::string name = path.filename().string();
+    if (m_file.size() < sizeof(MeshFileHeader))
+    {
+        throw std::runtime_error{"Mesh file is too small: " + name};
+    }
+    std::memcpy(&m_header, m_file.data(), sizeof(MeshFileHeader));
+
+    if (std::memcmp(m_header.magic, MeshFileMagic, sizeof(MeshFileMagic)) != 0)
+    {
+        throw std::runtime_error{"Not a mesh file: " + name};
+    }
+    if (m_header.version != MeshFileVersion)
+    {
+        throw std::runtime_error{"Unsupported mesh file version " + std::to_string(m_header.version) + ": " + name};
+    }
+    if (m_header.attributeCount == 0 || m_header.attributeCount > MaxVertexAttributes ||
+        (m_header.componentType != ComponentType::Float && m_header.componentType != ComponentType::HalfFloat))
+    {
+        throw std::runtime_error{"Invalid vertex layout in mesh file: " + name};
+    }
+    if (static_cast<u64>(m_header.vertexCount) * m_header.vertexStride != m_header.payloadSize ||
+        m_header.payloadOffset < sizeof(MeshFileHeader) || m_header.payloadOffset + m_header.payloadSize > m_file.size())
+    {
+        throw std::runtime_error{"Truncated or corrupt mesh file: " + name};
+    }
+    if (m_header.indexCount != 0 &&
+        ((m_header.indexType != IndexType::UnsignedShort && m_header.indexType != IndexType::UnsignedInt) ||
+         static_cast<u64>(m_header.indexCount) * indexSize(m_header.indexType) != m_header.indexSize ||
+         m_header.indexOffset < m_header.payloadOffset + m_header.payloadSize || m_header.indexOffset + m_header.indexSize > m_file.size()))
+    {
+        throw std::runtime_error{"Truncated or corrupt index data in mesh file: " + name};
+    }
+    // without indices the header still places an empty index payload right after the padded vertex payload
+    if (m_header.indexCount == 0 &&
+        (m_header.indexSize != 0 || m_header.indexOffset != alignPayload(m_header.payloadOffset + m_header.payloadSize) ||
+         m_header.indexOffset > m_file.size()))
+    {
+        throw std::runtime_error{"Corrupt index header in mesh file without indices: " + name};
+    }
+    if (checksum(indexData(), indexDataSize(), checksum(vertexData(), vertexDataSize())) != m_header.checksum)
+    {
+        throw std::runtime_error{"Checksum mismatch in mesh file: " + name};
+    }
+}
+
+void MeshFile::uploadVertexData(GLenum usage) const noexcept
+{
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexDataSize()), vertexData(), usage);
+}
+
+void MeshFile::uploadIndexData(GLenum usage) const noexcept
+{
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indexDataSize()), indexData(), usage);
+}
+
+void MeshFile::setupVertexAttributes() const noexcept
+{
+    for (u32 i = 0; i < m_header.attributeCount; ++i)
+    {
+        const VertexAttribute &attribute = m_header.attributes[i];
+        glVertexAttribPointer(attribute.location, static_cast<GLint>(attribute.components), static_cast<GLenum>(m_header.componentType),
+                              GL_FALSE, static_cast<GLsizei>(m_header.vertexStride),
+                              reinterpret_cast<const void *>(static_cast<std::uintptr_t>(attribute.offset)));
+        glEnableVertexAttribArray(attribute.location);
+    }
+}
+
+void MeshFile::write(const std::filesystem::path &path, std::span<const float> vertices, std::span<const u32> indices,
+                     std::span<const u32> components, ComponentType componentType)
+{
+    if (components.empty() || components.size() > MaxVertexAttributes)
+    {
+        throw std::invalid_argument{"Mesh files hold 1 to " + std::to_string(MaxVertexAttributes) + " vertex attributes"};
+    }
+
+    const u32 componentSize = componentType == ComponentType::HalfFloat ? sizeof(u16) : sizeof(float);
+    MeshFileHeader header{};
+    std::memcpy(header.magic, MeshFileMagic, sizeof(MeshFileMagic));
+    header.version = MeshFileVersion;
+    header.componentType = componentType;
+    header.attributeCount = static_cast<u32>(components.size());
+
+    u32 floatsPerVertex = 0;
+    for (u32 i = 0; i < header.attributeCount; ++i)
+    {
+        header.attributes[i] = {.location = i, .components = components[i], .offset = floatsPerVertex * componentSize};
+        floatsPerVertex += components[i];
+    }
+    if (floatsPerVertex == 0 || vertices.size() % floatsPerVertex != 0)
+    {
+        throw std::invalid_argument{"Vertex data is not a whole number of vertices"};
+    }
+    header.vertexCount = static_cast<u32>(vertices.size() / floatsPerVertex);
+    header.vertexStride = floatsPerVertex * componentSize;
+
+    std::vector<std::byte> payload(vertices.size() * componentSize);
+    if (componentType == ComponentType::HalfFloat)
+    {
+        for (std::size_t i = 0; i < vertices.size(); ++i)
+        {
+            const u16 half = floatToHalf(vertices[i]);
+            std::memcpy(payload.data() + i * sizeof(u16), &half, sizeof(u16));
+        }
+    }
+    else
+    {
+        std::memcpy(payload.data(), vertices.data(), payload.size());
+    }
+
+    if (indices.size() % 3 != 0)
+    {
+        throw std::invalid_argument{"Index data is not a whole number of triangles"};
+    }
+    header.indexCount = static_cast<u32>(indices.size());
+    header.indexType = indexTypeFor(header.vertexCount);
+    std::vector<std::byte> indexPayload(indices.size() * indexSize(header.indexType));
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+        if (indices[i] >= header.vertexCount)
+        {
+            throw std::invalid_argument{"Index " + std::to_string(indices[i]) + " is out of range"};
+        }
+        if (header.indexType == IndexType::UnsignedShort)
+        {
+            const u16 index = static_cast<u16>(indices[i]);
+            std::memcpy(indexPayload.data() + i * sizeof(u16), &index, sizeof(u16));
+        }
+        else
+        {
+            std::memcpy(indexPayload.data() + i * sizeof(u32), &indices[i], sizeof(u32));
+        }
+    }
+
+    header.payloadOffset = alignPayload(sizeof(MeshFileHeader));
+    header.payloadSize = payload.size();
+    header.indexOffset = alignPayload(header.payloadOffset + header.payloadSize);
+    header.indexSize = indexPayload.size();
+    header.checksum = checksum(indexPayload.data(), indexPayload.size(), checksum(payload.data(), payload.size()));
+
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    if (!out.is_open())
+    {
+        throw std::runtime_error{"Failed to open mesh file for writing: " + path.string()};
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    const std::vector<char> padding(PayloadAlignment, '\0');
+    out.write(padding.data(), static_cast<std::streamsize>(header.payloadOffset - sizeof(header)));
+    out.write(reinterpret_cast<const char *>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    out.write(padding.data(), static_cast<std::streamsize>(header.indexOffset - header.payloadOffset - header.payloadSize));
+    out.write(reinterpret_cast<const char *>(indexPayload.data()), static_cast<std::streamsize>(indexPayload.size()));
+    if (!out)
+    {
+        throw std::runtime_error{"Failed to write mesh file: " + path.string()};
+    }
+}
+
+u64 MeshFile::checksum(const std::byte *data, std::size_t size, u64 seed) noexcept
+{
+    u64 hash = seed;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<u64>(data[i]);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+} // namespace GameProgramming::Mesh
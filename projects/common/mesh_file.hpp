@@ -0,0 +1,93 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "mapped_file.hpp"
+#include "mesh_builder.hpp"
+#include "type.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <type_traits>
+
+namespace GameProgramming::Mesh
+{
+
+// Binary mesh container (little endian):
+//   MeshFileHeader | padding up to payloadOffset | vertex payload (vertexCount * vertexStride bytes)
+//                  | padding up to indexOffset | index payload (indexCount 16- or 32-bit indices, optional)
+// Both payloads are laid out exactly as the VBO/IBO expect them, so they are uploaded straight from the mapping.
+inline constexpr char MeshFileMagic[4] = {'G', 'P', 'M', 'F'};
+inline constexpr u32 MeshFileVersion = 2;
+inline constexpr u32 MaxVertexAttributes = 8;
+
+enum class ComponentType : u32
+{
+    Float = GL_FLOAT,
+    HalfFloat = GL_HALF_FLOAT
+};
+
+struct VertexAttribute
+{
+    u32 location;
+    u32 components;
+    u32 offset; // byte offset inside a vertex
+};
+
+struct MeshFileHeader
+{
+    char magic[4];
+    u32 version;
+    u32 vertexCount;
+    u32 vertexStride; // bytes per vertex
+    ComponentType componentType;
+    u32 attributeCount;
+    VertexAttribute attributes[MaxVertexAttributes];
+    u32 indexCount; // 0 for a non-indexed triangle list
+    IndexType indexType;
+    u64 payloadOffset;
+    u64 payloadSize;
+    u64 indexOffset;
+    u64 indexSize;
+    u64 checksum; // FNV-1a 64 of the vertex payload followed by the index payload
+};
+static_assert(std::is_standard_layout_v<MeshFileHeader> && std::is_trivially_copyable_v<MeshFileHeader>);
+static_assert(sizeof(MeshFileHeader) == 168, "MeshFileHeader is part of the on-disk format");
+
+class MeshFile
+{
+public:
+    static constexpr u64 ChecksumSeed = 0xcbf29ce484222325ull; // FNV-1a 64 offset basis
+
+    explicit MeshFile(const std::filesystem::path &path);
+
+    [[nodiscard]] const MeshFileHeader &header() const noexcept { return m_header; }
+    [[nodiscard]] u32 vertexCount() const noexcept { return m_header.vertexCount; }
+    [[nodiscard]] const std::byte *vertexData() const noexcept { return m_file.data() + m_header.payloadOffset; }
+    [[nodiscard]] std::size_t vertexDataSize() const noexcept { return m_header.payloadSize; }
+    [[nodiscard]] bool indexed() const noexcept { return m_header.indexCount != 0; }
+    [[nodiscard]] u32 indexCount() const noexcept { return m_header.indexCount; }
+    [[nodiscard]] IndexType indexType() const noexcept { return m_header.indexType; }
+    [[nodiscard]] const std::byte *indexData() const noexcept { return m_file.data() + m_header.indexOffset; }
+    [[nodiscard]] std::size_t indexDataSize() const noexcept { return m_header.indexSize; }
+
+    // Fills the currently bound GL_ARRAY_BUFFER directly from the mapped file.
+    void uploadVertexData(GLenum usage = GL_STATIC_DRAW) const noexcept;
+    // Fills the GL_ELEMENT_ARRAY_BUFFER bound to the current VAO directly from the mapped file.
+    void uploadIndexData(GLenum usage = GL_STATIC_DRAW) const noexcept;
+    // Describes the vertex layout to the currently bound VAO (the VBO must be bound to GL_ARRAY_BUFFER).
+    void setupVertexAttributes() const noexcept;
+
+    // Writes interleaved float vertices and an optional triangle list (empty `indices` keeps the mesh non-indexed);
+    // `components` lists the float count of attribute 0, 1, 2, ... Indices are stored as 16 bits when they fit.
+    static void write(const std::filesystem::path &path, std::span<const float> vertices, std::span<const u32> indices,
+                      std::span<const u32> components, ComponentType componentType = ComponentType::Float);
+    [[nodiscard]] static u64 checksum(const std::byte *data, std::size_t size, u64 seed = ChecksumSeed) noexcept;
+
+private:
+    Utility::MappedFile m_file;
+    MeshFileHeader m_header;
+};
+
+} // namespace GameProgramming::Mesh
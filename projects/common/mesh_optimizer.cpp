@@ -0,0 +1,279 @@
+#include "mesh_optimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace GameProgramming::Mesh
+{
+
+namespace
+{
+
+constexpr u32 InvalidIndex = std::numeric_limits<u32>::max();
+
+// scoring constants from the original article
+constexpr u32 ScoringCacheSize = 32;
+constexpr float CacheDecayPower = 1.5f;
+constexpr float LastTriangleScore = 0.75f;
+constexpr float ValenceBoostScale = 2.0f;
+constexpr float ValenceBoostPower = 0.5f;
+constexpr u32 MaxValence = 32;
+
+struct ScoreTables
+{
+    float cache[ScoringCacheSize];
+    float valence[MaxValence + 1];
+
+    ScoreTables() noexcept
+    {
+        for (u32 i = 0; i < ScoringCacheSize; ++i)
+        {
+            if (i < 3)
+            {
+                // the three vertices of the last triangle get a fixed score so it is not picked again straight away
+                cache[i] = LastTriangleScore;
+            }
+            else
+            {
+                const float scaler = 1.0f / static_cast<float>(ScoringCacheSize - 3);
+                cache[i] = std::pow(1.0f - static_cast<float>(i - 3) * scaler, CacheDecayPower);
+            }
+        }
+        valence[0] = 0.0f;
+        for (u32 i = 1; i <= MaxValence; ++i)
+        {
+            valence[i] = ValenceBoostScale * std::pow(static_cast<float>(i), -ValenceBoostPower);
+        }
+    }
+};
+
+float vertexScore(const ScoreTables &tables, i32 cachePosition, u32 liveTriangles) noexcept
+{
+    if (liveTriangles == 0)
+        return -1.0f; // no triangle needs this vertex anymore
+
+    const float cacheScore = cachePosition < 0 ? 0.0f : tables.cache[cachePosition];
+    return cacheScore + tables.valence[std::min(liveTriangles, MaxValence)];
+}
+
+void validateIndices(std::span<const u32> indices, u32 vertexCount)
+{
+    if (indices.size() % 3 != 0)
+    {
+        throw std::invalid_argument{"Index data is not a whole number of triangles"};
+    }
+    for (u32 index : indices)
+    {
+        if (index >= vertexCount)
+        {
+            throw std::invalid_argument{"Index " + std::to_string(index) + " is out of range"};
+        }
+    }
+}
+
+} // namespace
+
+VertexCacheStatistics analyzeVertexCache(std::span<const u32> indices, u32 vertexCount, u32 cacheSize)
+{
+    validateIndices(indices, vertexCount);
+
+    // FIFO cache: a hit does not refresh the entry, which is how fixed-function post-transform caches behave
+    std::vector<u32> cacheTimestamps(vertexCount, 0);
+    u32 time = cacheSize + 1;
+
+    VertexCacheStatistics statistics;
+    for (u32 index : indices)
+    {
+        if (time - cacheTimestamps[index] > cacheSize)
+        {
+            cacheTimestamps[index] = time++;
+            ++statistics.vertexTransforms;
+        }
+    }
+
+    const std::size_t triangleCount = indices.size() / 3;
+    statistics.acmr = triangleCount ? static_cast<float>(statistics.vertexTransforms) / static_cast<float>(triangleCount) : 0.0f;
+    statistics.atvr = vertexCount ? static_cast<float>(statistics.vertexTransforms) / static_cast<float>(vertexCount) : 0.0f;
+    return statistics;
+}
+
+void optimizeVertexCache(std::vector<u32> &indices, u32 vertexCount)
+{
+    validateIndices(indices, vertexCount);
+    const u32 triangleCount = static_cast<u32>(indices.size() / 3);
+    if (triangleCount == 0)
+        return;
+
+    static const ScoreTables tables;
+
+    // vertex -> triangles adjacency, stored as one flat list
+    std::vector<u32> liveTriangles(vertexCount, 0);
+    for (u32 index : indices)
+    {
+        ++liveTriangles[index];
+    }
+    std::vector<u32> adjacencyOffsets(vertexCount + 1, 0);
+    for (u32 v = 0; v < vertexCount; ++v)
+    {
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+    }
+    std::vector<u32> adjacency(indices.size());
+    {
+        std::vector<u32> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (u32 t = 0; t < triangleCount; ++t)
+        {
+            for (u32 k = 0; k < 3; ++k)
+            {
+                adjacency[fill[indices[t * 3 + k]]++] = t;
+            }
+        }
+    }
+
+    std::vector<i32> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (u32 v = 0; v < vertexCount; ++v)
+    {
+        vertexScores[v] = vertexScore(tables, -1, liveTriangles[v]);
+    }
+
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    for (u32 t = 0; t < triangleCount; ++t)
+    {
+        triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+    }
+
+    std::vector<u32> output;
+    output.reserve(indices.size());
+
+    // LRU cache of the last emitted vertices; 3 extra slots hold the vertices pushed out by the newest triangle
+    u32 cache[ScoringCacheSize + 3];
+    u32 cacheCount = 0;
+
+    u32 bestTriangle = static_cast<u32>(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin());
+    u32 fallbackCursor = 0;
+
+    for (u32 emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+    {
+        if (bestTriangle == InvalidIndex)
+        {
+            // nothing in the cache touches a live triangle any more, continue with the first one left
+            while (emitted[fallbackCursor])
+            {
+                ++fallbackCursor;
+            }
+            bestTriangle = fallbackCursor;
+        }
+
+        const u32 *corners = &indices[bestTriangle * 3];
+        output.insert(output.end(), corners, corners + 3);
+        emitted[bestTriangle] = true;
+
+        // move the triangle's vertices to the front of the cache
+        u32 newCache[ScoringCacheSize + 3];
+        u32 newCount = 0;
+        for (u32 k = 0; k < 3; ++k)
+        {
+            if (std::find(newCache, newCache + newCount, corners[k]) == newCache + newCount)
+            {
+                newCache[newCount++] = corners[k]; // degenerate triangles repeat a corner
+            }
+        }
+        for (u32 i = 0; i < cacheCount; ++i)
+        {
+            const u32 v = cache[i];
+            if (v != corners[0] && v != corners[1] && v != corners[2])
+            {
+                newCache[newCount++] = v;
+            }
+        }
+
+        // the triangle is done: drop it from its vertices' adjacency
+        for (u32 k = 0; k < 3; ++k)
+        {
+            const u32 v = corners[k];
+            u32 *begin = adjacency.data() + adjacencyOffsets[v];
+            u32 *end = begin + liveTriangles[v];
+            std::iter_swap(std::find(begin, end, bestTriangle), end - 1);
+            --liveTriangles[v];
+        }
+
+        // rescore everything that was or is in the cache
+        for (u32 i = 0; i < newCount; ++i)
+        {
+            const u32 v = newCache[i];
+            cachePosition[v] = i < ScoringCacheSize ? static_cast<i32>(i) : -1;
+
+            const float score = vertexScore(tables, cachePosition[v], liveTriangles[v]);
+            const float delta = score - vertexScores[v];
+            vertexScores[v] = score;
+
+            const u32 *begin = adjacency.data() + adjacencyOffsets[v];
+            for (const u32 *t = begin; t != begin + liveTriangles[v]; ++t)
+            {
+                triangleScores[*t] += delta;
+            }
+        }
+
+        // the next triangle is the best one touching the cache
+        bestTriangle = InvalidIndex;
+        float bestScore = -1.0f;
+        for (u32 i = 0; i < std::min(newCount, ScoringCacheSize); ++i)
+        {
+            const u32 v = newCache[i];
+            const u32 *begin = adjacency.data() + adjacencyOffsets[v];
+            for (const u32 *t = begin; t != begin + liveTriangles[v]; ++t)
+            {
+                if (triangleScores[*t] > bestScore)
+                {
+                    bestScore = triangleScores[*t];
+                    bestTriangle = *t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, ScoringCacheSize);
+        std::copy(newCache, newCache + cacheCount, cache);
+    }
+
+    indices = std::move(output);
+}
+
+void optimizeVertexFetch(IndexedMesh &mesh)
+{
+    const u32 vertexCount = mesh.vertexCount();
+    validateIndices(mesh.indices, vertexCount);
+
+    std::vector<u32> remap(vertexCount, InvalidIndex);
+    u32 nextVertex = 0;
+    for (u32 &index : mesh.indices)
+    {
+        if (remap[index] == InvalidIndex)
+        {
+            remap[index] = nextVertex++;
+        }
+        index = remap[index];
+    }
+
+    const u32 stride = mesh.floatsPerVertex;
+    std::vector<float> vertices(std::size_t{nextVertex} * stride);
+    for (u32 v = 0; v < vertexCount; ++v)
+    {
+        if (remap[v] != InvalidIndex)
+        {
+            std::copy_n(mesh.vertices.begin() + std::size_t{v} * stride, stride, vertices.begin() + std::size_t{remap[v]} * stride);
+        }
+    }
+    mesh.vertices = std::move(vertices);
+}
+
+void optimizeMesh(IndexedMesh &mesh)
+{
+    optimizeVertexCache(mesh.indices, mesh.vertexCount());
+    optimizeVertexFetch(mesh);
+}
+
+} // namespace GameProgramming::Mesh
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "mesh_builder.hpp"
+#include "type.hpp"
+
+#include <span>
+#include <vector>
+
+namespace GameProgramming::Mesh
+{
+
+// Post-transform cache behaviour of a triangle list, simulated on a FIFO cache.
+struct VertexCacheStatistics
+{
+    u32 vertexTransforms = 0; // cache misses, i.e. vertex shader invocations
+    float acmr = 0.0f;        // average cache miss ratio: transforms per triangle (0.5 is the ideal for a large regular grid, 3 is a soup)
+    float atvr = 0.0f;        // average transform to vertex ratio: transforms per vertex (1 is the ideal)
+};
+
+inline constexpr u32 DefaultVertexCacheSize = 16;
+
+[[nodiscard]] VertexCacheStatistics analyzeVertexCache(std::span<const u32> indices, u32 vertexCount,
+                                                       u32 cacheSize = DefaultVertexCacheSize);
+
+// Reorders the triangles of an indexed triangle list for post-transform cache reuse
+// (Forsyth, "Linear-Speed Vertex Cache Optimisation"). The triangles themselves and their winding are unchanged.
+void optimizeVertexCache(std::vector<u32> &indices, u32 vertexCount);
+
+// Renumbers the vertices in the order the index buffer first references them, so vertex fetch walks the
+// VBO front to back. Vertices no triangle refers to are dropped. Run it after optimizeVertexCache.
+void optimizeVertexFetch(IndexedMesh &mesh);
+
+// Both passes, in the right order.
+void optimizeMesh(IndexedMesh &mesh);
+
+} // namespace GameProgramming::Mesh
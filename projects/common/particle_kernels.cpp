@@ -0,0 +1,351 @@
+#include "particle_kernels.hpp"
+
+#include "cpu_features.hpp"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PARTICLE_KERNELS_AVX2 1
+#include <immintrin.h>
+#else
+#define PARTICLE_KERNELS_AVX2 0
+#endif
+
+// MSVC compiles any intrinsic as asked; GCC and Clang only inside functions built for the instruction set.
+// The helpers are forced inline so their vectors stay in registers across the batch loops.
+#if PARTICLE_KERNELS_AVX2 && (defined(__GNUC__) || defined(__clang__))
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+#define AVX2_INLINE __attribute__((target("avx2,fma"), always_inline)) inline
+#elif defined(_MSC_VER)
+#define AVX2_TARGET
+#define AVX2_INLINE __forceinline
+#else
+#define AVX2_TARGET
+#define AVX2_INLINE inline
+#endif
+
+namespace GameProgramming::Particle
+{
+
+namespace
+{
+
+u32 packColor(float r, float g, float b) noexcept
+{
+    const auto channel = [](float value) { return static_cast<u32>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+    return channel(r) | channel(g) << 8 | channel(b) << 16;
+}
+
+void spawnScalar(const ParticleStreams &slots, u32 count, const Shot &shot, ThreadRandom &random) noexcept
+{
+    Utility::Xoshiro128 &generator = random.scalar;
+    for (u32 i = 0; i < count; ++i)
+    {
+        slots.positionX[i] = shot.origin.x;
+        slots.positionY[i] = shot.origin.y;
+        slots.positionZ[i] = shot.origin.z;
+        slots.velocityX[i] = generator.gauss(shot.velocity.x, shot.velocityDeviation);
+        slots.velocityY[i] = generator.gauss(shot.velocity.y, shot.velocityDeviation);
+        slots.velocityZ[i] = generator.gauss(shot.velocity.z, shot.velocityDeviation);
+        slots.age[i] = 0.0f;
+        slots.lifetime[i] = shot.lifetime;
+        slots.color[i] = packColor(shot.color.r + generator.uniform(-shot.colorJitter, shot.colorJitter),
+                                   shot.color.g + generator.uniform(-shot.colorJitter, shot.colorJitter),
+                                   shot.color.b + generator.uniform(-shot.colorJitter, shot.colorJitter));
+    }
+}
+
+void integrateScalar(const ParticleStreams &slots, u32 count, float deltaTime, const glm::vec3 &gravity, float drag,
+                     ParticleVertex *vertices) noexcept
+{
+    float *px = slots.positionX;
+    float *py = slots.positionY;
+    float *pz = slots.positionZ;
+    float *vx = slots.velocityX;
+    float *vy = slots.velocityY;
+    float *vz = slots.velocityZ;
+    float *age = slots.age;
+    const float *lifetime = slots.lifetime;
+    const u32 *color = slots.color;
+
+    // no branches: dead particles take a zero step and come out fully transparent
+    for (u32 i = 0; i < count; ++i)
+    {
+        const float step = age[i] < lifetime[i] ? deltaTime : 0.0f;
+        vx[i] += (gravity.x - drag * vx[i]) * step;
+        vy[i] += (gravity.y - drag * vy[i]) * step;
+        vz[i] += (gravity.z - drag * vz[i]) * step;
+        px[i] += vx[i] * step;
+        py[i] += vy[i] * step;
+        pz[i] += vz[i] * step;
+        age[i] += step;
+
+        const float alpha = std::max(1.0f - age[i] / lifetime[i], 0.0f);
+        vertices[i].position = glm::vec3(px[i], py[i], pz[i]);
+        vertices[i].color = color[i] | static_cast<u32>(alpha * 255.0f + 0.5f) << 24;
+    }
+}
+
+constexpr Kernels ScalarKernels{"scalar", &spawnScalar, &integrateScalar};
+
+#if PARTICLE_KERNELS_AVX2
+
+ParticleStreams advance(const ParticleStreams &slots, u32 count) noexcept
+{
+    return {slots.positionX + count, slots.positionY + count, slots.positionZ + count, slots.velocityX + count, slots.velocityY + count,
+            slots.velocityZ + count, slots.age + count,       slots.lifetime + count,  slots.color + count};
+}
+
+// xoshiro128+ on 8 lanes at once, the same steps as Utility::Xoshiro128::next
+struct Lanes
+{
+    __m256i s0, s1, s2, s3;
+};
+
+AVX2_INLINE Lanes loadLanes(const Utility::Xoshiro128x8 &generator) noexcept
+{
+    return {_mm256_load_si256(reinterpret_cast<const __m256i *>(generator.state[0])),
+            _mm256_load_si256(reinterpret_cast<const __m256i *>(generator.state[1])),
+            _mm256_load_si256(reinterpret_cast<const __m256i *>(generator.state[2])),
+            _mm256_load_si256(reinterpret_cast<const __m256i *>(generator.state[3]))};
+}
+
+AVX2_INLINE void storeLanes(const Lanes &lanes, Utility::Xoshiro128x8 &generator) noexcept
+{
+    _mm256_store_si256(reinterpret_cast<__m256i *>(generator.state[0]), lanes.s0);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(generator.state[1]), lanes.s1);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(generator.state[2]), lanes.s2);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(generator.state[3]), lanes.s3);
+}
+
+AVX2_INLINE __m256i next(Lanes &lanes) noexcept
+{
+    const __m256i result = _mm256_add_epi32(lanes.s0, lanes.s3);
+    const __m256i t = _mm256_slli_epi32(lanes.s1, 9);
+    lanes.s2 = _mm256_xor_si256(lanes.s2, lanes.s0);
+    lanes.s3 = _mm256_xor_si256(lanes.s3, lanes.s1);
+    lanes.s1 = _mm256_xor_si256(lanes.s1, lanes.s2);
+    lanes.s0 = _mm256_xor_si256(lanes.s0, lanes.s3);
+    lanes.s2 = _mm256_xor_si256(lanes.s2, t);
+    lanes.s3 = _mm256_or_si256(_mm256_slli_epi32(lanes.s3, 11), _mm256_srli_epi32(lanes.s3, 21));
+    return result;
+}
+
+// [0, 1) from the upper 24 bits, as Xoshiro128::uniform
+AVX2_INLINE __m256 uniform(Lanes &lanes) noexcept
+{
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(next(lanes), 8)), _mm256_set1_ps(0x1p-24f));
+}
+
+// natural logarithm of x > 0: exponent plus a polynomial on the mantissa (Cephes logf, ~1 ulp)
+AVX2_INLINE __m256 logarithm(__m256 x) noexcept
+{
+    const __m256i bits = _mm256_castps_si256(x);
+    __m256 exponent = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+    // mantissa in [0.5, 1)
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f000000)));
+
+    // below sqrt(1/2), take m in [sqrt(1/2), sqrt(2)) instead so the polynomial stays near 0
+    const __m256 small = _mm256_cmp_ps(m, _mm256_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+    exponent = _mm256_sub_ps(exponent, _mm256_and_ps(small, _mm256_set1_ps(1.0f)));
+    m = _mm256_sub_ps(_mm256_add_ps(m, _mm256_and_ps(small, m)), _mm256_set1_ps(1.0f));
+
+    const __m256 z = _mm256_mul_ps(m, m);
+    __m256 y = _mm256_set1_ps(7.0376836292e-2f);
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.1514610310e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(1.1676998740e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.2420140846e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(1.4249322787e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.6668057665e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(2.0000714765e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-2.4999993993e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(3.3333331174e-1f));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, m), z);
+    y = _mm256_fmadd_ps(exponent, _mm256_set1_ps(-2.12194440e-4f), y);
+    y = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), y);
+    return _mm256_fmadd_ps(exponent, _mm256_set1_ps(0.693359375f), _mm256_add_ps(m, y));
+}
+
+// Two independent standard normals per lane (Box-Muller). The angle is a random quadrant plus a uniform
+// offset in [-pi/4, pi/4), where the sine and cosine polynomials (Cephes) need no further range reduction.
+AVX2_INLINE void gauss(Lanes &lanes, __m256 &first, __m256 &second) noexcept
+{
+    // (0, 1]: log(0) is not an option
+    const __m256 u = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_srli_epi32(next(lanes), 8), _mm256_set1_epi32(1))),
+                                   _mm256_set1_ps(0x1p-24f));
+    const __m256 radius = _mm256_sqrt_ps(_mm256_mul_ps(_mm256_set1_ps(-2.0f), logarithm(u)));
+
+    const __m256i bits = next(lanes);
+    const __m256i quadrant = _mm256_srli_epi32(bits, 30);
+    const __m256 offset = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(bits, 8), _mm256_set1_epi32(0x3fffff)));
+    const __m256 a = _mm256_fmsub_ps(offset, _mm256_set1_ps(1.57079632679f * 0x1p-22f), _mm256_set1_ps(0.78539816339f));
+
+    const __m256 z = _mm256_mul_ps(a, a);
+    __m256 sine = _mm256_set1_ps(-1.9515295891e-4f);
+    sine = _mm256_fmadd_ps(sine, z, _mm256_set1_ps(8.3321608736e-3f));
+    sine = _mm256_fmadd_ps(sine, z, _mm256_set1_ps(-1.6666654611e-1f));
+    sine = _mm256_fmadd_ps(_mm256_mul_ps(sine, z), a, a);
+    __m256 cosine = _mm256_set1_ps(2.443315711809948e-5f);
+    cosine = _mm256_fmadd_ps(cosine, z, _mm256_set1_ps(-1.388731625493765e-3f));
+    cosine = _mm256_fmadd_ps(cosine, z, _mm256_set1_ps(4.166664568298827e-2f));
+    cosine = _mm256_fmadd_ps(_mm256_mul_ps(cosine, z), z, _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), _mm256_set1_ps(1.0f)));
+
+    // rotate by the quadrant: (c, s), (-s, c), (-c, -s), (s, -c)
+    const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+    const __m256 x = _mm256_blendv_ps(cosine, sine, swap);
+    const __m256 y = _mm256_blendv_ps(sine, cosine, swap);
+    const __m256i signX = _mm256_slli_epi32(_mm256_xor_si256(quadrant, _mm256_srli_epi32(quadrant, 1)), 31);
+    const __m256i signY = _mm256_slli_epi32(_mm256_srli_epi32(quadrant, 1), 31);
+    first = _mm256_mul_ps(radius, _mm256_xor_ps(x, _mm256_castsi256_ps(signX)));
+    second = _mm256_mul_ps(radius, _mm256_xor_ps(y, _mm256_castsi256_ps(signY)));
+}
+
+// one RGB8 channel: base +- jitter, clamped, rounded
+AVX2_INLINE __m256i colorChannel(Lanes &lanes, float base, float jitter) noexcept
+{
+    __m256 value = _mm256_fmadd_ps(uniform(lanes), _mm256_set1_ps(2.0f * jitter), _mm256_set1_ps(base - jitter));
+    value = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+    return _mm256_cvttps_epi32(_mm256_fmadd_ps(value, _mm256_set1_ps(255.0f), _mm256_set1_ps(0.5f)));
+}
+
+// The AVX2 loops do whole batches of 8 and return how many particles that was; the tails are left to the
+// scalar kernels, called from plain functions so no SSE code runs with the upper ymm halves dirty.
+AVX2_TARGET u32 spawnBatches(const ParticleStreams &slots, u32 count, const Shot &shot, ThreadRandom &random) noexcept
+{
+    Lanes lanes = loadLanes(random.lanes);
+    const __m256 deviation = _mm256_set1_ps(shot.velocityDeviation);
+    // Box-Muller gives normals in pairs, three per particle are needed: every other batch uses a spare
+    __m256 spare = _mm256_setzero_ps();
+    bool haveSpare = false;
+
+    u32 i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 nx, ny, nz;
+        gauss(lanes, nx, ny);
+        if (haveSpare)
+            nz = spare;
+        else
+            gauss(lanes, nz, spare);
+        haveSpare = !haveSpare;
+
+        _mm256_storeu_ps(slots.positionX + i, _mm256_set1_ps(shot.origin.x));
+        _mm256_storeu_ps(slots.positionY + i, _mm256_set1_ps(shot.origin.y));
+        _mm256_storeu_ps(slots.positionZ + i, _mm256_set1_ps(shot.origin.z));
+        _mm256_storeu_ps(slots.velocityX + i, _mm256_fmadd_ps(nx, deviation, _mm256_set1_ps(shot.velocity.x)));
+        _mm256_storeu_ps(slots.velocityY + i, _mm256_fmadd_ps(ny, deviation, _mm256_set1_ps(shot.velocity.y)));
+        _mm256_storeu_ps(slots.velocityZ + i, _mm256_fmadd_ps(nz, deviation, _mm256_set1_ps(shot.velocity.z)));
+        _mm256_storeu_ps(slots.age + i, _mm256_setzero_ps());
+        _mm256_storeu_ps(slots.lifetime + i, _mm256_set1_ps(shot.lifetime));
+
+        const __m256i r = colorChannel(lanes, shot.color.r, shot.colorJitter);
+        const __m256i g = colorChannel(lanes, shot.color.g, shot.colorJitter);
+        const __m256i b = colorChannel(lanes, shot.color.b, shot.colorJitter);
+        const __m256i color = _mm256_or_si256(r, _mm256_or_si256(_mm256_slli_epi32(g, 8), _mm256_slli_epi32(b, 16)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(slots.color + i), color);
+    }
+    storeLanes(lanes, random.lanes);
+    return i;
+}
+
+AVX2_TARGET u32 integrateBatches(const ParticleStreams &slots, u32 count, float deltaTime, const glm::vec3 &gravity, float drag,
+                                 ParticleVertex *vertices) noexcept
+{
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    const __m256 gx = _mm256_set1_ps(gravity.x);
+    const __m256 gy = _mm256_set1_ps(gravity.y);
+    const __m256 gz = _mm256_set1_ps(gravity.z);
+    const __m256 k = _mm256_set1_ps(drag);
+
+    u32 i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 age = _mm256_loadu_ps(slots.age + i);
+        const __m256 lifetime = _mm256_loadu_ps(slots.lifetime + i);
+        const __m256 step = _mm256_and_ps(_mm256_cmp_ps(age, lifetime, _CMP_LT_OQ), dt);
+
+        // v += (g - drag v) step, p += v step
+        __m256 vx = _mm256_loadu_ps(slots.velocityX + i);
+        __m256 vy = _mm256_loadu_ps(slots.velocityY + i);
+        __m256 vz = _mm256_loadu_ps(slots.velocityZ + i);
+        vx = _mm256_fmadd_ps(_mm256_fnmadd_ps(k, vx, gx), step, vx);
+        vy = _mm256_fmadd_ps(_mm256_fnmadd_ps(k, vy, gy), step, vy);
+        vz = _mm256_fmadd_ps(_mm256_fnmadd_ps(k, vz, gz), step, vz);
+        const __m256 px = _mm256_fmadd_ps(vx, step, _mm256_loadu_ps(slots.positionX + i));
+        const __m256 py = _mm256_fmadd_ps(vy, step, _mm256_loadu_ps(slots.positionY + i));
+        const __m256 pz = _mm256_fmadd_ps(vz, step, _mm256_loadu_ps(slots.positionZ + i));
+        age = _mm256_add_ps(age, step);
+
+        _mm256_storeu_ps(slots.velocityX + i, vx);
+        _mm256_storeu_ps(slots.velocityY + i, vy);
+        _mm256_storeu_ps(slots.velocityZ + i, vz);
+        _mm256_storeu_ps(slots.positionX + i, px);
+        _mm256_storeu_ps(slots.positionY + i, py);
+        _mm256_storeu_ps(slots.positionZ + i, pz);
+        _mm256_storeu_ps(slots.age + i, age);
+
+        const __m256 alpha = _mm256_max_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_div_ps(age, lifetime)), _mm256_setzero_ps());
+        const __m256i alphaByte = _mm256_cvttps_epi32(_mm256_fmadd_ps(alpha, _mm256_set1_ps(255.0f), _mm256_set1_ps(0.5f)));
+        const __m256i color = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(slots.color + i)),
+                                              _mm256_slli_epi32(alphaByte, 24));
+
+        // 8 x (x, y, z, color) from the four streams: a 4x8 transpose, then two vertices per store
+        const __m256 c = _mm256_castsi256_ps(color);
+        const __m256 xy0 = _mm256_unpacklo_ps(px, py); // x0 y0 x1 y1 | x4 y4 x5 y5
+        const __m256 xy1 = _mm256_unpackhi_ps(px, py); // x2 y2 x3 y3 | x6 y6 x7 y7
+        const __m256 zc0 = _mm256_unpacklo_ps(pz, c);
+        const __m256 zc1 = _mm256_unpackhi_ps(pz, c);
+        const __m256 v04 = _mm256_shuffle_ps(xy0, zc0, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 v15 = _mm256_shuffle_ps(xy0, zc0, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 v26 = _mm256_shuffle_ps(xy1, zc1, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 v37 = _mm256_shuffle_ps(xy1, zc1, _MM_SHUFFLE(3, 2, 3, 2));
+        float *out = reinterpret_cast<float *>(vertices + i);
+        _mm256_storeu_ps(out + 0, _mm256_permute2f128_ps(v04, v15, 0x20));
+        _mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(v26, v37, 0x20));
+        _mm256_storeu_ps(out + 16, _mm256_permute2f128_ps(v04, v15, 0x31));
+        _mm256_storeu_ps(out + 24, _mm256_permute2f128_ps(v26, v37, 0x31));
+    }
+
+    return i;
+}
+
+void spawnAvx2(const ParticleStreams &slots, u32 count, const Shot &shot, ThreadRandom &random) noexcept
+{
+    const u32 done = spawnBatches(slots, count, shot, random);
+    spawnScalar(advance(slots, done), count - done, shot, random);
+}
+
+void integrateAvx2(const ParticleStreams &slots, u32 count, float deltaTime, const glm::vec3 &gravity, float drag,
+                   ParticleVertex *vertices) noexcept
+{
+    const u32 done = integrateBatches(slots, count, deltaTime, gravity, drag, vertices);
+    integrateScalar(advance(slots, done), count - done, deltaTime, gravity, drag, vertices + done);
+}
+
+constexpr Kernels Avx2Kernels{"avx2", &spawnAvx2, &integrateAvx2};
+
+#endif
+
+} // namespace
+
+const Kernels &scalarKernels() noexcept
+{
+    return ScalarKernels;
+}
+
+const Kernels *avx2Kernels() noexcept
+{
+#if PARTICLE_KERNELS_AVX2
+    return Utility::cpuHasAvx2() ? &Avx2Kernels : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+const Kernels &bestKernels() noexcept
+{
+    const Kernels *avx2 = avx2Kernels();
+    return avx2 ? *avx2 : scalarKernels();
+}
+
+} // namespace GameProgramming::Particle
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <glm/ext/vector_float3.hpp>
+
+#include "random.hpp"
+#include "type.hpp"
+
+namespace GameProgramming::Particle
+{
+
+// One firework shot for the CPU pool: `count` particles leave `origin` at `velocity` plus normal noise of
+// `velocityDeviation` per axis, tinted `color` +- `colorJitter`, and live `lifetime` seconds.
+struct Shot
+{
+    glm::vec3 origin{0.0f};
+    glm::vec3 velocity{0.0f};
+    float velocityDeviation = 0.2f;
+    glm::vec3 color{1.0f};
+    float colorJitter = 0.2f;
+    float lifetime = 5.0f;
+    u32 count = 1000;
+};
+
+// What ParticlePool::update writes per particle: 16 bytes, attribute 0 = 3 floats, attribute 1 = 4
+// normalized unsigned bytes (RGBA, alpha fading with age).
+struct ParticleVertex
+{
+    glm::vec3 position;
+    u32 color;
+};
+static_assert(sizeof(ParticleVertex) == 16);
+
+// The same slot in every stream of a ParticlePool. Color is packed RGB8 with the alpha byte left 0.
+struct ParticleStreams
+{
+    float *positionX;
+    float *positionY;
+    float *positionZ;
+    float *velocityX;
+    float *velocityY;
+    float *velocityZ;
+    float *age;
+    float *lifetime;
+    u32 *color;
+};
+
+// A thread's generators: the scalar one for the scalar kernels and the tails of the wide ones, 8 lanes for the
+// AVX2 kernels. Each on its own cache line.
+struct alignas(64) ThreadRandom
+{
+    explicit ThreadRandom(u64 seed) noexcept : scalar(seed), lanes(Utility::splitMix64(seed) ^ 0xa5a5a5a5a5a5a5a5ull) {}
+
+    Utility::Xoshiro128 scalar;
+    Utility::Xoshiro128x8 lanes;
+};
+
+// The per-particle loops of ParticlePool, on `count` consecutive slots from `slots` on.
+//   spawn     : fills the slots for `shot`
+//   integrate : steps live particles by `deltaTime` under `gravity` and a linear `drag` (1/s), ages them and
+//               writes `count` vertices front to back; dead particles take a zero step and come out transparent
+struct Kernels
+{
+    const char *name;
+    void (*spawn)(const ParticleStreams &slots, u32 count, const Shot &shot, ThreadRandom &random) noexcept;
+    void (*integrate)(const ParticleStreams &slots, u32 count, float deltaTime, const glm::vec3 &gravity, float drag,
+                      ParticleVertex *vertices) noexcept;
+};
+
+// Plain C++, for any CPU.
+[[nodiscard]] const Kernels &scalarKernels() noexcept;
+// 8 particles at a time with AVX2 and FMA, normals by a vectorized Box-Muller; nullptr when the CPU lacks
+// either or the build is not for x86-64.
+[[nodiscard]] const Kernels *avx2Kernels() noexcept;
+// The fastest of the above the CPU runs, asked of CPUID once.
+[[nodiscard]] const Kernels &bestKernels() noexcept;
+
+} // namespace GameProgramming::Particle
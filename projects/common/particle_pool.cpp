@@ -0,0 +1,73 @@
+#include "particle_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <new>
+#include <stdexcept>
+
+namespace GameProgramming::Particle
+{
+
+ParticlePool::ParticlePool(u32 capacity, Job::JobSystem &jobs, u64 seed, const Kernels &kernels)
+    : m_jobs(jobs), m_kernels(&kernels), m_ring(capacity), m_streamBytes((static_cast<std::size_t>(capacity) * 4 + 63) & ~std::size_t{63})
+{
+    if (capacity == 0)
+        throw std::invalid_argument{"A particle pool needs at least one slot"};
+
+    m_storage.reset(static_cast<std::byte *>(::operator new[](m_streamBytes * StreamCount, std::align_val_t{64})));
+    m_random.reserve(jobs.threadCount());
+    for (u32 thread = 0; thread < jobs.threadCount(); ++thread)
+    {
+        m_random.emplace_back(seed * 0x9e3779b97f4a7c15ull + thread);
+    }
+}
+
+void ParticlePool::spawn(const Shot &shot)
+{
+    const SlotRange slots = m_ring.claim(shot.count, shot.lifetime);
+
+    // chunk [begin, end) of the claim may cross the end of the ring: one kernel call on each side
+    m_jobs.parallelFor(slots.count, ChunkSize, [&](u32 begin, u32 end, u32 thread) {
+        while (begin < end)
+        {
+            const u32 slot = (slots.first + begin) % capacity();
+            const u32 count = std::min(end - begin, capacity() - slot);
+            m_kernels->spawn(streamsAt(slot), count, shot, m_random[thread]);
+            begin += count;
+        }
+    });
+}
+
+void ParticlePool::update(float deltaTime, const glm::vec3 &gravity, float drag, ParticleVertex *vertices)
+{
+    m_ring.advance(deltaTime);
+
+    std::array<SlotRange, 2> ranges;
+    const u32 rangeCount = m_ring.ranges(ranges);
+    if (rangeCount == 0)
+        return;
+
+    // vertex i is the i-th live slot counted from the oldest, so a chunk may cross the wrap
+    m_jobs.parallelFor(m_ring.liveCount(), ChunkSize, [&](u32 begin, u32 end, u32) {
+        for (u32 r = 0; r < rangeCount && begin < end; ++r)
+        {
+            const u32 rangeBegin = r == 0 ? 0 : ranges[0].count;
+            const u32 rangeEnd = rangeBegin + ranges[r].count;
+            if (begin >= rangeEnd)
+                continue;
+
+            const u32 count = std::min(end, rangeEnd) - begin;
+            m_kernels->integrate(streamsAt(ranges[r].first + (begin - rangeBegin)), count, deltaTime, gravity, drag, vertices + begin);
+            begin += count;
+        }
+    });
+}
+
+ParticleStreams ParticlePool::streamsAt(u32 slot) noexcept
+{
+    return {stream<float>(PositionX) + slot, stream<float>(PositionY) + slot, stream<float>(PositionZ) + slot,
+            stream<float>(VelocityX) + slot, stream<float>(VelocityY) + slot, stream<float>(VelocityZ) + slot,
+            stream<float>(Age) + slot,       stream<float>(Lifetime) + slot,  stream<u32>(Color) + slot};
+}
+
+} // namespace GameProgramming::Particle
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <glm/ext/vector_float3.hpp>
+
+#include "job_system.hpp"
+#include "particle_kernels.hpp"
+#include "particle_ring.hpp"
+#include "type.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace GameProgramming::Particle
+{
+
+// CPU particles, one array per component so the integration loops stream through memory and vectorize.
+// Slots are handed out by an EmissionRing. Spawning and updating are split into chunks run on every thread
+// of a JobSystem, each thread drawing from its own random generators, through the fastest Kernels the CPU
+// runs unless told otherwise.
+class ParticlePool
+{
+public:
+    // chunk of particles one job works on: big enough to amortize claiming it, small enough to balance
+    static constexpr u32 ChunkSize = 16 * 1024;
+
+    ParticlePool(u32 capacity, Job::JobSystem &jobs, u64 seed = 1, const Kernels &kernels = bestKernels());
+
+    // Claims the next shot.count slots and fills them.
+    void spawn(const Shot &shot);
+
+    // Advances every live particle by `deltaTime`, under `gravity` and a `drag` (1/s) against its velocity, and
+    // writes them, oldest first, as liveCount() vertices to `vertices`. Written front to back exactly once, so
+    // `vertices` can be write-combined mapped memory.
+    void update(float deltaTime, const glm::vec3 &gravity, float drag, ParticleVertex *vertices);
+
+    [[nodiscard]] u32 capacity() const noexcept { return m_ring.capacity(); }
+    [[nodiscard]] u32 liveCount() const noexcept { return m_ring.liveCount(); }
+    [[nodiscard]] const Kernels &kernels() const noexcept { return *m_kernels; }
+
+private:
+    // every stream holds 4 byte elements: floats, except Color which is packed RGBA8 with A left 0
+    enum Stream : u32
+    {
+        PositionX,
+        PositionY,
+        PositionZ,
+        VelocityX,
+        VelocityY,
+        VelocityZ,
+        Age,
+        Lifetime,
+        Color,
+        StreamCount
+    };
+
+    struct AlignedDelete
+    {
+        void operator()(std::byte *p) const noexcept { ::operator delete[](p, std::align_val_t{64}); }
+    };
+
+    template <typename T>
+    [[nodiscard]] T *stream(Stream s) noexcept
+    {
+        static_assert(sizeof(T) == 4);
+        return reinterpret_cast<T *>(m_storage.get() + static_cast<std::size_t>(s) * m_streamBytes);
+    }
+
+    // every stream at `slot`
+    [[nodiscard]] ParticleStreams streamsAt(u32 slot) noexcept;
+
+    Job::JobSystem &m_jobs;
+    const Kernels *m_kernels;
+    EmissionRing m_ring;
+    std::size_t m_streamBytes; // from one stream to the next, a multiple of a cache line
+    std::unique_ptr<std::byte[], AlignedDelete> m_storage;
+    std::vector<ThreadRandom> m_random;
+};
+
+} // namespace GameProgramming::Particle
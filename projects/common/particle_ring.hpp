@@ -0,0 +1,95 @@
+#pragma once
+
+#include "type.hpp"
+
+#include <algorithm>
+#include <array>
+#include <deque>
+
+namespace GameProgramming::Particle
+{
+
+struct SlotRange
+{
+    u32 first;
+    u32 count;
+};
+
+// Slot bookkeeping shared by the particle systems: emissions claim the next slots of a fixed ring, overwriting
+// the oldest once it is full, and retire when their longest-lived particle is due. Because claims are
+// contiguous, the slots that may hold a live particle are one ring range ending at head(); ranges() splits it
+// where it wraps.
+class EmissionRing
+{
+public:
+    explicit EmissionRing(u32 capacity) noexcept : m_capacity(capacity) {}
+
+    [[nodiscard]] u32 capacity() const noexcept { return m_capacity; }
+    [[nodiscard]] u32 head() const noexcept { return m_head; }
+    [[nodiscard]] u32 liveCount() const noexcept { return m_liveCount; }
+
+    // Moves the clock on and retires what has expired, oldest first. An emission outliving an older one keeps
+    // the older slots in range a little longer; their particles are dead by age either way.
+    void advance(float deltaTime)
+    {
+        m_time += deltaTime;
+        while (!m_live.empty() && m_live.front().expiresAt <= m_time)
+        {
+            m_liveCount -= m_live.front().count;
+            m_live.pop_front();
+        }
+    }
+
+    // Claims the next `count` slots (at most capacity()) for particles living up to `lifetime` seconds from now.
+    SlotRange claim(u32 count, float lifetime)
+    {
+        count = std::min(count, m_capacity);
+        const SlotRange range{.first = m_head, .count = count};
+        m_head = static_cast<u32>((static_cast<u64>(m_head) + count) % m_capacity);
+        m_live.push_back({.count = count, .expiresAt = m_time + lifetime});
+        m_liveCount += count;
+
+        // a full ring hands the oldest slots over
+        while (m_liveCount > m_capacity)
+        {
+            const u32 excess = std::min(m_liveCount - m_capacity, m_live.front().count);
+            m_live.front().count -= excess;
+            m_liveCount -= excess;
+            if (m_live.front().count == 0)
+                m_live.pop_front();
+        }
+        return range;
+    }
+
+    // The live slots, oldest first, as one or two ranges; returns how many.
+    u32 ranges(std::array<SlotRange, 2> &ranges) const noexcept
+    {
+        if (m_liveCount == 0)
+            return 0;
+
+        const u32 tail = static_cast<u32>((static_cast<u64>(m_head) + m_capacity - m_liveCount) % m_capacity);
+        if (tail < m_head || m_head == 0)
+        {
+            ranges[0] = {.first = tail, .count = m_liveCount};
+            return 1;
+        }
+        ranges[0] = {.first = tail, .count = m_capacity - tail};
+        ranges[1] = {.first = 0, .count = m_head};
+        return 2;
+    }
+
+private:
+    struct Emission
+    {
+        u32 count;
+        float expiresAt;
+    };
+
+    u32 m_capacity;
+    u32 m_head = 0;
+    u32 m_liveCount = 0;
+    float m_time = 0.0f;
+    std::deque<Emission> m_live; // oldest first
+};
+
+} // namespace GameProgramming::Particle
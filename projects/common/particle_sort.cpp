@@ -0,0 +1,109 @@
+#include "particle_sort.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace GameProgramming::Particle
+{
+
+namespace
+{
+
+// a float as an unsigned key in the same order: negatives flip entirely, positives only in the sign bit
+u32 sortableKey(float value) noexcept
+{
+    const u32 bits = std::bit_cast<u32>(value);
+    return bits ^ (static_cast<u32>(static_cast<i32>(bits) >> 31) | 0x80000000u);
+}
+
+} // namespace
+
+void DepthSorter::sort(const ParticleVertex *vertices, u32 count, const glm::mat4 &view, ParticleVertex *sorted)
+{
+    if (count == 0)
+        return;
+
+    for (u32 i = 0; i < 2; ++i)
+    {
+        m_keys[i].resize(count);
+        m_indices[i].resize(count);
+    }
+    const u32 chunkCount = (count + ChunkSize - 1) / ChunkSize;
+    m_histograms.resize(static_cast<std::size_t>(chunkCount) * DigitCount);
+
+    // the camera looks down -z: ascending view z is farthest first
+    const glm::vec4 depthRow(view[0][2], view[1][2], view[2][2], view[3][2]);
+    m_jobs.parallelFor(count, ChunkSize, [&](u32 begin, u32 end, u32) {
+        for (u32 i = begin; i < end; ++i)
+        {
+            const glm::vec3 &p = vertices[i].position;
+            m_keys[0][i] = sortableKey(depthRow.x * p.x + depthRow.y * p.y + depthRow.z * p.z + depthRow.w);
+            m_indices[0][i] = i;
+        }
+    });
+
+    u32 current = 0;
+    for (u32 shift = 0; shift < 32; shift += DigitBits)
+    {
+        const std::vector<u32> &keys = m_keys[current];
+        const std::vector<u32> &indices = m_indices[current];
+        std::vector<u32> &nextKeys = m_keys[current ^ 1];
+        std::vector<u32> &nextIndices = m_indices[current ^ 1];
+
+        // a job runs inline as one range when there are no workers: always walk it chunk by chunk
+        m_jobs.parallelFor(count, ChunkSize, [&](u32 begin, u32 end, u32) {
+            for (u32 chunk = begin / ChunkSize; begin < end; ++chunk, begin += ChunkSize)
+            {
+                u32 *histogram = m_histograms.data() + static_cast<std::size_t>(chunk) * DigitCount;
+                std::fill_n(histogram, DigitCount, 0u);
+                for (u32 i = begin; i < std::min(begin + ChunkSize, end); ++i)
+                {
+                    ++histogram[(keys[i] >> shift) & (DigitCount - 1)];
+                }
+            }
+        });
+
+        // exclusive prefix sum in (digit, chunk) order: each chunk's share of each digit, chunks in order
+        u32 offset = 0;
+        bool trivial = false;
+        for (u32 digit = 0; digit < DigitCount; ++digit)
+        {
+            const u32 digitBegin = offset;
+            for (u32 chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                u32 &slot = m_histograms[static_cast<std::size_t>(chunk) * DigitCount + digit];
+                const u32 inChunk = slot;
+                slot = offset;
+                offset += inChunk;
+            }
+            trivial = trivial || offset - digitBegin == count;
+        }
+        // every key has the same digit: the order would not change
+        if (trivial)
+            continue;
+
+        m_jobs.parallelFor(count, ChunkSize, [&](u32 begin, u32 end, u32) {
+            for (u32 chunk = begin / ChunkSize; begin < end; ++chunk, begin += ChunkSize)
+            {
+                u32 *destination = m_histograms.data() + static_cast<std::size_t>(chunk) * DigitCount;
+                for (u32 i = begin; i < std::min(begin + ChunkSize, end); ++i)
+                {
+                    const u32 to = destination[(keys[i] >> shift) & (DigitCount - 1)]++;
+                    nextKeys[to] = keys[i];
+                    nextIndices[to] = indices[i];
+                }
+            }
+        });
+        current ^= 1;
+    }
+
+    const std::vector<u32> &order = m_indices[current];
+    m_jobs.parallelFor(count, ChunkSize, [&](u32 begin, u32 end, u32) {
+        for (u32 i = begin; i < end; ++i)
+        {
+            sorted[i] = vertices[order[i]];
+        }
+    });
+}
+
+} // namespace GameProgramming::Particle
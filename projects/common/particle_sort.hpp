@@ -0,0 +1,42 @@
+#pragma once
+
+#include <glm/ext/matrix_float4x4.hpp>
+
+#include "job_system.hpp"
+#include "particle_kernels.hpp"
+#include "type.hpp"
+
+#include <array>
+#include <vector>
+
+namespace GameProgramming::Particle
+{
+
+// Puts particle vertices in back to front order for alpha blending: an LSD radix sort over the view depth,
+// 8 bits per pass, with the histograms and the scatter of each pass split into chunks on a JobSystem. Stable,
+// so particles at equal depth keep their emission order. Passes whose digit is the same for every particle
+// (the top bytes when the particles span a small depth range) are skipped.
+class DepthSorter
+{
+public:
+    static constexpr u32 ChunkSize = 16 * 1024;
+
+    explicit DepthSorter(Job::JobSystem &jobs) noexcept : m_jobs(jobs) {}
+
+    // Writes the `count` `vertices` to `sorted`, farthest from the camera first, front to back exactly once
+    // (so `sorted` can be mapped memory). `view` is the world to view matrix.
+    void sort(const ParticleVertex *vertices, u32 count, const glm::mat4 &view, ParticleVertex *sorted);
+
+private:
+    static constexpr u32 DigitBits = 8;
+    static constexpr u32 DigitCount = 1u << DigitBits;
+
+    Job::JobSystem &m_jobs;
+    // key and vertex index, ping-ponged between passes
+    std::array<std::vector<u32>, 2> m_keys;
+    std::array<std::vector<u32>, 2> m_indices;
+    // DigitCount counts per chunk, then where each chunk writes each digit
+    std::vector<u32> m_histograms;
+};
+
+} // namespace GameProgramming::Particle
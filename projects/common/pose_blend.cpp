@@ -0,0 +1,165 @@
+#include "pose_blend.hpp"
+
+#include "cpu_features.hpp"
+
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define POSE_BLEND_AVX2 1
+#include <immintrin.h>
+#else
+#define POSE_BLEND_AVX2 0
+#endif
+
+// see particle_kernels.cpp: GCC and Clang only compile intrinsics inside functions built for the instruction set
+#if POSE_BLEND_AVX2 && (defined(__GNUC__) || defined(__clang__))
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+#else
+#define AVX2_TARGET
+#endif
+
+namespace GameProgramming::Animation
+{
+
+void QuatArray::resize(u32 count)
+{
+    m_x.resize(count);
+    m_y.resize(count);
+    m_z.resize(count);
+    m_w.resize(count, 1.0f);
+}
+
+namespace
+{
+
+// The coefficients of the weight correction, fitted for |cos| of the half angle between the two rotations.
+constexpr float A0 = 1.0904f, A1 = -3.2452f, A2 = 3.55645f, A3 = -1.43519f;
+constexpr float B0 = 0.848013f, B1 = -1.06021f, B2 = 0.215638f;
+
+void blendScalar(const ConstQuatStreams &from, const ConstQuatStreams &to, const float *weights, u32 count,
+                 const QuatStreams &out) noexcept
+{
+    for (u32 i = 0; i < count; ++i)
+    {
+        const float t = weights[i];
+        const float cosine = from.x[i] * to.x[i] + from.y[i] * to.y[i] + from.z[i] * to.z[i] + from.w[i] * to.w[i];
+        const float d = std::fabs(cosine);
+        const float a = A0 + d * (A1 + d * (A2 + d * A3));
+        const float b = B0 + d * (B1 + d * B2);
+        const float h = t - 0.5f;
+        const float k = a * h * h + b;
+        const float corrected = t + t * h * (t - 1.0f) * k;
+
+        // q and -q are the same rotation: flipping `to` takes the shorter arc
+        const float fromWeight = 1.0f - corrected;
+        const float toWeight = std::copysign(corrected, cosine);
+        const float x = from.x[i] * fromWeight + to.x[i] * toWeight;
+        const float y = from.y[i] * fromWeight + to.y[i] * toWeight;
+        const float z = from.z[i] * fromWeight + to.z[i] * toWeight;
+        const float w = from.w[i] * fromWeight + to.w[i] * toWeight;
+        const float inverseLength = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+        out.x[i] = x * inverseLength;
+        out.y[i] = y * inverseLength;
+        out.z[i] = z * inverseLength;
+        out.w[i] = w * inverseLength;
+    }
+}
+
+constexpr BlendKernels ScalarBlendKernels{"scalar", &blendScalar};
+
+#if POSE_BLEND_AVX2
+
+// the same steps as blendScalar, 8 quaternions per iteration; returns how many it blended
+AVX2_TARGET u32 blendBatches(const ConstQuatStreams &from, const ConstQuatStreams &to, const float *weights, u32 count,
+                             const QuatStreams &out) noexcept
+{
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 threeHalves = _mm256_set1_ps(1.5f);
+
+    u32 i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 fx = _mm256_loadu_ps(from.x + i), fy = _mm256_loadu_ps(from.y + i);
+        const __m256 fz = _mm256_loadu_ps(from.z + i), fw = _mm256_loadu_ps(from.w + i);
+        const __m256 tx = _mm256_loadu_ps(to.x + i), ty = _mm256_loadu_ps(to.y + i);
+        const __m256 tz = _mm256_loadu_ps(to.z + i), tw = _mm256_loadu_ps(to.w + i);
+        const __m256 t = _mm256_loadu_ps(weights + i);
+
+        __m256 cosine = _mm256_mul_ps(fx, tx);
+        cosine = _mm256_fmadd_ps(fy, ty, cosine);
+        cosine = _mm256_fmadd_ps(fz, tz, cosine);
+        cosine = _mm256_fmadd_ps(fw, tw, cosine);
+        const __m256 sign = _mm256_and_ps(cosine, signBit);
+        const __m256 d = _mm256_andnot_ps(signBit, cosine);
+
+        __m256 a = _mm256_fmadd_ps(d, _mm256_set1_ps(A3), _mm256_set1_ps(A2));
+        a = _mm256_fmadd_ps(d, a, _mm256_set1_ps(A1));
+        a = _mm256_fmadd_ps(d, a, _mm256_set1_ps(A0));
+        __m256 b = _mm256_fmadd_ps(d, _mm256_set1_ps(B2), _mm256_set1_ps(B1));
+        b = _mm256_fmadd_ps(d, b, _mm256_set1_ps(B0));
+        const __m256 h = _mm256_sub_ps(t, half);
+        const __m256 k = _mm256_fmadd_ps(a, _mm256_mul_ps(h, h), b);
+        const __m256 corrected = _mm256_fmadd_ps(_mm256_mul_ps(_mm256_mul_ps(t, h), _mm256_sub_ps(t, one)), k, t);
+
+        const __m256 fromWeight = _mm256_sub_ps(one, corrected);
+        const __m256 toWeight = _mm256_xor_ps(corrected, sign);
+        const __m256 x = _mm256_fmadd_ps(fx, fromWeight, _mm256_mul_ps(tx, toWeight));
+        const __m256 y = _mm256_fmadd_ps(fy, fromWeight, _mm256_mul_ps(ty, toWeight));
+        const __m256 z = _mm256_fmadd_ps(fz, fromWeight, _mm256_mul_ps(tz, toWeight));
+        const __m256 w = _mm256_fmadd_ps(fw, fromWeight, _mm256_mul_ps(tw, toWeight));
+
+        // rsqrt's 12 bits plus one Newton step: r * (1.5 - 0.5 * n * r * r)
+        __m256 lengthSquared = _mm256_mul_ps(x, x);
+        lengthSquared = _mm256_fmadd_ps(y, y, lengthSquared);
+        lengthSquared = _mm256_fmadd_ps(z, z, lengthSquared);
+        lengthSquared = _mm256_fmadd_ps(w, w, lengthSquared);
+        const __m256 estimate = _mm256_rsqrt_ps(lengthSquared);
+        const __m256 halfLengthSquared = _mm256_mul_ps(half, lengthSquared);
+        const __m256 inverseLength =
+            _mm256_mul_ps(estimate, _mm256_fnmadd_ps(halfLengthSquared, _mm256_mul_ps(estimate, estimate), threeHalves));
+
+        _mm256_storeu_ps(out.x + i, _mm256_mul_ps(x, inverseLength));
+        _mm256_storeu_ps(out.y + i, _mm256_mul_ps(y, inverseLength));
+        _mm256_storeu_ps(out.z + i, _mm256_mul_ps(z, inverseLength));
+        _mm256_storeu_ps(out.w + i, _mm256_mul_ps(w, inverseLength));
+    }
+    return i;
+}
+
+void blendAvx2(const ConstQuatStreams &from, const ConstQuatStreams &to, const float *weights, u32 count,
+               const QuatStreams &out) noexcept
+{
+    const u32 done = blendBatches(from, to, weights, count, out);
+    blendScalar({from.x + done, from.y + done, from.z + done, from.w + done}, {to.x + done, to.y + done, to.z + done, to.w + done},
+                weights + done, count - done, {out.x + done, out.y + done, out.z + done, out.w + done});
+}
+
+constexpr BlendKernels Avx2BlendKernels{"avx2", &blendAvx2};
+
+#endif
+
+} // namespace
+
+const BlendKernels &scalarBlendKernels() noexcept
+{
+    return ScalarBlendKernels;
+}
+
+const BlendKernels *avx2BlendKernels() noexcept
+{
+#if POSE_BLEND_AVX2
+    return Utility::cpuHasAvx2() ? &Avx2BlendKernels : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+const BlendKernels &bestBlendKernels() noexcept
+{
+    const BlendKernels *avx2 = avx2BlendKernels();
+    return avx2 ? *avx2 : scalarBlendKernels();
+}
+
+} // namespace GameProgramming::Animation
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <glm/ext/quaternion_float.hpp>
+
+#include "type.hpp"
+
+#include <vector>
+
+namespace GameProgramming::Animation
+{
+
+// Quaternions as one array per component, so 8 of them load into the lanes of an AVX2 register each.
+struct ConstQuatStreams
+{
+    const float *x;
+    const float *y;
+    const float *z;
+    const float *w;
+};
+
+struct QuatStreams
+{
+    float *x;
+    float *y;
+    float *z;
+    float *w;
+
+    operator ConstQuatStreams() const noexcept { return {x, y, z, w}; }
+};
+
+// Owns the arrays behind a QuatStreams; typically characters x bones rotations, character major.
+class QuatArray
+{
+public:
+    QuatArray() = default;
+    explicit QuatArray(u32 count) { resize(count); }
+
+    void resize(u32 count);
+    [[nodiscard]] u32 size() const noexcept { return static_cast<u32>(m_w.size()); }
+
+    void set(u32 index, const glm::quat &q) noexcept
+    {
+        m_x[index] = q.x;
+        m_y[index] = q.y;
+        m_z[index] = q.z;
+        m_w[index] = q.w;
+    }
+    [[nodiscard]] glm::quat get(u32 index) const noexcept { return {m_w[index], m_x[index], m_y[index], m_z[index]}; }
+
+    // the arrays from `first` on
+    [[nodiscard]] QuatStreams streams(u32 first = 0) noexcept { return {m_x.data() + first, m_y.data() + first, m_z.data() + first, m_w.data() + first}; }
+    [[nodiscard]] ConstQuatStreams streams(u32 first = 0) const noexcept { return {m_x.data() + first, m_y.data() + first, m_z.data() + first, m_w.data() + first}; }
+
+private:
+    std::vector<float> m_x, m_y, m_z, m_w;
+};
+
+// out[i] = slerp(from[i], to[i], weights[i]) for `count` quaternions, along the shorter arc, normalized. The
+// slerp is approximated by an nlerp whose weight is corrected with a polynomial in |dot(from, to)| (Kapoulkine,
+// "Approximating slerp"): no trigonometry, no division but the normalization, and at most ~0.0013 rad (0.07 deg)
+// off glm::slerp.
+// `out` may be `from` or `to`.
+struct BlendKernels
+{
+    const char *name;
+    void (*blend)(const ConstQuatStreams &from, const ConstQuatStreams &to, const float *weights, u32 count,
+                  const QuatStreams &out) noexcept;
+};
+
+// Plain C++, for any CPU.
+[[nodiscard]] const BlendKernels &scalarBlendKernels() noexcept;
+// 8 quaternions at a time with AVX2 and FMA; nullptr when the CPU lacks either or the build is not for x86-64.
+[[nodiscard]] const BlendKernels *avx2BlendKernels() noexcept;
+// The fastest of the above the CPU runs.
+[[nodiscard]] const BlendKernels &bestBlendKernels() noexcept;
+
+} // namespace GameProgramming::Animation
@@ -0,0 +1,207 @@
+#include "program_cache.hpp"
+
+#include "gl_extensions.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace GameProgramming::Shader
+{
+
+namespace
+{
+
+constexpr char Magic[4] = {'G', 'P', 'P', 'B'};
+constexpr u32 Version = 1;
+
+struct ProgramBinaryHeader
+{
+    char magic[4];
+    u32 version;
+    u64 key;
+    u64 checksum; // of the binary, so a truncated or damaged file never reaches the driver
+    u32 format;   // driver specific GLenum from glGetProgramBinary
+    u32 size;
+};
+static_assert(sizeof(ProgramBinaryHeader) == 32);
+
+// FNV-1a
+constexpr u64 HashSeed = 0xcbf29ce484222325ull;
+
+u64 hash(const void *data, std::size_t size, u64 seed = HashSeed) noexcept
+{
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    u64 h = seed;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        h = (h ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return h;
+}
+
+u64 hash(std::string_view text, u64 seed) noexcept
+{
+    // the length goes in too, so moving text from one stage to the next changes the key
+    const u64 length = text.size();
+    return hash(text.data(), text.size(), hash(&length, sizeof(length), seed));
+}
+
+std::string_view glString(GLenum name) noexcept
+{
+    const auto *value = reinterpret_cast<const char *>(glGetString(name));
+    return value ? std::string_view{value} : std::string_view{};
+}
+
+std::string hex(u64 value)
+{
+    char digits[16];
+    const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value, 16);
+    return std::string(static_cast<std::size_t>(digits + sizeof(digits) - end), '0') + std::string{digits, end};
+}
+
+std::filesystem::path entryPath(u64 key)
+{
+    return ProgramBinaryCache::directory() / (hex(key) + ".bin");
+}
+
+} // namespace
+
+bool ProgramBinaryCache::enabled() noexcept
+{
+    return GL::extensions().ARB_get_program_binary;
+}
+
+std::filesystem::path ProgramBinaryCache::directory()
+{
+#ifdef SHADER_CACHE_DIR
+    return std::filesystem::path{SHADER_CACHE_DIR};
+#else
+    std::error_code error;
+    const std::filesystem::path temp = std::filesystem::temp_directory_path(error);
+    return (error ? std::filesystem::path{"."} : temp) / "game-programming-shader-cache";
+#endif
+}
+
+u64 ProgramBinaryCache::key(std::initializer_list<std::string_view> sources)
+{
+    u64 h = HashSeed;
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+    {
+        h = hash(glString(name), h);
+    }
+    for (std::string_view source : sources)
+    {
+        h = hash(source, h);
+    }
+    return h;
+}
+
+bool ProgramBinaryCache::load(GLuint program, u64 key)
+{
+    if (!enabled())
+        return false;
+
+    const std::filesystem::path path = entryPath(key);
+    std::ifstream file{path, std::ios::binary};
+    if (!file.is_open())
+        return false;
+
+    ProgramBinaryHeader header{};
+    std::vector<char> binary;
+    bool valid = static_cast<bool>(file.read(reinterpret_cast<char *>(&header), sizeof(header))) &&
+                 std::memcmp(header.magic, Magic, sizeof(Magic)) == 0 && header.version == Version && header.key == key;
+    if (valid)
+    {
+        // checked before allocating: a damaged size would otherwise ask for up to 4 GiB
+        std::error_code error;
+        const std::uintmax_t fileSize = std::filesystem::file_size(path, error);
+        valid = !error && fileSize == sizeof(header) + std::uintmax_t{header.size};
+    }
+    if (valid)
+    {
+        binary.resize(header.size);
+        valid = static_cast<bool>(file.read(binary.data(), static_cast<std::streamsize>(binary.size()))) &&
+                hash(binary.data(), binary.size()) == header.checksum;
+    }
+
+    GLint linked = GL_FALSE;
+    if (valid)
+    {
+        GL::extensions().ProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    }
+    if (linked != GL_TRUE)
+    {
+        // stale (e.g. the driver changed its binary format without changing its version string) or damaged
+        file.close();
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        return false;
+    }
+    return true;
+}
+
+void ProgramBinaryCache::prepare(GLuint program) noexcept
+{
+    if (enabled())
+    {
+        GL::extensions().ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+}
+
+void ProgramBinaryCache::store(GLuint program, u64 key)
+{
+    if (!enabled())
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(static_cast<std::size_t>(length));
+    GLenum format = GL_NONE;
+    GL::extensions().GetProgramBinary(program, length, &length, &format, binary.data());
+    binary.resize(static_cast<std::size_t>(length));
+
+    ProgramBinaryHeader header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.key = key;
+    header.checksum = hash(binary.data(), binary.size());
+    header.format = format;
+    header.size = static_cast<u32>(binary.size());
+
+    std::error_code error;
+    std::filesystem::create_directories(directory(), error);
+    if (error)
+        return;
+
+    // write next to the entry and rename, so another instance never reads a half written file
+    const std::filesystem::path path = entryPath(key);
+    std::filesystem::path temporary = path;
+    temporary += "." + hex(static_cast<u64>(std::chrono::steady_clock::now().time_since_epoch().count())) + ".tmp";
+    {
+        std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+        if (!file.write(reinterpret_cast<const char *>(&header), sizeof(header)) ||
+            !file.write(binary.data(), static_cast<std::streamsize>(binary.size())))
+        {
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+} // namespace GameProgramming::Shader
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "type.hpp"
+
+#include <filesystem>
+#include <initializer_list>
+#include <string_view>
+
+namespace GameProgramming::Shader
+{
+
+// Linked program binaries kept on disk between runs (GL_ARB_get_program_binary), so a warm start skips
+// compiling and linking. Entries are keyed by the source of every stage and by the vendor, renderer and
+// version strings of the driver that produced them: an edited shader or an updated driver simply misses.
+// Everything here is best effort; without the extension or a writable cache directory it does nothing.
+class ProgramBinaryCache
+{
+public:
+    [[nodiscard]] static bool enabled() noexcept;
+
+    // SHADER_CACHE_DIR when the target defines it, a folder in the temp directory otherwise.
+    [[nodiscard]] static std::filesystem::path directory();
+
+    [[nodiscard]] static u64 key(std::initializer_list<std::string_view> sources);
+
+    // Links `program` from the binary cached for `key`. False if there is none or the driver rejects it;
+    // the program is then unlinked and can be built from source as usual (a rejected entry is removed).
+    [[nodiscard]] static bool load(GLuint program, u64 key);
+
+    // Must be called before glLinkProgram for the driver to keep the binary of a program retrievable.
+    static void prepare(GLuint program) noexcept;
+
+    // Writes the binary of the linked `program` under `key`.
+    static void store(GLuint program, u64 key);
+};
+
+} // namespace GameProgramming::Shader
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "type.hpp"
+
+#include <bit>
+#include <cmath>
+
+namespace GameProgramming::Utility
+{
+
+// splitmix64: the next 64 bits of a sequence that spreads any seed, 0 included, over a generator's state
+inline u64 splitMix64(u64 &seed) noexcept
+{
+    seed += 0x9e3779b97f4a7c15ull;
+    u64 z = seed;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// xoshiro128+ (Blackman, Vigna): 16 bytes of state and a handful of integer ops per number, good enough for
+// particle jitter. One generator per thread; glm::linearRand and glm::gaussRand share std::rand's hidden state.
+class Xoshiro128
+{
+public:
+    explicit Xoshiro128(u64 seed) noexcept
+    {
+        for (u32 i = 0; i < 4; i += 2)
+        {
+            const u64 z = splitMix64(seed);
+            m_state[i] = static_cast<u32>(z);
+            m_state[i + 1] = static_cast<u32>(z >> 32);
+        }
+    }
+
+    u32 next() noexcept
+    {
+        const u32 result = m_state[0] + m_state[3];
+        const u32 t = m_state[1] << 9;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = std::rotl(m_state[3], 11);
+        return result;
+    }
+
+    // [0, 1), from the upper bits: the low ones of xoshiro128+ are its weak ones
+    float uniform() noexcept { return static_cast<float>(next() >> 8) * 0x1p-24f; }
+    float uniform(float min, float max) noexcept { return min + (max - min) * uniform(); }
+
+    // normal distribution, Marsaglia's polar method
+    float gauss(float mean, float deviation) noexcept
+    {
+        float x, y, w;
+        do
+        {
+            x = uniform(-1.0f, 1.0f);
+            y = uniform(-1.0f, 1.0f);
+            w = x * x + y * y;
+        } while (w >= 1.0f || w == 0.0f);
+        return mean + deviation * y * std::sqrt(-2.0f * std::log(w) / w);
+    }
+
+private:
+    u32 m_state[4];
+};
+
+// Eight independent xoshiro128+ generators laid out for 8-wide SIMD: state[word][lane]. Only the state lives
+// here; the kernels that step it load it into registers once per batch (see particle_kernels.cpp).
+struct Xoshiro128x8
+{
+    explicit Xoshiro128x8(u64 seed) noexcept
+    {
+        for (u32 lane = 0; lane < 8; ++lane)
+        {
+            for (u32 word = 0; word < 4; word += 2)
+            {
+                const u64 z = splitMix64(seed);
+                state[word][lane] = static_cast<u32>(z);
+                state[word + 1][lane] = static_cast<u32>(z >> 32);
+            }
+        }
+    }
+
+    alignas(32) u32 state[4][8];
+};
+
+} // namespace GameProgramming::Utility
@@ -1,11 +1,15 @@
 #include "shader.hpp"
 
+#include "constant_buffers.hpp"
+#include "gl_extensions.hpp"
 #include "logger.hpp"
+#include "program_cache.hpp"
 #include "utility.hpp"
 
 #include <cassert>
 
 #include <filesystem>
+#include <utility>
 #include <vector>
 #include <fstream>
 #include <sstream>
@@ -14,33 +18,204 @@
 namespace GameProgramming::Shader
 {
 
-ShaderProgram::ShaderProgram(std::filesystem::path vertexShaderSrc, std::filesystem::path fragmentShaderSrc)
-    : m_program(glCreateProgram())
+namespace
 {
-    ShaderObject vertexShader{vertexShaderSrc, ShaderType::Vertex};
-    ShaderObject fragmentShader{fragmentShaderSrc, ShaderType::Fragment};
-    glAttachShader(m_program, vertexShader.getID());
-    glAttachShader(m_program, fragmentShader.getID());
-    glLinkProgram(m_program);
 
+// Waits for the link, logs why it failed if it did and releases the stages. True if `program` is usable.
+bool linkStages(GLuint program, std::vector<std::unique_ptr<ShaderObject>> &stages) noexcept
+{
     GLint isLinked{};
-    glGetProgramiv(m_program, GL_LINK_STATUS, &isLinked);
+    glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
     if (isLinked != GL_TRUE)
     {
+        // a stage that failed to compile is the usual cause, its log says more than the link log
+        for (const auto &stage : stages)
+        {
+            stage->checkCompileStatus();
+        }
         GLsizei len{};
-        glGetProgramiv(m_program, GL_INFO_LOG_LENGTH, &len);
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &len);
         std::vector<GLchar> buffer(len);
-        glGetProgramInfoLog(m_program, len, &len, buffer.data());
+        glGetProgramInfoLog(program, len, &len, buffer.data());
         LOG_ERROR("Failed to link shader program: {}", buffer.data());
     }
+    for (const auto &stage : stages)
+    {
+        glDetachShader(program, stage->getID());
+    }
+    stages.clear();
+    return isLinked == GL_TRUE;
+}
+
+} // namespace
+
+ShaderProgram::ShaderProgram(std::filesystem::path vertexShaderSrc, std::filesystem::path fragmentShaderSrc)
+    : m_program(glCreateProgram()), m_vertexPath(vertexShaderSrc), m_fragmentPath(fragmentShaderSrc)
+{
+    submit({ShaderLoader::loadShaderScript(vertexShaderSrc), ShaderLoader::loadShaderScript(fragmentShaderSrc)});
+}
+
+ShaderProgram::ShaderProgram(std::filesystem::path vertexShaderSrc, std::span<const char *const> feedbackVaryings)
+    : m_program(glCreateProgram()), m_vertexPath(vertexShaderSrc), m_feedbackVaryings(feedbackVaryings.begin(), feedbackVaryings.end())
+{
+    if (m_feedbackVaryings.empty())
+        throw std::invalid_argument{"A vertex-only program needs at least one transform feedback varying"};
+
+    submit({ShaderLoader::loadShaderScript(vertexShaderSrc)});
+}
+
+void ShaderProgram::submit(const std::vector<std::string> &sources)
+{
+    m_cacheKey = cacheKey(sources);
+
+    if (ProgramBinaryCache::load(m_program, m_cacheKey))
+    {
+        LOG_DEBUG("Loaded cached program binary for {}", describe());
+        m_uniforms.reflect(m_program);
+        bindConstantBlocks(m_program);
+        return;
+    }
+
+    // no status queries here: each one would make the driver finish this program before the next is submitted
+    compileAndLink(m_program, m_pendingStages, sources);
+}
+
+void ShaderProgram::compileAndLink(GLuint program, std::vector<std::unique_ptr<ShaderObject>> &stages,
+                                   const std::vector<std::string> &sources) const
+{
+    stages.push_back(std::make_unique<ShaderObject>(m_vertexPath, ShaderType::Vertex, sources[0]));
+    if (m_feedbackVaryings.empty())
+        stages.push_back(std::make_unique<ShaderObject>(m_fragmentPath, ShaderType::Fragment, sources[1]));
+    setFeedbackVaryings(program);
+    for (const auto &stage : stages)
+    {
+        glAttachShader(program, stage->getID());
+    }
+    ProgramBinaryCache::prepare(program);
+    glLinkProgram(program);
+}
+
+void ShaderProgram::setFeedbackVaryings(GLuint program) const
+{
+    if (m_feedbackVaryings.empty())
+        return;
+
+    std::vector<const GLchar *> names;
+    for (const std::string &varying : m_feedbackVaryings)
+    {
+        names.push_back(varying.c_str());
+    }
+    glTransformFeedbackVaryings(program, static_cast<GLsizei>(names.size()), names.data(), GL_INTERLEAVED_ATTRIBS);
+}
+
+u64 ShaderProgram::cacheKey(const std::vector<std::string> &sources) const
+{
+    if (m_feedbackVaryings.empty())
+        return ProgramBinaryCache::key({sources[0], sources[1]});
+
+    // the captured outputs are part of what gets linked
+    std::string varyings;
+    for (const std::string &varying : m_feedbackVaryings)
+    {
+        varyings.append(varying).push_back('\n');
+    }
+    return ProgramBinaryCache::key({sources[0], varyings});
+}
+
+std::string ShaderProgram::describe() const
+{
+    return m_fragmentPath.empty() ? m_vertexPath.filename().string()
+                                  : m_vertexPath.filename().string() + ", " + m_fragmentPath.filename().string();
+}
+
+std::vector<std::filesystem::path> ShaderProgram::sourceFiles() const
+{
+    if (m_fragmentPath.empty())
+        return {m_vertexPath};
+    return {m_vertexPath, m_fragmentPath};
 }
 
 ShaderProgram::~ShaderProgram()
 {
     glDeleteProgram(m_program);
+    glDeleteProgram(m_reloadProgram);
+}
+
+bool ShaderProgram::ready() const noexcept
+{
+    if (m_pendingStages.empty() || !GL::extensions().KHR_parallel_shader_compile)
+        return true;
+
+    GLint completed{};
+    glGetProgramiv(m_program, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
+
+void ShaderProgram::completeLink() const noexcept
+{
+    if (!linkStages(m_program, m_pendingStages))
+        return;
+
+    ProgramBinaryCache::store(m_program, m_cacheKey);
+    m_uniforms.reflect(m_program);
+    bindConstantBlocks(m_program);
+}
+
+void ShaderProgram::beginReload(const std::vector<std::string> &sources)
+{
+    if (sources.size() != (m_fragmentPath.empty() ? 1 : 2))
+        throw std::invalid_argument{"A program reloads from one source per file of sourceFiles()"};
+
+    // a newer edit supersedes a rebuild still in flight
+    m_reloadStages.clear();
+    glDeleteProgram(m_reloadProgram);
+
+    m_reloadProgram = glCreateProgram();
+    m_reloadCacheKey = cacheKey(sources);
+    compileAndLink(m_reloadProgram, m_reloadStages, sources);
+}
+
+bool ShaderProgram::pollReload()
+{
+    if (m_reloadProgram == 0)
+        return true;
+
+    if (GL::extensions().KHR_parallel_shader_compile)
+    {
+        GLint completed{};
+        glGetProgramiv(m_reloadProgram, GL_COMPLETION_STATUS_KHR, &completed);
+        if (completed != GL_TRUE)
+            return false;
+    }
+
+    if (!linkStages(m_reloadProgram, m_reloadStages))
+    {
+        LOG_WARN("Keeping the previous build of {}", describe());
+        glDeleteProgram(std::exchange(m_reloadProgram, 0));
+        return true;
+    }
+
+    // uniforms set once at startup (sampler units, constants) carry over to the rebuilt program
+    finishLink();
+    UniformTable uniforms{m_reloadProgram};
+    copyUniformValues(m_program, m_uniforms, m_reloadProgram, uniforms);
+    bindConstantBlocks(m_reloadProgram);
+    ProgramBinaryCache::store(m_reloadProgram, m_reloadCacheKey);
+
+    glDeleteProgram(m_program);
+    m_program = std::exchange(m_reloadProgram, 0);
+    m_cacheKey = m_reloadCacheKey;
+    m_uniforms = std::move(uniforms);
+    LOG_INFO("Reloaded {}", describe());
+    return true;
 }
 
 ShaderObject::ShaderObject(std::filesystem::path src, ShaderType shaderType)
+    : ShaderObject(src, shaderType, ShaderLoader::loadShaderScript(src))
+{
+}
+
+ShaderObject::ShaderObject(std::filesystem::path src, ShaderType shaderType, const std::string &shaderSource)
     : m_shader(0), m_shaderPath(src)
 {
     m_shader = glCreateShader(Utility::to_underlying(shaderType));
@@ -52,11 +227,14 @@ ShaderObject::ShaderObject(std::filesystem::path src, ShaderType shaderType)
         throw std::runtime_error{msg};
     }
 
-    std::string shaderSource = ShaderLoader::loadShaderScript(src);
     const GLchar *shaderSource_cstr = shaderSource.c_str();
     glShaderSource(m_shader, 1, &shaderSource_cstr, nullptr);
 
     glCompileShader(m_shader);
+}
+
+bool ShaderObject::checkCompileStatus() const
+{
     GLint isSuccess;
     glGetShaderiv(m_shader, GL_COMPILE_STATUS, &isSuccess);
     if (isSuccess != GL_TRUE)
@@ -65,8 +243,9 @@ ShaderObject::ShaderObject(std::filesystem::path src, ShaderType shaderType)
         glGetShaderiv(m_shader, GL_INFO_LOG_LENGTH, &len);
         std::vector<GLchar> buffer(len);
         glGetShaderInfoLog(m_shader, len, &len, buffer.data());
-        LOG_ERROR("Failed to compile shader: {}", buffer.data());
+        LOG_ERROR("Failed to compile shader {}: {}", m_shaderPath.filename().string(), buffer.data());
     }
+    return isSuccess == GL_TRUE;
 }
 
 ShaderObject::~ShaderObject()
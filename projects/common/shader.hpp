@@ -6,8 +6,13 @@
 #include <glm/ext/vector_float3.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "uniform_table.hpp"
+
 #include <filesystem>
+#include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace GameProgramming::Shader
 {
@@ -19,59 +24,132 @@ enum class ShaderType
     Geometry = GL_GEOMETRY_SHADER
 };
 
+class ShaderObject;
+
+// Compiling and linking are only submitted by the constructor. The link result is asked for the first time
+// the program is needed (use(), get(), a uniform lookup), so the programs a target creates in a row compile
+// concurrently instead of each waiting on the driver; with GL_KHR_parallel_shader_compile on its threads.
 class ShaderProgram
 {
 public:
     ShaderProgram(std::filesystem::path vertexShaderSrc = "./shader.vert", std::filesystem::path fragmentShaderSrc = "./shader.frag");
+    // Vertex-only program for transform feedback: `feedbackVaryings` are captured interleaved, in this order,
+    // into the buffer bound to GL_TRANSFORM_FEEDBACK_BUFFER binding 0. Run it with GL_RASTERIZER_DISCARD.
+    ShaderProgram(std::filesystem::path vertexShaderSrc, std::span<const char *const> feedbackVaryings);
     ~ShaderProgram();
     ShaderProgram(const ShaderProgram&) = delete;
     ShaderProgram& operator=(const ShaderProgram&) = delete;
     ShaderProgram(ShaderProgram&&) = delete;
     ShaderProgram& operator=(ShaderProgram&&) = delete;
 
-    void use() const noexcept { glUseProgram(m_program); }
+    void use() const noexcept
+    {
+        finishLink();
+        glUseProgram(m_program);
+    }
+
+    [[nodiscard]] GLuint get() const noexcept
+    {
+        finishLink();
+        return m_program;
+    }
+
+    // Whether the first use would not have to wait for the driver. Only known with GL_KHR_parallel_shader_compile;
+    // without it this is always true.
+    [[nodiscard]] bool ready() const noexcept;
+
+    [[nodiscard]] GLint getUniformLocation(const char *uniformName) const noexcept
+    {
+        finishLink();
+        return m_uniforms.location(uniformName);
+    }
+
+    // Typed handle for per-draw updates: look it up once after construction, then set it without any name lookup.
+    // A reload (see ShaderWatcher) invalidates it.
+    template <typename T>
+    [[nodiscard]] Uniform<T> uniform(const char *uniformName) const noexcept
+    {
+        finishLink();
+        return m_uniforms.uniform<T>(uniformName);
+    }
 
-    [[nodiscard]] GLuint get() const noexcept { return m_program; }
-    [[nodiscard]] GLint getUniformLocation(const char *uniformName) const noexcept { return glGetUniformLocation(m_program, uniformName); }
+    template <typename T>
+    void set(Uniform<T> uniform, const T &value) const noexcept
+    {
+        setUniform(uniform, value);
+    }
 
     void setUniformMatrix4f(const char *uniformName, const GLfloat *matrix) const noexcept
     {
-        glUniformMatrix4fv(glGetUniformLocation(m_program, uniformName), 1, GL_FALSE, matrix);
+        glUniformMatrix4fv(getUniformLocation(uniformName), 1, GL_FALSE, matrix);
     }
 
     void setUniformMatrix4f(const char *uniformName, const glm::mat4 &matrix) const noexcept
     {
-        glUniformMatrix4fv(glGetUniformLocation(m_program, uniformName), 1, GL_FALSE, glm::value_ptr(matrix));
+        glUniformMatrix4fv(getUniformLocation(uniformName), 1, GL_FALSE, glm::value_ptr(matrix));
     }
 
     void setUniformVec3(const char *uniformName, const GLfloat *vector) const noexcept
     {
-        glUniform3fv(glGetUniformLocation(m_program, uniformName), 1, vector);
+        glUniform3fv(getUniformLocation(uniformName), 1, vector);
     }
 
     void setUniformVec3(const char *uniformName, const glm::vec3 &vector) const noexcept
     {
-        glUniform3fv(glGetUniformLocation(m_program, uniformName), 1, glm::value_ptr(vector));
+        glUniform3fv(getUniformLocation(uniformName), 1, glm::value_ptr(vector));
     }
 
     void setUniformVec3(const char *uniformName, GLfloat x, GLfloat y, GLfloat z) const noexcept
     {
-        glUniform3f(glGetUniformLocation(m_program, uniformName), x, y, z);
+        glUniform3f(getUniformLocation(uniformName), x, y, z);
     }
 
     void setUniformFloat(const char *uniformName, const GLfloat value) const noexcept
     {
-        glUniform1f(glad_glGetUniformLocation(m_program, uniformName), value);
+        glUniform1f(getUniformLocation(uniformName), value);
     }
 
+    // Hot reload, driven by ShaderWatcher: the vertex (and fragment) shader files, rebuilding from their new
+    // `sources` (same order), and swapping the rebuilt program in. pollReload() returns false while the driver
+    // is still linking; once done, the old program is replaced if the new one linked and kept if it did not.
+    [[nodiscard]] std::vector<std::filesystem::path> sourceFiles() const;
+    void beginReload(const std::vector<std::string> &sources);
+    bool pollReload();
+
 private:
+    void submit(const std::vector<std::string> &sources);
+    void setFeedbackVaryings(GLuint program) const;
+    void compileAndLink(GLuint program, std::vector<std::unique_ptr<ShaderObject>> &stages, const std::vector<std::string> &sources) const;
+    [[nodiscard]] u64 cacheKey(const std::vector<std::string> &sources) const;
+    [[nodiscard]] std::string describe() const;
+
+    void finishLink() const noexcept
+    {
+        if (!m_pendingStages.empty())
+            completeLink();
+    }
+    void completeLink() const noexcept;
+
     GLuint m_program;
+    u64 m_cacheKey = 0;
+    mutable std::vector<std::unique_ptr<ShaderObject>> m_pendingStages; // submitted, link status not queried yet
+    mutable UniformTable m_uniforms;                                   // filled once the program is linked
+
+    std::filesystem::path m_vertexPath;
+    std::filesystem::path m_fragmentPath;          // empty for a transform feedback program
+    std::vector<std::string> m_feedbackVaryings;  // empty for a rasterizing program
+    GLuint m_reloadProgram = 0; // rebuilt program waiting to be swapped in
+    u64 m_reloadCacheKey = 0;
+    std::vector<std::unique_ptr<ShaderObject>> m_reloadStages;
 };
 
 class ShaderObject
 {
 public:
+    // Submits the compile; the result is only asked for by checkCompileStatus().
     ShaderObject(std::filesystem::path src, ShaderType shaderType);
+    // `shaderSource` already read from `src`, which is only kept for messages
+    ShaderObject(std::filesystem::path src, ShaderType shaderType, const std::string &shaderSource);
     ~ShaderObject();
     ShaderObject(const ShaderObject &) = delete;
     ShaderObject operator=(const ShaderObject &) = delete;
@@ -83,6 +161,9 @@ public:
         return m_shader;
     }
 
+    // Waits for the compile and logs the info log if it failed.
+    bool checkCompileStatus() const;
+
 private:
     GLuint m_shader;
     std::filesystem::path m_shaderPath;
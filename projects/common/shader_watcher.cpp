@@ -0,0 +1,242 @@
+#include "shader_watcher.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <system_error>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace GameProgramming::Shader
+{
+
+namespace
+{
+
+// how long the files have to stay quiet before they are read; editors write a file in several steps
+constexpr std::chrono::milliseconds SettleTime{100};
+
+// The directory is resolved, not the file: editors that save by renaming a new file over the old one replace
+// the directory entry, and that entry is what the change notifications name.
+std::filesystem::path watchedPath(const std::filesystem::path &file)
+{
+    std::error_code error;
+    const std::filesystem::path absolute = std::filesystem::absolute(file, error);
+    const std::filesystem::path directory = std::filesystem::weakly_canonical(absolute.parent_path(), error);
+    return (error ? absolute.parent_path() : directory) / absolute.filename();
+}
+
+std::optional<std::string> readSource(const std::filesystem::path &file)
+{
+    std::ifstream stream{file, std::ios::binary};
+    if (!stream.is_open())
+        return std::nullopt;
+
+    std::stringstream ss{};
+    ss << stream.rdbuf();
+    return stream.bad() ? std::nullopt : std::optional<std::string>{ss.str()};
+}
+
+} // namespace
+
+ShaderWatcher::ShaderWatcher()
+{
+#ifdef __linux__
+    m_notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    m_thread = std::thread{&ShaderWatcher::run, this};
+}
+
+ShaderWatcher::~ShaderWatcher()
+{
+    m_stop = true;
+    m_thread.join();
+#ifdef __linux__
+    if (m_notifyFd >= 0)
+        close(m_notifyFd);
+#endif
+}
+
+void ShaderWatcher::add(std::vector<std::filesystem::path> files, std::function<void(const std::vector<std::string> &)> beginReload,
+                        std::function<bool()> pollReload)
+{
+    m_programs.push_back({.beginReload = std::move(beginReload), .pollReload = std::move(pollReload)});
+
+    for (std::filesystem::path &file : files)
+    {
+        file = watchedPath(file);
+    }
+
+    std::lock_guard lock{m_mutex};
+#ifdef __linux__
+    if (m_notifyFd >= 0)
+    {
+        for (const std::filesystem::path &file : files)
+        {
+            const std::filesystem::path directory = file.parent_path();
+            const bool watched = std::any_of(m_directoryWatches.begin(), m_directoryWatches.end(),
+                                             [&directory](const auto &watch) { return watch.second == directory; });
+            if (watched)
+                continue;
+
+            const int wd = inotify_add_watch(m_notifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+            if (wd >= 0)
+                m_directoryWatches.emplace_back(wd, directory);
+        }
+    }
+#endif
+    m_files.push_back(std::move(files));
+}
+
+void ShaderWatcher::update()
+{
+    std::vector<Change> changes;
+    {
+        std::lock_guard lock{m_mutex};
+        changes.swap(m_changes);
+    }
+
+    for (const Change &change : changes)
+    {
+        Program &program = m_programs[change.program];
+        program.beginReload(change.sources);
+        program.reloading = true;
+    }
+
+    // a program only changes hands here, between two frames, and only once the rebuilt one has linked
+    for (Program &program : m_programs)
+    {
+        if (program.reloading && program.pollReload())
+            program.reloading = false;
+    }
+}
+
+void ShaderWatcher::run()
+{
+    std::vector<std::filesystem::path> changed;
+
+#ifdef __linux__
+    if (m_notifyFd >= 0)
+    {
+        alignas(inotify_event) char buffer[4096];
+        while (!m_stop)
+        {
+            pollfd fd{.fd = m_notifyFd, .events = POLLIN, .revents = 0};
+            if (poll(&fd, 1, static_cast<int>(SettleTime.count())) <= 0)
+            {
+                // quiet for a whole settle period: whatever changed before is complete now
+                if (!changed.empty())
+                {
+                    readChanged(changed);
+                    changed.clear();
+                }
+                continue;
+            }
+
+            const ssize_t length = read(m_notifyFd, buffer, sizeof(buffer));
+            std::lock_guard lock{m_mutex};
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                if (event->len == 0)
+                    continue;
+
+                const auto directory = std::find_if(m_directoryWatches.begin(), m_directoryWatches.end(),
+                                                    [event](const auto &watch) { return watch.first == event->wd; });
+                if (directory != m_directoryWatches.end())
+                    changed.push_back(directory->second / event->name);
+            }
+        }
+        return;
+    }
+#endif
+
+    // no change notifications: compare modification times a few times a second
+    std::vector<std::pair<std::filesystem::path, std::filesystem::file_time_type>> writeTimes;
+    while (!m_stop)
+    {
+        std::this_thread::sleep_for(SettleTime);
+
+        std::vector<std::filesystem::path> files;
+        {
+            std::lock_guard lock{m_mutex};
+            for (const auto &programFiles : m_files)
+            {
+                files.insert(files.end(), programFiles.begin(), programFiles.end());
+            }
+        }
+
+        for (const std::filesystem::path &file : files)
+        {
+            std::error_code error;
+            const auto writeTime = std::filesystem::last_write_time(file, error);
+            if (error)
+                continue; // in the middle of being replaced
+
+            auto known = std::find_if(writeTimes.begin(), writeTimes.end(), [&file](const auto &entry) { return entry.first == file; });
+            if (known == writeTimes.end())
+            {
+                writeTimes.emplace_back(file, writeTime);
+            }
+            else if (known->second != writeTime)
+            {
+                known->second = writeTime;
+                changed.push_back(file);
+            }
+        }
+
+        if (!changed.empty())
+        {
+            readChanged(changed);
+            changed.clear();
+        }
+    }
+}
+
+void ShaderWatcher::readChanged(const std::vector<std::filesystem::path> &changedFiles)
+{
+    std::vector<std::pair<std::size_t, std::vector<std::filesystem::path>>> affected;
+    {
+        std::lock_guard lock{m_mutex};
+        for (std::size_t program = 0; program < m_files.size(); ++program)
+        {
+            const auto &files = m_files[program];
+            const bool uses = std::any_of(files.begin(), files.end(), [&changedFiles](const std::filesystem::path &file) {
+                return std::find(changedFiles.begin(), changedFiles.end(), file) != changedFiles.end();
+            });
+            if (uses)
+                affected.emplace_back(program, files);
+        }
+    }
+
+    // all file reads happen here, off the render thread
+    for (const auto &[program, files] : affected)
+    {
+        Change change{.program = program, .sources = {}};
+        for (const std::filesystem::path &file : files)
+        {
+            std::optional<std::string> source = readSource(file);
+            if (!source)
+                break;
+            change.sources.push_back(std::move(*source));
+        }
+        if (change.sources.size() != files.size())
+            continue; // a file is gone for now, the write that brings it back is another change
+
+        std::lock_guard lock{m_mutex};
+        auto pending = std::find_if(m_changes.begin(), m_changes.end(), [program](const Change &queued) { return queued.program == program; });
+        if (pending != m_changes.end())
+            pending->sources = std::move(change.sources);
+        else
+            m_changes.push_back(std::move(change));
+    }
+}
+
+} // namespace GameProgramming::Shader
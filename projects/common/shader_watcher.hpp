@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GameProgramming::Shader
+{
+
+// Rebuilds programs whose GLSL files change on disk while the target runs. A background thread waits for
+// the files to change (inotify on Linux, modification times elsewhere) and reads the new sources; update()
+// hands them to the program on the render thread, and the program swaps in the rebuilt version only once it
+// has linked. A program that fails to compile or link keeps running the previous version.
+//
+// Programs are held by reference: declare the watcher after the programs it watches so it goes first.
+// Typed Uniform<T> handles taken from a program are invalid after it reloads; look them up per frame or
+// re-fetch them.
+class ShaderWatcher
+{
+public:
+    ShaderWatcher();
+    ~ShaderWatcher();
+    ShaderWatcher(const ShaderWatcher &) = delete;
+    ShaderWatcher &operator=(const ShaderWatcher &) = delete;
+    ShaderWatcher(ShaderWatcher &&) = delete;
+    ShaderWatcher &operator=(ShaderWatcher &&) = delete;
+
+    // `Program` is ShaderProgram or the learnopengl Shader: anything with sourceFiles(), beginReload() taking
+    // one source per file in the same order, and pollReload() returning true once the reload is settled.
+    template <typename Program>
+    void watch(Program &program)
+    {
+        std::vector<std::filesystem::path> files;
+        for (const auto &file : program.sourceFiles())
+        {
+            files.emplace_back(file);
+        }
+        add(std::move(files), [&program](const std::vector<std::string> &sources) { program.beginReload(sources); },
+            [&program]() { return program.pollReload(); });
+    }
+
+    // Call once per frame before anything is drawn: starts rebuilding the programs whose files changed and
+    // swaps in the ones that finished linking since the last call.
+    void update();
+
+private:
+    struct Program
+    {
+        std::function<void(const std::vector<std::string> &)> beginReload;
+        std::function<bool()> pollReload;
+        bool reloading = false;
+    };
+
+    struct Change
+    {
+        std::size_t program;
+        std::vector<std::string> sources;
+    };
+
+    void add(std::vector<std::filesystem::path> files, std::function<void(const std::vector<std::string> &)> beginReload,
+             std::function<bool()> pollReload);
+    void run();
+    // reads the current sources of every program that uses one of `changedFiles` and queues them for update()
+    void readChanged(const std::vector<std::filesystem::path> &changedFiles);
+
+    std::vector<Program> m_programs; // render thread only
+
+    std::mutex m_mutex; // guards everything below that the watcher thread touches
+    std::vector<std::vector<std::filesystem::path>> m_files; // per program, canonical
+    std::vector<Change> m_changes;                            // newest sources per program, not picked up yet
+
+    int m_notifyFd = -1; // inotify instance, -1 if the thread polls modification times
+    std::vector<std::pair<int, std::filesystem::path>> m_directoryWatches;
+
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+};
+
+} // namespace GameProgramming::Shader
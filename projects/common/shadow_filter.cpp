@@ -0,0 +1,58 @@
+#include "shadow_filter.hpp"
+
+namespace GameProgramming::GL
+{
+
+const char *shadowFilterName(ShadowFilter filter) noexcept
+{
+    switch (filter)
+    {
+    case ShadowFilter::Hard:
+        return "hard";
+    case ShadowFilter::HardwarePcf:
+        return "hardware PCF";
+    case ShadowFilter::PoissonPcf:
+        return "Poisson PCF";
+    case ShadowFilter::Pcss:
+        return "PCSS";
+    }
+    return "unknown";
+}
+
+ShadowSamplers::ShadowSamplers()
+{
+    constexpr GLfloat border[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    const auto sampler = [&](GLuint &id, GLint filter) {
+        glGenSamplers(1, &id);
+        glSamplerParameteri(id, GL_TEXTURE_MIN_FILTER, filter);
+        glSamplerParameteri(id, GL_TEXTURE_MAG_FILTER, filter);
+        glSamplerParameteri(id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glSamplerParameteri(id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glSamplerParameterfv(id, GL_TEXTURE_BORDER_COLOR, border);
+    };
+    sampler(m_depth, GL_NEAREST);
+    sampler(m_compare, GL_LINEAR);
+    // texture(shadowMap, vec4(uv, layer, reference)) is the lit fraction: 1 where reference <= stored depth
+    glSamplerParameteri(m_compare, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glSamplerParameteri(m_compare, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+}
+
+ShadowSamplers::~ShadowSamplers()
+{
+    glDeleteSamplers(1, &m_depth);
+    glDeleteSamplers(1, &m_compare);
+}
+
+void ShadowSamplers::bind(GLuint depthUnit, GLuint compareUnit) const noexcept
+{
+    glBindSampler(depthUnit, m_depth);
+    glBindSampler(compareUnit, m_compare);
+}
+
+void ShadowSamplers::unbind(GLuint depthUnit, GLuint compareUnit) noexcept
+{
+    glBindSampler(depthUnit, 0);
+    glBindSampler(compareUnit, 0);
+}
+
+} // namespace GameProgramming::GL
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "type.hpp"
+
+namespace GameProgramming::GL
+{
+
+// How a lit shader filters a shadow map lookup, from cheapest and hardest to dearest and softest. Shaders take
+// it as `uniform int shadowFilter` with these values:
+enum class ShadowFilter : u32
+{
+    Hard,        // one nearest depth compare
+    HardwarePcf, // one comparison sample: the texture unit compares 2x2 texels and filters the results bilinearly
+    PoissonPcf,  // 16 comparison samples on a Poisson disk, rotated per pixel to turn banding into noise
+    Pcss,        // percentage closer soft shadows: a blocker search sizes the Poisson disk by the penumbra
+};
+
+inline constexpr u32 ShadowFilterCount = 4;
+
+[[nodiscard]] const char *shadowFilterName(ShadowFilter filter) noexcept;
+
+// Two sampler objects to read one depth texture through two units at once: raw depth, for Hard and the PCSS
+// blocker search (uniform sampler2DArray), and GL_COMPARE_REF_TO_TEXTURE with linear filtering for the PCF
+// samples (uniform sampler2DArrayShadow). Both clamp to a border at the far plane, so lookups off the map are
+// unshadowed.
+class ShadowSamplers
+{
+public:
+    ShadowSamplers();
+    ~ShadowSamplers();
+    ShadowSamplers(const ShadowSamplers &) = delete;
+    ShadowSamplers &operator=(const ShadowSamplers &) = delete;
+    ShadowSamplers(ShadowSamplers &&) = delete;
+    ShadowSamplers &operator=(ShadowSamplers &&) = delete;
+
+    // The depth texture has to be bound to both units; the samplers override its own parameters there.
+    void bind(GLuint depthUnit, GLuint compareUnit) const noexcept;
+    // Hands the units back to the parameters of the textures bound to them.
+    static void unbind(GLuint depthUnit, GLuint compareUnit) noexcept;
+
+private:
+    GLuint m_depth = 0;
+    GLuint m_compare = 0;
+};
+
+} // namespace GameProgramming::GL
@@ -0,0 +1,59 @@
+#include "skeleton.hpp"
+
+#include <glm/ext/matrix_float3x3.hpp>
+#include <glm/ext/vector_float4.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <stdexcept>
+
+namespace GameProgramming::Animation
+{
+
+u32 Skeleton::addBone(i32 parent, const glm::vec3 &offset, const glm::vec3 &tail, const glm::vec3 &shapeScale)
+{
+    if (parent < Root || parent >= static_cast<i32>(m_parents.size()))
+        throw std::invalid_argument{"A bone's parent must be the root or a bone added before it"};
+
+    m_parents.push_back(parent);
+    m_offsets.push_back(offset);
+    m_tails.push_back(tail);
+    m_shapeScales.push_back(shapeScale);
+    return static_cast<u32>(m_parents.size() - 1);
+}
+
+void Skeleton::computeWorld(const glm::mat4 &model, const glm::quat *rotations, glm::mat4 *world) const noexcept
+{
+    const u32 count = boneCount();
+    for (u32 bone = 0; bone < count; ++bone)
+    {
+        // T(offset) * R * T(tail) built directly: the rotation block plus one translation column
+        const glm::mat3 rotation = glm::mat3_cast(rotations[bone]);
+        const glm::vec3 translation = m_offsets[bone] + rotation * m_tails[bone];
+        const glm::mat4 local(glm::vec4(rotation[0], 0.0f), glm::vec4(rotation[1], 0.0f), glm::vec4(rotation[2], 0.0f),
+                              glm::vec4(translation, 1.0f));
+
+        const i32 parent = m_parents[bone];
+        world[bone] = (parent == Root ? model : world[parent]) * local;
+    }
+}
+
+void Skeleton::computeShapes(const glm::mat4 *world, glm::mat4 *shapes) const noexcept
+{
+    const u32 count = boneCount();
+    for (u32 bone = 0; bone < count; ++bone)
+    {
+        const glm::vec3 &scale = m_shapeScales[bone];
+        shapes[bone] = glm::mat4(world[bone][0] * scale.x, world[bone][1] * scale.y, world[bone][2] * scale.z, world[bone][3]);
+    }
+}
+
+void Skeleton::computeSkinning(const glm::mat4 *world, const glm::mat4 *inverseBind, glm::mat4 *skin) const noexcept
+{
+    const u32 count = boneCount();
+    for (u32 bone = 0; bone < count; ++bone)
+    {
+        skin[bone] = world[bone] * inverseBind[bone];
+    }
+}
+
+} // namespace GameProgramming::Animation
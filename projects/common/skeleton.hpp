@@ -0,0 +1,49 @@
+#pragma once
+
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/ext/quaternion_float.hpp>
+#include <glm/ext/vector_float3.hpp>
+
+#include "type.hpp"
+
+#include <vector>
+
+namespace GameProgramming::Animation
+{
+
+// A bone hierarchy as flat arrays in topological order: every bone's parent comes before it, so one forward
+// pass over the arrays visits parents first and computes every world matrix from an already computed one.
+//
+// A bone's local transform is T(offset) * R(rotation) * T(tail): `offset` is where its joint sits in the
+// parent's frame, the pose supplies the rotation about that joint, and `tail` moves the frame the children
+// attach to (and the drawn shape hangs from) after rotating, e.g. down to the end of a leg bone. The shape
+// scale only sizes the drawn bone and is not inherited.
+class Skeleton
+{
+public:
+    static constexpr i32 Root = -1; // parent of bones attached straight to the character's model matrix
+
+    // Appends a bone and returns its index. Throws std::invalid_argument unless `parent` is Root or an earlier bone.
+    u32 addBone(i32 parent, const glm::vec3 &offset, const glm::vec3 &tail, const glm::vec3 &shapeScale);
+
+    [[nodiscard]] u32 boneCount() const noexcept { return static_cast<u32>(m_parents.size()); }
+    [[nodiscard]] i32 parent(u32 bone) const noexcept { return m_parents[bone]; }
+    [[nodiscard]] const glm::vec3 &tail(u32 bone) const noexcept { return m_tails[bone]; }
+    [[nodiscard]] const glm::vec3 &shapeScale(u32 bone) const noexcept { return m_shapeScales[bone]; }
+
+    // Joint frames of every bone for boneCount() local `rotations`, in one pass, into `world`.
+    void computeWorld(const glm::mat4 &model, const glm::quat *rotations, glm::mat4 *world) const noexcept;
+    // The drawn shapes: `world` with each bone's shape scale applied. `shapes` may alias `world`.
+    void computeShapes(const glm::mat4 *world, glm::mat4 *shapes) const noexcept;
+    // The skinning palette: `world` times the inverse of each bone's joint frame in the bind pose, so a vertex
+    // given in the bind pose's model space follows its bone. `skin` may alias `world`.
+    void computeSkinning(const glm::mat4 *world, const glm::mat4 *inverseBind, glm::mat4 *skin) const noexcept;
+
+private:
+    std::vector<i32> m_parents;
+    std::vector<glm::vec3> m_offsets;
+    std::vector<glm::vec3> m_tails;
+    std::vector<glm::vec3> m_shapeScales;
+};
+
+} // namespace GameProgramming::Animation
@@ -0,0 +1,114 @@
+#include "skinned_mesh.hpp"
+
+#include <glm/ext/matrix_float3x3.hpp>
+#include <glm/ext/vector_float4.hpp>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace GameProgramming::Animation
+{
+
+namespace
+{
+
+u8 unorm8(float value)
+{
+    return static_cast<u8>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+// the four sides of the unit bone shape, x and z in [-0.5, 0.5], y in [0, 1]: outward normal, then the
+// horizontal direction the side's edge runs in, counterclockwise seen from outside
+struct Side
+{
+    glm::vec3 normal;
+    glm::vec3 along;
+};
+constexpr Side Sides[] = {
+    {{0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}},
+    {{1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}},
+    {{0.0f, 0.0f, -1.0f}, {-1.0f, 0.0f, 0.0f}},
+    {{-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}},
+};
+
+} // namespace
+
+SkinnedMesh buildSkinnedBones(const Skeleton &skeleton, const glm::quat *bindRotations, const glm::vec3 *boneColors, u32 rings,
+                              float blendDistance)
+{
+    const u32 boneCount = skeleton.boneCount();
+    rings = std::max(rings, 1u);
+    const std::size_t vertexCount = static_cast<std::size_t>(boneCount) * (4 * 2 * (rings + 1) + 2 * 4);
+    if (boneCount > 256 || vertexCount > std::numeric_limits<u16>::max() + std::size_t{1})
+        throw std::invalid_argument{"A skinned mesh indexes at most 256 bones and 65536 vertices"};
+
+    std::vector<glm::mat4> bind(boneCount);
+    skeleton.computeWorld(glm::mat4(1.0f), bindRotations, bind.data());
+
+    SkinnedMesh mesh;
+    mesh.vertices.reserve(vertexCount);
+    mesh.indices.reserve(static_cast<std::size_t>(boneCount) * (4 * rings + 2) * 6);
+    mesh.inverseBind.resize(boneCount);
+    for (u32 bone = 0; bone < boneCount; ++bone)
+    {
+        mesh.inverseBind[bone] = glm::inverse(bind[bone]);
+
+        const glm::vec3 &scale = skeleton.shapeScale(bone);
+        const glm::mat3 rotation(bind[bone]);
+        const i32 parent = skeleton.parent(bone);
+        // the joint sits at -tail in the bone's frame: at the shape's foot for bones that rotate and then
+        // extend, at its head for the legs, which rotate at the top and hang down
+        const float jointY = std::clamp(-skeleton.tail(bone).y / scale.y, 0.0f, 1.0f);
+        const u8 color[4] = {unorm8(boneColors[bone].r), unorm8(boneColors[bone].g), unorm8(boneColors[bone].b), 0};
+
+        const auto addVertex = [&](const glm::vec3 &unit, const glm::vec3 &normal)
+        {
+            float parentWeight = 0.0f;
+            if (parent != Skeleton::Root && blendDistance > 0.0f)
+                parentWeight = 0.5f * std::max(0.0f, 1.0f - std::abs(unit.y - jointY) * scale.y / blendDistance);
+            const u8 toParent = unorm8(parentWeight);
+
+            SkinnedVertex vertex{};
+            vertex.position = glm::vec3(bind[bone] * glm::vec4(unit * scale, 1.0f));
+            vertex.normal = rotation * normal;
+            std::copy(color, color + 4, vertex.color);
+            vertex.bones[0] = static_cast<u8>(bone);
+            vertex.bones[1] = static_cast<u8>(parent == Skeleton::Root ? bone : parent);
+            vertex.weights[0] = static_cast<u8>(255 - toParent);
+            vertex.weights[1] = toParent;
+            mesh.vertices.push_back(vertex);
+            return static_cast<u16>(mesh.vertices.size() - 1);
+        };
+        const auto addQuad = [&](u16 a, u16 b, u16 c, u16 d) { mesh.indices.insert(mesh.indices.end(), {a, b, c, a, c, d}); };
+
+        // sides: a column of rings per side, so every side keeps its own flat normal like the cubes
+        for (const Side &side : Sides)
+        {
+            const glm::vec3 center = 0.5f * side.normal;
+            u16 left = addVertex(center - 0.5f * side.along, side.normal);
+            u16 right = addVertex(center + 0.5f * side.along, side.normal);
+            for (u32 ring = 1; ring <= rings; ++ring)
+            {
+                const glm::vec3 up(0.0f, static_cast<float>(ring) / rings, 0.0f);
+                const u16 upperLeft = addVertex(center - 0.5f * side.along + up, side.normal);
+                const u16 upperRight = addVertex(center + 0.5f * side.along + up, side.normal);
+                addQuad(left, right, upperRight, upperLeft);
+                left = upperLeft;
+                right = upperRight;
+            }
+        }
+
+        // caps
+        const glm::vec3 down(0.0f, -1.0f, 0.0f), up(0.0f, 1.0f, 0.0f);
+        addQuad(addVertex({-0.5f, 0.0f, -0.5f}, down), addVertex({0.5f, 0.0f, -0.5f}, down), addVertex({0.5f, 0.0f, 0.5f}, down),
+                addVertex({-0.5f, 0.0f, 0.5f}, down));
+        addQuad(addVertex({-0.5f, 1.0f, 0.5f}, up), addVertex({0.5f, 1.0f, 0.5f}, up), addVertex({0.5f, 1.0f, -0.5f}, up),
+                addVertex({-0.5f, 1.0f, -0.5f}, up));
+    }
+    return mesh;
+}
+
+} // namespace GameProgramming::Animation
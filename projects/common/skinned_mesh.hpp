@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/ext/quaternion_float.hpp>
+#include <glm/ext/vector_float3.hpp>
+
+#include "skeleton.hpp"
+#include "type.hpp"
+
+#include <vector>
+
+namespace GameProgramming::Animation
+{
+
+// A vertex of a skinned mesh, in the bind pose's model space, following up to four bones.
+struct SkinnedVertex
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    u8 color[4];   // RGBA8, A unused
+    u8 bones[4];   // indices into the character's palette
+    u8 weights[4]; // normalized, summing to 255
+};
+static_assert(sizeof(SkinnedVertex) == 36);
+
+// One mesh for a whole character: the vertices, the triangles over them and, per bone, the inverse of its
+// joint frame in the bind pose the vertices were built in (see Skeleton::computeSkinning).
+struct SkinnedMesh
+{
+    std::vector<SkinnedVertex> vertices;
+    std::vector<u16> indices;
+    std::vector<glm::mat4> inverseBind;
+};
+
+// Builds the bone shapes Skeleton::computeShapes draws as cubes as one skinned mesh, posed by `bindRotations`.
+// Each shape is cut into `rings` slices along its length; slices within `blendDistance` of the joint the bone
+// rotates about also follow the parent, half at the joint fading to none, so a bending joint stretches the
+// mesh smoothly instead of two boxes pivoting through each other. Bones on the root follow only themselves.
+// `boneColors` holds one color per bone. Throws std::invalid_argument for more than 256 bones or 65536 vertices.
+[[nodiscard]] SkinnedMesh buildSkinnedBones(const Skeleton &skeleton, const glm::quat *bindRotations, const glm::vec3 *boneColors,
+                                            u32 rings = 4, float blendDistance = 0.5f);
+
+} // namespace GameProgramming::Animation
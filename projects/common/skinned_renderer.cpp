@@ -0,0 +1,82 @@
+#include "skinned_renderer.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+
+namespace GameProgramming::Animation
+{
+
+void pointSkinnedVertexAttributes()
+{
+    constexpr GLsizei stride = sizeof(SkinnedVertex);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void *>(offsetof(SkinnedVertex, position)));
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void *>(offsetof(SkinnedVertex, normal)));
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, reinterpret_cast<void *>(offsetof(SkinnedVertex, color)));
+    glVertexAttribIPointer(3, 4, GL_UNSIGNED_BYTE, stride, reinterpret_cast<void *>(offsetof(SkinnedVertex, bones)));
+    glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, reinterpret_cast<void *>(offsetof(SkinnedVertex, weights)));
+    for (GLuint attribute = 0; attribute < 5; ++attribute)
+    {
+        glEnableVertexAttribArray(attribute);
+    }
+}
+
+SkinnedRenderer::SkinnedRenderer(const SkinnedMesh &mesh, u32 capacity, u32 regionCount)
+    : m_indexCount(static_cast<GLsizei>(mesh.indices.size())), m_boneCount(static_cast<u32>(mesh.inverseBind.size())),
+      m_capacity(capacity),
+      m_palettes(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(capacity) * m_boneCount * sizeof(glm::mat4), regionCount)
+{
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    if (static_cast<GLint64>(capacity) * m_boneCount * 4 * regionCount > maxTexels)
+        throw std::runtime_error{"Skinning palettes exceed GL_MAX_TEXTURE_BUFFER_SIZE"};
+
+    glGenVertexArrays(1, &m_vao);
+    glBindVertexArray(m_vao);
+
+    glGenBuffers(1, &m_vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mesh.vertices.size() * sizeof(SkinnedVertex)), mesh.vertices.data(),
+                 GL_STATIC_DRAW);
+    glGenBuffers(1, &m_indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(mesh.indices.size() * sizeof(u16)), mesh.indices.data(),
+                 GL_STATIC_DRAW);
+
+    pointSkinnedVertexAttributes();
+    glBindVertexArray(0);
+
+    // GL 3.3 has no glTexBufferRange: the texture spans every region and the shader adds the region's offset
+    glGenTextures(1, &m_paletteTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, m_paletteTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_palettes.buffer());
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+SkinnedRenderer::~SkinnedRenderer()
+{
+    glDeleteTextures(1, &m_paletteTexture);
+    glDeleteBuffers(1, &m_indexBuffer);
+    glDeleteBuffers(1, &m_vertexBuffer);
+    glDeleteVertexArrays(1, &m_vao);
+}
+
+glm::mat4 *SkinnedRenderer::beginFrame()
+{
+    return static_cast<glm::mat4 *>(m_palettes.beginWrite());
+}
+
+void SkinnedRenderer::draw(u32 count, GLint paletteOffsetLocation)
+{
+    const GLintptr offset = m_palettes.endWrite();
+    glUniform1i(paletteOffsetLocation, static_cast<GLint>(offset / static_cast<GLintptr>(sizeof(glm::mat4))));
+    glActiveTexture(GL_TEXTURE0 + PaletteUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, m_paletteTexture);
+
+    glBindVertexArray(m_vao);
+    if (count > 0)
+        glDrawElementsInstanced(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_SHORT, nullptr, static_cast<GLsizei>(count < m_capacity ? count : m_capacity));
+    glBindVertexArray(0);
+    m_palettes.fence();
+}
+
+} // namespace GameProgramming::Animation
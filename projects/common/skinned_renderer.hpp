@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/ext/matrix_float4x4.hpp>
+
+#include "skinned_mesh.hpp"
+#include "stream_buffer.hpp"
+#include "type.hpp"
+
+namespace GameProgramming::Animation
+{
+
+// Points attributes 0..4 at the SkinnedVertex array in the bound GL_ARRAY_BUFFER and enables them, as the
+// skinning programs read them: position, normal, color (vec4), bones (uvec4), weights (vec4).
+void pointSkinnedVertexAttributes();
+
+// Draws many characters of one SkinnedMesh with a single glDrawElementsInstanced: instance i is deformed in the
+// vertex shader by palette i, boneCount() skinning matrices (Skeleton::computeSkinning) streamed per frame
+// through a StreamBuffer behind a texture buffer. A character costs its palette, not draw calls.
+//
+// The program reads attributes 0 (position), 1 (normal), 2 (color, vec4), 3 (bones, uvec4) and 4 (weights,
+// vec4), and the palette as `samplerBuffer` on texture unit PaletteUnit, four RGBA32F texels per matrix, from
+// matrix `paletteOffset + gl_InstanceID * boneCount` on.
+//
+// Per frame: fill beginFrame() with up to `capacity` palettes, then draw(count, ...) with the program in use.
+class SkinnedRenderer
+{
+public:
+    static constexpr GLuint PaletteUnit = 0;
+
+    // Throws std::runtime_error if `capacity` palettes in every region exceed GL_MAX_TEXTURE_BUFFER_SIZE.
+    SkinnedRenderer(const SkinnedMesh &mesh, u32 capacity, u32 regionCount = GL::StreamBuffer::DefaultRegionCount);
+    ~SkinnedRenderer();
+    SkinnedRenderer(const SkinnedRenderer &) = delete;
+    SkinnedRenderer &operator=(const SkinnedRenderer &) = delete;
+    SkinnedRenderer(SkinnedRenderer &&) = delete;
+    SkinnedRenderer &operator=(SkinnedRenderer &&) = delete;
+
+    [[nodiscard]] u32 capacity() const noexcept { return m_capacity; }
+    [[nodiscard]] u32 boneCount() const noexcept { return m_boneCount; }
+
+    // capacity() palettes of boneCount() matrices, character after character. Write-only, see
+    // StreamBuffer::beginWrite().
+    [[nodiscard]] glm::mat4 *beginFrame();
+    // Draws the first `count` characters written since beginFrame(); `paletteOffsetLocation` is the program's
+    // int uniform `paletteOffset`.
+    void draw(u32 count, GLint paletteOffsetLocation);
+
+private:
+    GLuint m_vao = 0;
+    GLuint m_vertexBuffer = 0;
+    GLuint m_indexBuffer = 0;
+    GLuint m_paletteTexture = 0;
+    GLsizei m_indexCount;
+    u32 m_boneCount;
+    u32 m_capacity;
+    GL::StreamBuffer m_palettes;
+};
+
+} // namespace GameProgramming::Animation
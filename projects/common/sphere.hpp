@@ -0,0 +1,178 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/ext/vector_float3.hpp>
+#include <glm/geometric.hpp>
+
+#include "mesh_builder.hpp"
+#include "mesh_optimizer.hpp"
+#include "type.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+
+namespace GameProgramming::Mesh
+{
+
+struct SphereLod
+{
+    u32 segments;   // quads around the equator
+    u32 rings;      // quads from pole to pole
+    u32 baseVertex; // first vertex of the level in the shared VBO
+    u32 firstIndex; // first index of the level in the shared IBO
+    u32 indexCount;
+};
+
+// Unit uv sphere generated at every power of two resolution from MinSegments x MinSegments/2 up to
+// MaxSegments x MaxSegments/2, all levels packed into one vertex and one index buffer.
+// Vertex layout: position(3), normal(3), uv(2) at attribute locations 0, 1, 2, z is the polar axis.
+// Sines and cosines are tabulated once at the finest resolution; coarser levels take every n-th entry.
+template <u32 MinSegments = 8, u32 MaxSegments = 128>
+class SphereLodChain
+{
+    static_assert(std::has_single_bit(MinSegments) && std::has_single_bit(MaxSegments), "LOD resolutions are powers of two");
+    static_assert(MinSegments >= 4 && MinSegments <= MaxSegments);
+
+public:
+    static constexpr u32 FloatsPerVertex = 8;
+    static constexpr u32 LodCount = std::countr_zero(MaxSegments / MinSegments) + 1;
+    // on-screen length of an equator edge a level is allowed to reach before the next finer one is picked
+    static constexpr float TargetEdgePixels = 8.0f;
+
+    SphereLodChain();
+
+    [[nodiscard]] const IndexedMesh &mesh() const noexcept { return m_mesh; }
+    // level 0 is the coarsest
+    [[nodiscard]] const SphereLod &lod(u32 level) const noexcept { return m_lods[std::min(level, LodCount - 1)]; }
+
+    // Height in pixels of a sphere of `radius` seen from `distance` through a perspective projection.
+    [[nodiscard]] static float projectedDiameter(float radius, float distance, float fovY, float viewportHeight) noexcept;
+    // Coarsest level whose equator edges stay within TargetEdgePixels at the given on-screen diameter.
+    [[nodiscard]] static u32 selectLod(float projectedDiameterPixels) noexcept;
+    // Level for a unit sphere placed by `model` (uniform scale = radius), seen from `eye` with vertical `fovY`.
+    [[nodiscard]] static u32 selectLod(const glm::mat4 &model, const glm::vec3 &eye, float fovY, float viewportHeight) noexcept;
+
+    // Draws one level from the VAO that holds mesh() (must be bound).
+    void draw(u32 level) const noexcept;
+
+private:
+    IndexedMesh m_mesh;
+    std::array<SphereLod, LodCount> m_lods{};
+};
+
+template <u32 MinSegments, u32 MaxSegments>
+SphereLodChain<MinSegments, MaxSegments>::SphereLodChain()
+{
+    constexpr u32 maxRings = MaxSegments / 2;
+    std::array<float, MaxSegments + 1> cosU, sinU;
+    std::array<float, maxRings + 1> cosV, sinV;
+    for (u32 i = 0; i <= MaxSegments; ++i)
+    {
+        const double u = 2.0 * std::numbers::pi * (i % MaxSegments) / MaxSegments; // the seam column repeats column 0 exactly
+        cosU[i] = static_cast<float>(std::cos(u));
+        sinU[i] = static_cast<float>(std::sin(u));
+    }
+    for (u32 j = 0; j <= maxRings; ++j)
+    {
+        const double v = -0.5 * std::numbers::pi + std::numbers::pi * j / maxRings;
+        cosV[j] = (j == 0 || j == maxRings) ? 0.0f : static_cast<float>(std::cos(v)); // poles collapse to a point
+        sinV[j] = static_cast<float>(std::sin(v));
+    }
+
+    m_mesh.floatsPerVertex = FloatsPerVertex;
+    for (u32 level = 0; level < LodCount; ++level)
+    {
+        const u32 segments = MinSegments << level;
+        const u32 rings = segments / 2;
+        const u32 step = MaxSegments / segments;
+        const u32 columns = segments + 1;
+
+        IndexedMesh lodMesh;
+        lodMesh.floatsPerVertex = FloatsPerVertex;
+        lodMesh.vertices.reserve(std::size_t{rings + 1} * columns * FloatsPerVertex);
+        for (u32 j = 0; j <= rings; ++j)
+        {
+            for (u32 i = 0; i <= segments; ++i)
+            {
+                const float x = cosV[j * step] * cosU[i * step];
+                const float y = cosV[j * step] * sinU[i * step];
+                const float z = sinV[j * step];
+                const float u = static_cast<float>(i) / static_cast<float>(segments);
+                const float v = static_cast<float>(j) / static_cast<float>(rings);
+                lodMesh.vertices.insert(lodMesh.vertices.end(), {x, y, z, x, y, z, u, v});
+            }
+        }
+
+        // same winding as the old init_sphere quads; the triangle that would collapse onto a pole is left out
+        lodMesh.indices.reserve(std::size_t{segments} * (rings - 1) * 6);
+        for (u32 j = 0; j < rings; ++j)
+        {
+            for (u32 i = 0; i < segments; ++i)
+            {
+                const u32 a = j * columns + i;
+                const u32 b = a + 1;
+                const u32 c = a + columns;
+                const u32 d = c + 1;
+                if (j != 0)
+                    lodMesh.indices.insert(lodMesh.indices.end(), {a, b, c});
+                if (j != rings - 1)
+                    lodMesh.indices.insert(lodMesh.indices.end(), {b, d, c});
+            }
+        }
+        optimizeMesh(lodMesh);
+
+        m_lods[level] = {.segments = segments,
+                         .rings = rings,
+                         .baseVertex = m_mesh.vertexCount(),
+                         .firstIndex = m_mesh.indexCount(),
+                         .indexCount = lodMesh.indexCount()};
+        m_mesh.vertices.insert(m_mesh.vertices.end(), lodMesh.vertices.begin(), lodMesh.vertices.end());
+        m_mesh.indices.insert(m_mesh.indices.end(), lodMesh.indices.begin(), lodMesh.indices.end());
+    }
+}
+
+template <u32 MinSegments, u32 MaxSegments>
+float SphereLodChain<MinSegments, MaxSegments>::projectedDiameter(float radius, float distance, float fovY, float viewportHeight) noexcept
+{
+    if (distance <= radius)
+        return viewportHeight; // the camera is inside or touching it
+    return radius / (distance * std::tan(0.5f * fovY)) * viewportHeight;
+}
+
+template <u32 MinSegments, u32 MaxSegments>
+u32 SphereLodChain<MinSegments, MaxSegments>::selectLod(float projectedDiameterPixels) noexcept
+{
+    const float segmentsNeeded = std::numbers::pi_v<float> * projectedDiameterPixels / TargetEdgePixels;
+    u32 level = 0;
+    while (level + 1 < LodCount && static_cast<float>(MinSegments << level) < segmentsNeeded)
+    {
+        ++level;
+    }
+    return level;
+}
+
+template <u32 MinSegments, u32 MaxSegments>
+u32 SphereLodChain<MinSegments, MaxSegments>::selectLod(const glm::mat4 &model, const glm::vec3 &eye, float fovY, float viewportHeight) noexcept
+{
+    const float radius = glm::length(glm::vec3(model[0]));
+    const float distance = glm::distance(eye, glm::vec3(model[3]));
+    return selectLod(projectedDiameter(radius, distance, fovY, viewportHeight));
+}
+
+template <u32 MinSegments, u32 MaxSegments>
+void SphereLodChain<MinSegments, MaxSegments>::draw(u32 level) const noexcept
+{
+    const SphereLod &l = lod(level);
+    const IndexType indexType = m_mesh.indexType();
+    glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(l.indexCount), static_cast<GLenum>(indexType),
+                             reinterpret_cast<const void *>(static_cast<std::uintptr_t>(l.firstIndex) * indexSize(indexType)),
+                             static_cast<GLint>(l.baseVertex));
+}
+
+} // namespace GameProgramming::Mesh
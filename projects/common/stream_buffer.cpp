@@ -0,0 +1,88 @@
+#include "stream_buffer.hpp"
+
+#include "gl_extensions.hpp"
+
+#include <stdexcept>
+
+namespace GameProgramming::GL
+{
+
+StreamBuffer::StreamBuffer(GLenum target, GLsizeiptr regionSize, u32 regionCount)
+    : m_target(target), m_regionSize(regionSize), m_region(regionCount - 1), m_fences(regionCount, nullptr)
+{
+    if (regionSize <= 0 || regionCount == 0)
+        throw std::invalid_argument{"A stream buffer needs at least one non-empty region"};
+
+    const GLsizeiptr size = regionSize * regionCount;
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(m_target, m_buffer);
+    if (extensions().ARB_buffer_storage)
+    {
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        extensions().BufferStorage(m_target, size, nullptr, flags);
+        m_persistent = glMapBufferRange(m_target, 0, size, flags);
+        if (!m_persistent)
+        {
+            glDeleteBuffers(1, &m_buffer);
+            throw std::runtime_error{"Failed to map a persistent stream buffer"};
+        }
+    }
+    else
+    {
+        glBufferData(m_target, size, nullptr, GL_STREAM_DRAW);
+    }
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    for (GLsync fence : m_fences)
+    {
+        glDeleteSync(fence);
+    }
+    // deleting the buffer also unmaps a persistent mapping
+    glDeleteBuffers(1, &m_buffer);
+}
+
+void *StreamBuffer::beginWrite()
+{
+    m_region = (m_region + 1) % static_cast<u32>(m_fences.size());
+    if (GLsync &fence = m_fences[m_region])
+    {
+        GLenum status = GL_TIMEOUT_EXPIRED;
+        while (status == GL_TIMEOUT_EXPIRED)
+        {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000); // 1 ms
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    const GLintptr offset = m_regionSize * m_region;
+    glBindBuffer(m_target, m_buffer);
+    if (m_persistent)
+        return static_cast<char *>(m_persistent) + offset;
+
+    // the fence already guarantees the GPU is done with the region, the driver needs not check again
+    void *region = glMapBufferRange(m_target, offset, m_regionSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (!region)
+        throw std::runtime_error{"Failed to map a stream buffer region"};
+    return region;
+}
+
+GLintptr StreamBuffer::endWrite()
+{
+    if (!m_persistent)
+    {
+        glBindBuffer(m_target, m_buffer);
+        glUnmapBuffer(m_target);
+    }
+    return m_regionSize * m_region;
+}
+
+void StreamBuffer::fence()
+{
+    glDeleteSync(m_fences[m_region]);
+    m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+} // namespace GameProgramming::GL
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "type.hpp"
+
+#include <vector>
+
+namespace GameProgramming::GL
+{
+
+// Vertex data the CPU rewrites every frame, split into `regionCount` regions used round robin so the CPU
+// fills one while the GPU still draws from the others. A fence behind the draws of each region says when it
+// may be written again; the CPU only waits if it gets `regionCount` frames ahead.
+//
+// With GL_ARB_buffer_storage the buffer is mapped once, persistently and coherently. The GL 3.3 core
+// fallback maps the next region unsynchronized each frame, which after the fence is just as safe and skips
+// the driver's own synchronization and copy.
+class StreamBuffer
+{
+public:
+    static constexpr u32 DefaultRegionCount = 3;
+
+    StreamBuffer(GLenum target, GLsizeiptr regionSize, u32 regionCount = DefaultRegionCount);
+    ~StreamBuffer();
+    StreamBuffer(const StreamBuffer &) = delete;
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+    StreamBuffer(StreamBuffer &&) = delete;
+    StreamBuffer &operator=(StreamBuffer &&) = delete;
+
+    [[nodiscard]] GLuint buffer() const noexcept { return m_buffer; }
+    [[nodiscard]] GLsizeiptr regionSize() const noexcept { return m_regionSize; }
+    [[nodiscard]] bool persistent() const noexcept { return m_persistent != nullptr; }
+
+    // Waits until the next region is no longer read by the GPU and returns it for writing. The pointer may be
+    // write-combined memory: write it sequentially and never read from it. Binds the buffer to its target.
+    [[nodiscard]] void *beginWrite();
+    // Ends the write started by beginWrite(); returns the byte offset of the region for the draw calls.
+    GLintptr endWrite();
+    // Call after the last draw call that reads the region just written.
+    void fence();
+
+private:
+    GLenum m_target;
+    GLuint m_buffer = 0;
+    GLsizeiptr m_regionSize;
+    u32 m_region = 0; // the one being written, or the last one written
+    std::vector<GLsync> m_fences;
+    void *m_persistent = nullptr; // whole buffer, with ARB_buffer_storage
+};
+
+} // namespace GameProgramming::GL
@@ -4,6 +4,9 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include <charconv>
+#include <cstdlib>
+#include <cstddef>
 
 class Teapot
 {
@@ -18,33 +21,63 @@ public:
 		nVertNum = int(size(data) / nVertFloats);
 	};
 	bool loadVertexData(std::string filename, std::vector<float> &data) {
-		// read vertex data from vbo file in plain text format
-		std::ifstream input(filename.c_str());
+		// read vertex data from vbo file in plain text format:
+		// the float count, then that many whitespace separated floats
+		std::ifstream input(filename.c_str(), std::ios::binary | std::ios::ate);
 		if (!input) { // cast istream to bool to see if something went wrong
 			std::cerr << "Can not find vertex data file " << filename << std::endl;
 			return false;
 		}
 
-		int numFloats;
-		double vertData;
-		if (input >> numFloats) {
-			if (numFloats > 0) {
-				data.resize(numFloats);
-				int i = 0;
-				while (input >> vertData && i < numFloats) {
-					// store it in the vector
-					data[i] = float(vertData);
-					i++;
-				}
-				if (i != numFloats || numFloats % nVertFloats) return false;
-			}
+		// pull the whole file in with a single read and tokenize it in memory
+		std::string text(static_cast<std::size_t>(input.tellg()), '\0');
+		input.seekg(0);
+		if (!input.read(text.data(), static_cast<std::streamsize>(text.size()))) {
+			return false;
 		}
-		else {
+
+		const char* first = text.data();
+		const char* last = text.data() + text.size();
+		first = skipWhitespace(first, last);
+		int numFloats = 0;
+		auto [next, ec] = std::from_chars(first, last, numFloats);
+		if (ec != std::errc{}) {
 			return false;
 		}
+		if (numFloats > 0) {
+			data.resize(numFloats);
+			std::size_t i = parseFloats(next, last, data.data(), data.size());
+			if (i != std::size_t(numFloats) || numFloats % nVertFloats) return false;
+		}
 		return true;
 	}
 
-};
+	// parses up to `count` whitespace separated floats from [first, last) into `out`,
+	// returns how many were parsed before the text ran out or stopped being a number
+	static std::size_t parseFloats(const char* first, const char* last, float* out, std::size_t count) {
+		std::size_t i = 0;
+		while (i < count) {
+			first = skipWhitespace(first, last);
+			if (first == last) break;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+			auto [next, ec] = std::from_chars(first, last, out[i]);
+			if (ec != std::errc{}) break;
+#else
+			// standard libraries without floating point from_chars (older libc++)
+			char* next = nullptr;
+			out[i] = std::strtof(first, &next);
+			if (next == first) break;
 #endif
+			first = next;
+			i++;
+		}
+		return i;
+	}
 
+private:
+	static const char* skipWhitespace(const char* first, const char* last) {
+		while (first != last && (*first == ' ' || *first == '\n' || *first == '\r' || *first == '\t')) first++;
+		return first;
+	}
+};
+#endif
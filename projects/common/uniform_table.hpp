@@ -0,0 +1,309 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/ext/matrix_float3x3.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/ext/vector_float2.hpp>
+#include <glm/ext/vector_float3.hpp>
+#include <glm/ext/vector_float4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "type.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace GameProgramming::Shader
+{
+
+// Location of one uniform, resolved once and reused every frame. `T` is the C++ type the uniform is set from,
+// so a handle only fits the matching setUniform overload. An invalid handle (-1) is ignored by GL, same as
+// a name the program does not use.
+template <typename T>
+struct Uniform
+{
+    GLint location = -1;
+
+    [[nodiscard]] bool valid() const noexcept { return location >= 0; }
+};
+
+// Whether a uniform reflected with GL type `type` can be set from a `T`.
+template <typename T>
+[[nodiscard]] constexpr bool acceptsUniformType(GLenum type) noexcept
+{
+    if constexpr (std::is_same_v<T, float>)
+        return type == GL_FLOAT;
+    else if constexpr (std::is_same_v<T, int>)
+        return type == GL_INT || type == GL_BOOL || type == GL_SAMPLER_1D || type == GL_SAMPLER_2D || type == GL_SAMPLER_3D ||
+               type == GL_SAMPLER_CUBE || type == GL_SAMPLER_2D_SHADOW || type == GL_SAMPLER_2D_ARRAY ||
+               type == GL_SAMPLER_2D_ARRAY_SHADOW || type == GL_SAMPLER_BUFFER || type == GL_SAMPLER_2D_MULTISAMPLE;
+    else if constexpr (std::is_same_v<T, bool>)
+        return type == GL_BOOL || type == GL_INT;
+    else if constexpr (std::is_same_v<T, glm::vec2>)
+        return type == GL_FLOAT_VEC2;
+    else if constexpr (std::is_same_v<T, glm::vec3>)
+        return type == GL_FLOAT_VEC3;
+    else if constexpr (std::is_same_v<T, glm::vec4>)
+        return type == GL_FLOAT_VEC4;
+    else if constexpr (std::is_same_v<T, glm::mat3>)
+        return type == GL_FLOAT_MAT3;
+    else if constexpr (std::is_same_v<T, glm::mat4>)
+        return type == GL_FLOAT_MAT4;
+    else
+        return false;
+}
+
+inline void setUniform(Uniform<float> uniform, float value) noexcept { glUniform1f(uniform.location, value); }
+inline void setUniform(Uniform<int> uniform, int value) noexcept { glUniform1i(uniform.location, value); }
+inline void setUniform(Uniform<bool> uniform, bool value) noexcept { glUniform1i(uniform.location, static_cast<GLint>(value)); }
+inline void setUniform(Uniform<glm::vec2> uniform, const glm::vec2 &value) noexcept { glUniform2fv(uniform.location, 1, glm::value_ptr(value)); }
+inline void setUniform(Uniform<glm::vec3> uniform, const glm::vec3 &value) noexcept { glUniform3fv(uniform.location, 1, glm::value_ptr(value)); }
+inline void setUniform(Uniform<glm::vec4> uniform, const glm::vec4 &value) noexcept { glUniform4fv(uniform.location, 1, glm::value_ptr(value)); }
+inline void setUniform(Uniform<glm::mat3> uniform, const glm::mat3 &value) noexcept
+{
+    glUniformMatrix3fv(uniform.location, 1, GL_FALSE, glm::value_ptr(value));
+}
+inline void setUniform(Uniform<glm::mat4> uniform, const glm::mat4 &value) noexcept
+{
+    glUniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+// Every active default-block uniform of a linked program, reflected once with glGetActiveUniform so that
+// looking a uniform up by name afterwards never goes to the driver. Names live in one string buffer and are
+// found through an open addressing table of FNV-1a hashes. Array uniforms are reachable as "name", "name[0]",
+// ..., "name[n-1]".
+class UniformTable
+{
+public:
+    struct Entry
+    {
+        u64 hash;
+        u32 nameOffset;
+        u32 nameLength;
+        GLint location;
+        GLenum type; // GL_FLOAT_MAT4, GL_SAMPLER_2D, ...
+    };
+
+    UniformTable() = default;
+    explicit UniformTable(GLuint program) { reflect(program); }
+
+    // Replaces the table with the active uniforms of `program`, which must be linked.
+    void reflect(GLuint program);
+
+    [[nodiscard]] const Entry *find(std::string_view name) const noexcept;
+    [[nodiscard]] GLint location(std::string_view name) const noexcept
+    {
+        const Entry *entry = find(name);
+        return entry ? entry->location : -1;
+    }
+    // Invalid if the program has no active uniform `name` or its type cannot be set from a `T`.
+    template <typename T>
+    [[nodiscard]] Uniform<T> uniform(std::string_view name) const noexcept
+    {
+        const Entry *entry = find(name);
+        return entry && acceptsUniformType<T>(entry->type) ? Uniform<T>{entry->location} : Uniform<T>{};
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_entries.size(); }
+    [[nodiscard]] const std::vector<Entry> &entries() const noexcept { return m_entries; }
+    [[nodiscard]] std::string_view name(const Entry &entry) const noexcept { return {m_names.data() + entry.nameOffset, entry.nameLength}; }
+
+private:
+    static constexpr u32 EmptySlot = ~0u;
+
+    [[nodiscard]] static u64 hash(std::string_view name) noexcept
+    {
+        u64 h = 0xcbf29ce484222325ull;
+        for (char c : name)
+        {
+            h = (h ^ static_cast<u8>(c)) * 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    void add(std::string_view name, GLint location, GLenum type);
+
+    std::vector<Entry> m_entries;
+    std::vector<u32> m_slots; // power of two sized, at most half full, holds indices into m_entries
+    std::string m_names;
+};
+
+inline void UniformTable::reflect(GLuint program)
+{
+    m_entries.clear();
+    m_slots.clear();
+    m_names.clear();
+
+    GLint activeUniforms = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &activeUniforms);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    // every array element gets an entry of its own, so this is a lower bound
+    m_entries.reserve(static_cast<std::size_t>(activeUniforms));
+    m_slots.assign(std::bit_ceil(static_cast<std::size_t>(activeUniforms) * 2 + 2), EmptySlot);
+
+    std::string name(static_cast<std::size_t>(maxNameLength) + 1, '\0');
+    for (GLint i = 0; i < activeUniforms; ++i)
+    {
+        GLsizei length = 0;
+        GLint arraySize = 0;
+        GLenum type = GL_NONE;
+        glGetActiveUniform(program, static_cast<GLuint>(i), static_cast<GLsizei>(name.size()), &length, &arraySize, &type, name.data());
+        const std::string_view activeName{name.data(), static_cast<std::size_t>(length)};
+
+        const GLint location = glGetUniformLocation(program, name.c_str());
+        if (location < 0)
+            continue; // uniform block member, set through its buffer
+
+        add(activeName, location, type);
+        if (!activeName.ends_with("[0]"))
+            continue;
+
+        // arrays are reported as "name[0]"; the bare name and the other elements address the same array
+        const std::string_view baseName = activeName.substr(0, activeName.size() - 3);
+        add(baseName, location, type);
+        for (GLint element = 1; element < arraySize; ++element)
+        {
+            const std::string elementName = std::string{baseName} + '[' + std::to_string(element) + ']';
+            const GLint elementLocation = glGetUniformLocation(program, elementName.c_str());
+            if (elementLocation >= 0)
+            {
+                add(elementName, elementLocation, type);
+            }
+        }
+    }
+}
+
+inline void UniformTable::add(std::string_view name, GLint location, GLenum type)
+{
+    if ((m_entries.size() + 1) * 2 > m_slots.size())
+    {
+        m_slots.assign(m_slots.size() * 2, EmptySlot);
+        const std::size_t mask = m_slots.size() - 1;
+        for (u32 index = 0; index < m_entries.size(); ++index)
+        {
+            std::size_t slot = m_entries[index].hash & mask;
+            while (m_slots[slot] != EmptySlot)
+            {
+                slot = (slot + 1) & mask;
+            }
+            m_slots[slot] = index;
+        }
+    }
+
+    const u64 h = hash(name);
+    const std::size_t mask = m_slots.size() - 1;
+    std::size_t slot = h & mask;
+    while (m_slots[slot] != EmptySlot)
+    {
+        slot = (slot + 1) & mask;
+    }
+    m_slots[slot] = static_cast<u32>(m_entries.size());
+    m_entries.push_back({.hash = h,
+                         .nameOffset = static_cast<u32>(m_names.size()),
+                         .nameLength = static_cast<u32>(name.size()),
+                         .location = location,
+                         .type = type});
+    m_names.append(name);
+}
+
+inline const UniformTable::Entry *UniformTable::find(std::string_view name) const noexcept
+{
+    if (m_slots.empty())
+        return nullptr;
+
+    const u64 h = hash(name);
+    const std::size_t mask = m_slots.size() - 1;
+    for (std::size_t slot = h & mask; m_slots[slot] != EmptySlot; slot = (slot + 1) & mask)
+    {
+        const Entry &entry = m_entries[m_slots[slot]];
+        if (entry.hash == h && this->name(entry) == name)
+            return &entry;
+    }
+    return nullptr;
+}
+
+// Copies the current value of every uniform `to` shares (same name and type) with `from`, e.g. the sampler
+// units and constants a program was set up with once, when it is replaced by a rebuilt version of itself.
+// Array elements are entries of their own, so every element of an array present in both programs is copied.
+// Leaves `to` bound as the current program if `from` was, and the current program untouched otherwise.
+inline void copyUniformValues(GLuint from, const UniformTable &fromTable, GLuint to, const UniformTable &toTable)
+{
+    GLint current = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+    glUseProgram(to);
+
+    for (const UniformTable::Entry &entry : toTable.entries())
+    {
+        const UniformTable::Entry *source = fromTable.find(toTable.name(entry));
+        if (!source || source->type != entry.type)
+            continue;
+
+        GLfloat floats[16];
+        GLint integers[4];
+        switch (entry.type)
+        {
+        case GL_FLOAT_VEC2:
+            glGetUniformfv(from, source->location, floats);
+            glUniform2fv(entry.location, 1, floats);
+            break;
+        case GL_FLOAT_VEC3:
+            glGetUniformfv(from, source->location, floats);
+            glUniform3fv(entry.location, 1, floats);
+            break;
+        case GL_FLOAT_VEC4:
+            glGetUniformfv(from, source->location, floats);
+            glUniform4fv(entry.location, 1, floats);
+            break;
+        case GL_FLOAT_MAT2:
+            glGetUniformfv(from, source->location, floats);
+            glUniformMatrix2fv(entry.location, 1, GL_FALSE, floats);
+            break;
+        case GL_FLOAT_MAT3:
+            glGetUniformfv(from, source->location, floats);
+            glUniformMatrix3fv(entry.location, 1, GL_FALSE, floats);
+            break;
+        case GL_FLOAT_MAT4:
+            glGetUniformfv(from, source->location, floats);
+            glUniformMatrix4fv(entry.location, 1, GL_FALSE, floats);
+            break;
+        case GL_FLOAT:
+            glGetUniformfv(from, source->location, floats);
+            glUniform1fv(entry.location, 1, floats);
+            break;
+        case GL_INT_VEC2:
+        case GL_BOOL_VEC2:
+            glGetUniformiv(from, source->location, integers);
+            glUniform2iv(entry.location, 1, integers);
+            break;
+        case GL_INT_VEC3:
+        case GL_BOOL_VEC3:
+            glGetUniformiv(from, source->location, integers);
+            glUniform3iv(entry.location, 1, integers);
+            break;
+        case GL_INT_VEC4:
+        case GL_BOOL_VEC4:
+            glGetUniformiv(from, source->location, integers);
+            glUniform4iv(entry.location, 1, integers);
+            break;
+        default:
+            // int, bool and every sampler type hold a single integer
+            if (acceptsUniformType<int>(entry.type))
+            {
+                glGetUniformiv(from, source->location, integers);
+                glUniform1i(entry.location, integers[0]);
+            }
+            break;
+        }
+    }
+
+    glUseProgram(static_cast<GLuint>(current) == from ? to : static_cast<GLuint>(current));
+}
+
+} // namespace GameProgramming::Shader
@@ -0,0 +1,103 @@
+#include "weighted_oit.hpp"
+
+#include <stdexcept>
+
+namespace GameProgramming::GL
+{
+
+WeightedBlendedOit::WeightedBlendedOit(GLsizei width, GLsizei height) : m_width(width), m_height(height)
+{
+    create();
+    glGenVertexArrays(1, &m_vao);
+}
+
+WeightedBlendedOit::~WeightedBlendedOit()
+{
+    destroy();
+    glDeleteVertexArrays(1, &m_vao);
+}
+
+void WeightedBlendedOit::resize(GLsizei width, GLsizei height)
+{
+    if (width == m_width && height == m_height)
+        return;
+
+    m_width = width;
+    m_height = height;
+    destroy();
+    create();
+}
+
+void WeightedBlendedOit::beginAccumulate()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, m_width, m_height);
+
+    // nothing summed yet, everything behind fully revealed
+    constexpr GLfloat accumulation[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    constexpr GLfloat weight[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    glClearBufferfv(GL_COLOR, 0, accumulation);
+    glClearBufferfv(GL_COLOR, 1, weight);
+
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void WeightedBlendedOit::composite(GLuint framebuffer)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, m_width, m_height);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_accumulation);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, m_weight);
+    glActiveTexture(GL_TEXTURE0);
+
+    // the composite shader outputs (average color, 1 - revealage)
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(m_vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+}
+
+void WeightedBlendedOit::create()
+{
+    const auto target = [this](GLuint &texture, GLint format, GLenum channels) {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, m_width, m_height, 0, channels, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    };
+    target(m_accumulation, GL_RGBA16F, GL_RGBA);
+    target(m_weight, GL_R16F, GL_RED);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_accumulation, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, m_weight, 0);
+    constexpr GLenum drawBuffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers(2, drawBuffers);
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        destroy();
+        throw std::runtime_error{"Weighted blended OIT framebuffer is incomplete"};
+    }
+}
+
+void WeightedBlendedOit::destroy() noexcept
+{
+    glDeleteFramebuffers(1, &m_framebuffer);
+    glDeleteTextures(1, &m_accumulation);
+    glDeleteTextures(1, &m_weight);
+    m_framebuffer = m_accumulation = m_weight = 0;
+}
+
+} // namespace GameProgramming::GL
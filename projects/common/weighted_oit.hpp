@@ -0,0 +1,51 @@
+#pragma once
+
+#include <glad/glad.h>
+
+namespace GameProgramming::GL
+{
+
+// Weighted blended order-independent transparency (McGuire, Bavoil 2013): transparent fragments are summed
+// into two off-screen targets in any order, weighted by a function of depth and alpha, and resolved in one
+// full screen pass. No sorting, at the price of an approximation where surfaces of similar weight overlap.
+//
+// GL 3.3 has no per-target blend functions (glBlendFunci is GL 4.0), so both targets share
+// glBlendFuncSeparate(ONE, ONE, ZERO, ONE_MINUS_SRC_ALPHA) and the data is laid out to suit it:
+//   target 0, RGBA16F : rgb = sum(color * alpha * weight), a = product(1 - alpha), the revealage
+//   target 1, R16F    : r = sum(alpha * weight)
+// An accumulation shader writes vec4(color * alpha * weight, alpha) to location 0 and alpha * weight to
+// location 1; the composite shader reads them from texture units 0 and 1.
+class WeightedBlendedOit
+{
+public:
+    WeightedBlendedOit(GLsizei width, GLsizei height);
+    ~WeightedBlendedOit();
+    WeightedBlendedOit(const WeightedBlendedOit &) = delete;
+    WeightedBlendedOit &operator=(const WeightedBlendedOit &) = delete;
+    WeightedBlendedOit(WeightedBlendedOit &&) = delete;
+    WeightedBlendedOit &operator=(WeightedBlendedOit &&) = delete;
+
+    // Reallocates the targets when the size changed.
+    void resize(GLsizei width, GLsizei height);
+
+    // Binds and clears the targets and sets the blend state above; draw the transparent geometry after it.
+    void beginAccumulate();
+
+    // Draws a full screen triangle into `framebuffer` with the targets on texture units 0 and 1, blending the
+    // resolved color over what is there. The composite program has to be in use. Leaves GL_BLEND enabled with
+    // SRC_ALPHA, ONE_MINUS_SRC_ALPHA.
+    void composite(GLuint framebuffer = 0);
+
+private:
+    void create();
+    void destroy() noexcept;
+
+    GLsizei m_width;
+    GLsizei m_height;
+    GLuint m_framebuffer = 0;
+    GLuint m_accumulation = 0;
+    GLuint m_weight = 0;
+    GLuint m_vao = 0; // empty: the composite vertex shader makes the triangle from gl_VertexID
+};
+
+} // namespace GameProgramming::GL
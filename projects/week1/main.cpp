@@ -12,6 +12,7 @@
 #include "type.hpp"
 #include "logger.hpp"
 #include "shader.hpp"
+#include "gl_extensions.hpp"
 
 #include <iterator>
 #include <type_traits>
@@ -83,6 +84,7 @@ int main()
         glfwTerminate();
         exit(EXIT_FAILURE);
     }
+    GameProgramming::GL::loadExtensions(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
     glfwSwapInterval(1);
     LOG_DEBUG("GL_VERSION: {}", reinterpret_cast<const char *>(glGetString(GL_VERSION)));
 
@@ -13,9 +13,18 @@
 #include <glm/ext.hpp>
 
 #include "_shader.h"
+#include "gl_extensions.hpp"
+#include "constant_buffers.hpp"
+#include "cascaded_shadow_map.hpp"
+#include "gpu_timer.hpp"
+#include "shadow_filter.hpp"
 //#include "logger.hpp"
 #include "type.hpp"
 #include "camera.h"
+#include "sphere.hpp"
+
+#include <algorithm>
+#include <array>
 
 #ifndef RESOURCE_PATH_PREFIX
 #define RESOURCE_PATH_PREFIX ""
@@ -60,8 +69,9 @@ glm::vec3 diffuseColor = lightColor * glm::vec3(0.8f);   // decrease the influen
 glm::vec3 ambientColor = diffuseColor * glm::vec3(0.2f); // low influence
 
 // Ball
+using Sphere = GameProgramming::Mesh::SphereLodChain<8, 128>;
+const Sphere sphere; // all LODs, drawn from sphereVAO
 GLuint sphereVAO;
-int nSphereVert, nSphereAttr;
 float drag = 0.99f;
 float gravity_strength = 0.81f;
 glm::vec3 gravity(0.0f, -gravity_strength, 0.0f);
@@ -133,8 +143,22 @@ float lightCubeVertices[] = {
 };
 GLuint lightCubeVAO, lightCubeVBO, lightCubeTexture;
 
-// Shadow mapping
-GLuint depthMapFBO, depthMapTexture;
+// Shadow mapping: cascades fitted to the camera up to shadowDistance
+u32 shadowCascadeCount = 4;
+GLsizei shadowResolution = 1024;
+float shadowDistance = 40.0f;
+bool cacheStaticShadows = true; // keep the floor's depth, redraw only the ball into the shadow maps each frame
+GameProgramming::GL::ShadowFilter shadowFilter = GameProgramming::GL::ShadowFilter::PoissonPcf;
+float lightAngle = 0.05f; // PCSS penumbra width per unit of blocker to receiver distance
+
+// what renderScene draws
+enum SceneLayer : u32
+{
+    SCENE_STATIC = 1 << 0,  // casters that never move: the floor
+    SCENE_DYNAMIC = 1 << 1, // the ball
+    SCENE_DEBUG = 1 << 2,   // the light cube, which sits at the light and would shadow everything
+    SCENE_ALL = SCENE_STATIC | SCENE_DYNAMIC | SCENE_DEBUG
+};
 
 GLuint quadVBO, quadVAO;
 
@@ -143,8 +167,8 @@ void mouse_callback(GLFWwindow *window, double xpos, double ypos);
 void scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
 void processInput(GLFWwindow *window);
 void loadTexture(GLuint &textureID, const char *path);
-void init_sphere(float **, int *, int *);
-void renderScene(const Shader &shader);
+void updateBall();
+void renderScene(const Shader &shader, u32 layers = SCENE_ALL);
 void renderQuad();
 
 int main()
@@ -191,6 +215,7 @@ int main()
         glfwTerminate();
         exit(EXIT_FAILURE);
     }
+    GameProgramming::GL::loadExtensions(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
     glfwSwapInterval(1);
     glEnable(GL_DEPTH_TEST);
 #pragma endregion
@@ -214,25 +239,26 @@ int main()
 
 #pragma region Ball Setup
     loadTexture(ballTexture, RESOURCE_PATH_PREFIX "textures/2k_earth_daymap.jpg");
-    float *sphereVerts = nullptr;
-    init_sphere(&sphereVerts, &nSphereVert, &nSphereAttr);
     glGenVertexArrays(1, &sphereVAO);
     glBindVertexArray(sphereVAO);
     {
-        GLuint sphereVBO;
+        GLuint sphereVBO, sphereEBO;
         glGenBuffers(1, &sphereVBO);
         glBindBuffer(GL_ARRAY_BUFFER, sphereVBO);
-        glBufferData(GL_ARRAY_BUFFER, nSphereVert * nSphereAttr * sizeof(float), sphereVerts, GL_STATIC_DRAW);
-        free(sphereVerts);
+        sphere.mesh().uploadVertexData(GL_STATIC_DRAW);
+        glGenBuffers(1, &sphereEBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphereEBO);
+        sphere.mesh().uploadIndexData(GL_STATIC_DRAW);
 
+        constexpr GLsizei stride = Sphere::FloatsPerVertex * sizeof(float);
         // position attribute
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, nSphereAttr * sizeof(float), (const GLvoid *)0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (const GLvoid *)0);
         glEnableVertexAttribArray(0);
         // normal attribute
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, nSphereAttr * sizeof(float), (const GLvoid *)(3 * sizeof(float)));
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (const GLvoid *)(3 * sizeof(float)));
         glEnableVertexAttribArray(1);
         // texCoord attribute
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, nSphereAttr * sizeof(float), (const GLvoid *)(6 * sizeof(float)));
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (const GLvoid *)(6 * sizeof(float)));
         glEnableVertexAttribArray(2);
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -289,27 +315,11 @@ int main()
 #pragma endregion
 
 #pragma region Shadow map setup
-    constexpr u32 SHADOW_WIDTH = 1024, SHADOW_HEIGHT = 1024;
-    glGenTextures(1, &depthMapTexture);
-    glBindTexture(GL_TEXTURE_2D, depthMapTexture);
-    {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-        glGenFramebuffers(1, &depthMapFBO);
-        glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-        {
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthMapTexture, 0);
-            glDrawBuffer(GL_NONE);
-            glReadBuffer(GL_NONE);
-        }
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    }
-    glBindTexture(GL_TEXTURE_2D, 0);
-
+    GameProgramming::GL::CascadedShadowMap cascades{shadowCascadeCount, shadowResolution};
+    GameProgramming::GL::GpuTimer shadowTimer;
+    GameProgramming::GL::ShadowSamplers shadowSamplers;
+    std::array<GameProgramming::GL::GpuTimer, GameProgramming::GL::ShadowFilterCount> filterTimers; // the lit pass, per filter
+    u32 staticShadowRenders = 0;
 #pragma endregion
 
     Shader shader{RESOURCE_PATH_PREFIX "shaders/shadow_mapping.vs", RESOURCE_PATH_PREFIX "shaders/shadow_mapping.fs"};
@@ -319,10 +329,20 @@ int main()
     shader.use();
     shader.setInt("diffuseTexture", 0); // 텍스쳐 이미지는 glActiveTexture(GL_TEXTURE0)
     shader.setInt("shadowMap", 1);      // 쉐이더에서 사용하는 그림자 맵은 glActiveTexture(GL_TEXTURE1)
+    shader.setInt("shadowCompareMap", 2); // the same map through the comparison sampler
 
     //debugDepthQuad.use();
     //debugDepthQuad.setInt("depthMap", 0);
 
+    // matrices and positions both programs read, uploaded once per frame into a shared uniform buffer
+    enum RenderPass : u32
+    {
+        CameraPass,
+        ShadowPass, // the light is the camera, one pass per cascade from here on
+        RenderPassCount = ShadowPass + GameProgramming::GL::MaxShadowCascades
+    };
+    GameProgramming::Shader::ConstantBuffers constants{RenderPassCount};
+
     projection = glm::perspective(glm::radians(camera.Zoom), 1.0f * SCR_WIDTH / SCR_HEIGHT, 0.1f, 1000.0f);
     view = camera.GetViewMatrix();
 
@@ -344,54 +364,81 @@ int main()
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+        updateBall();
+
 #pragma region 1. Render Shadow map
-        float near = 1.0f, far = 20.f;
-        glm::mat4 light_projection = glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, near, far);
-        glm::mat4 light_view = glm::lookAt(lightPos, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        glm::mat4 lightSpaceMatrix = light_projection * light_view;
+        projection = glm::perspective(glm::radians(camera.Zoom), 1.0f * SCR_WIDTH / SCR_HEIGHT, 0.1f, 1000.0f);
+        view = camera.GetViewMatrix();
+        // a directional light shining from lightPos towards the origin
+        cascades.update(view, glm::radians(camera.Zoom), 1.0f * SCR_WIDTH / SCR_HEIGHT, 0.1f, shadowDistance, glm::normalize(-lightPos));
 
-        depthShader.use();
-        depthShader.setMat4("lightSpaceMatrix", lightSpaceMatrix);
+        GameProgramming::Shader::FrameConstants &frame = constants.frame();
+        frame.lightPos = lightPos;
+        frame.time = currentFrame;
+        for (u32 i = 0; i < cascades.cascadeCount(); ++i)
+        {
+            GameProgramming::Shader::PassConstants &shadowPass = constants.pass(ShadowPass + i);
+            shadowPass.view = cascades.lightView();
+            shadowPass.projection = cascades.projection(i);
+            shadowPass.viewProjection = cascades.matrix(i);
+            shadowPass.viewPos = lightPos;
+        }
+        GameProgramming::Shader::PassConstants &cameraPass = constants.pass(CameraPass);
+        cameraPass.view = view;
+        cameraPass.projection = projection;
+        cameraPass.viewProjection = projection * view;
+        cameraPass.viewPos = camera.Position;
+        constants.upload();
+        cascades.upload();
 
-        glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-        glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-        glClear(GL_DEPTH_BUFFER_BIT);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, woodTexture);
+        shadowTimer.begin();
         glCullFace(GL_FRONT);
-        renderScene(depthShader);
+        for (u32 i = 0; i < cascades.cascadeCount(); ++i)
+        {
+            constants.bindPass(ShadowPass + i);
+            if (cacheStaticShadows)
+            {
+                if (cascades.beginStatic(i))
+                    renderScene(depthShader, SCENE_STATIC);
+                cascades.beginDynamic(i);
+                renderScene(depthShader, SCENE_DYNAMIC);
+            }
+            else
+            {
+                cascades.beginCascade(i);
+                renderScene(depthShader, SCENE_STATIC | SCENE_DYNAMIC);
+            }
+        }
         glCullFace(GL_BACK);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        cascades.end();
+        shadowTimer.end();
+        shadowTimer.poll();
+        staticShadowRenders = cascades.takeStaticRenderCount();
 #pragma endregion
 
 #pragma region 2. Render normally
         glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        shader.use();
-        projection = glm::perspective(glm::radians(camera.Zoom), 1.0f * SCR_WIDTH / SCR_HEIGHT, 0.1f, 1000.0f);
-        view = camera.GetViewMatrix();
-        shader.setMat4("projection", projection);
-        shader.setMat4("view", view);
-
-        shader.setVec3("viewPos", camera.Position);
-        shader.setVec3("lightPos", lightPos);
-        shader.setMat4("lightSpaceMatrix", lightSpaceMatrix);
+        constants.bindPass(CameraPass);
 
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, woodTexture);
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, depthMapTexture);
+        cascades.bindTexture(1);
+        cascades.bindTexture(2);
+        shadowSamplers.bind(1, 2);
+        shader.use();
+        shader.setInt("shadowFilter", static_cast<int>(shadowFilter));
+        shader.setFloat("lightAngle", lightAngle);
 
+        GameProgramming::GL::GpuTimer &filterTimer = filterTimers[static_cast<u32>(shadowFilter)];
+        filterTimer.begin();
         renderScene(shader);
-#pragma endregion
-
-#pragma region 3. Optionally render shadow map on a quad
-        // debugDepthQuad.use();
-        // debugDepthQuad.setFloat("near_plane", near);
-        // debugDepthQuad.setFloat("far_plane", far);
-        // glActiveTexture(GL_TEXTURE0);
-        // glBindTexture(GL_TEXTURE_2D, depthMapTexture);
-        // renderQuad();
+        filterTimer.end();
+        GameProgramming::GL::ShadowSamplers::unbind(1, 2);
+        for (GameProgramming::GL::GpuTimer &timer : filterTimers)
+            timer.poll();
 #pragma endregion
 
         if (showImGuiOverlay)
@@ -418,6 +465,48 @@ int main()
                     ambientColor = diffuseColor * glm::vec3(0.2f);
                     ImGui::SliderFloat3("Light Position", glm::value_ptr(lightPos), -3.0f, 3.0f, "%.3f");
                 }
+                if (ImGui::CollapsingHeader("Shadows"))
+                {
+                    constexpr GLsizei resolutions[] = {512, 1024, 2048, 4096};
+                    constexpr const char *resolutionNames[] = {"512", "1024", "2048", "4096"};
+                    int cascadeCount = static_cast<int>(shadowCascadeCount);
+                    int resolution = static_cast<int>(std::find(std::begin(resolutions), std::end(resolutions), shadowResolution) - std::begin(resolutions));
+                    ImGui::SliderInt("Cascades", &cascadeCount, 1, static_cast<int>(GameProgramming::GL::MaxShadowCascades));
+                    ImGui::Combo("Resolution", &resolution, resolutionNames, IM_ARRAYSIZE(resolutionNames));
+                    try
+                    {
+                        cascades.configure(static_cast<u32>(cascadeCount), resolutions[resolution]);
+                        shadowCascadeCount = cascades.cascadeCount();
+                        shadowResolution = cascades.resolution();
+                    }
+                    catch (const std::exception &e)
+                    {
+                        LOG_ERROR("{}", e.what());
+                    }
+                    ImGui::SliderFloat("Shadow Distance", &shadowDistance, 5.0f, 100.0f, "%.1f");
+                    if (ImGui::Checkbox("Cache Static Casters", &cacheStaticShadows))
+                        shadowTimer.reset();
+                    ImGui::Text("Shadow pass %.3f ms GPU, %u static layers redrawn", shadowTimer.lastMs(), staticShadowRenders);
+                    int filter = static_cast<int>(shadowFilter);
+                    for (u32 i = 0; i < GameProgramming::GL::ShadowFilterCount; ++i)
+                    {
+                        const auto mode = static_cast<GameProgramming::GL::ShadowFilter>(i);
+                        ImGui::RadioButton(GameProgramming::GL::shadowFilterName(mode), &filter, static_cast<int>(i));
+                        ImGui::SameLine();
+                        ImGui::Text("lit pass %.3f ms GPU", filterTimers[i].averageMs());
+                    }
+                    shadowFilter = static_cast<GameProgramming::GL::ShadowFilter>(filter);
+                    if (shadowFilter == GameProgramming::GL::ShadowFilter::Pcss)
+                        ImGui::SliderFloat("Light Angle", &lightAngle, 0.005f, 0.2f, "%.3f");
+                    float lambda = cascades.splitLambda();
+                    if (ImGui::SliderFloat("Split Lambda", &lambda, 0.0f, 1.0f, "%.2f"))
+                        cascades.setSplitLambda(lambda);
+                    for (u32 i = 0; i < cascades.cascadeCount(); ++i)
+                    {
+                        const glm::vec4 &split = cascades.constants().splits[i];
+                        ImGui::Text("Cascade %u: to %.2f, %.4f per texel", i, split.x, split.y);
+                    }
+                }
                 if (ImGui::CollapsingHeader("Ball Debug", ImGuiTreeNodeFlags_DefaultOpen))
                 {
                     ImGui::BeginDisabled();
@@ -470,12 +559,55 @@ void renderQuad()
     glBindVertexArray(0);
 }
 
-void renderScene(const Shader &shader)
+// advances the bouncing ball by deltaTime, once per frame
+void updateBall()
+{
+    if (ball_hasStopped)
+    {
+        ball_stopTimer += deltaTime;
+        LOG_INFO("Waiting... {:.2f}", ball_stopTimer);
+
+        // Reset ball's properties
+        if (ball_stopTimer > ball_stopTimerInitialValue)
+        {
+            LOG_INFO("Waiting done. Resetting ball.");
+            ball_hasStopped = false;
+            ball_stopTimer = 0.0f;
+            ball_velocity = gravity_strength * ball_initialShootingDirection;
+            ball_currentPos = ball_initialPos;
+        }
+        return;
+    }
+
+    ball_velocity *= drag;
+
+    ball_currentPos = ball_currentPos + ball_velocity * deltaTime + 0.5f * gravity * deltaTime * deltaTime;
+    ball_velocity += gravity * deltaTime;
+
+    bool isTowardGravity = glm::dot(ball_velocity, gravity) > 0.0f;
+    // ball_radius가 반지름이 아니라 지름으로 적용되는 것 같아서 
+    // 땅바닥으로부터 반지름 길이만큼 떠있는지 검사하기 위해 0.52f 곱함
+    if (isTowardGravity && ball_currentPos.y <= ball_radius * 0.52f)
+    {
+        ball_velocity = 0.8f * glm::reflect(ball_velocity, glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+
+    // Finished bouncing
+    if (glm::length(ball_velocity) < 0.1f && ball_currentPos.y <= ball_radius * 0.52f)
+    {
+        LOG_INFO("Ball animation ended.");
+        ball_currentPos.y = ball_radius * 0.52f;
+        ball_hasStopped = true;
+    }
+}
+
+void renderScene(const Shader &shader, u32 layers)
 {
     glm::mat4 model = glm::identity<glm::mat4>();
     shader.use();
 
 #pragma region Draw floor
+    if (layers & SCENE_STATIC)
     {
         model = glm::scale(glm::identity<glm::mat4>(), glm::vec3(1.f));
         shader.setMat4("model", model);
@@ -487,6 +619,7 @@ void renderScene(const Shader &shader)
 #pragma endregion
 
 #pragma region Draw Light Cube(debug)
+    if (layers & SCENE_DEBUG)
     {
         model = glm::scale(glm::translate(glm::identity<glm::mat4>(), lightPos), glm::vec3(0.2f));
         shader.setMat4("model", model);
@@ -500,64 +633,20 @@ void renderScene(const Shader &shader)
 #pragma endregion
 
 #pragma region Draw ball
+    if (layers & SCENE_DYNAMIC)
     {
-        auto drawBall = [&]() -> void
-        {
-            model = glm::translate(glm::identity<glm::mat4>(), ball_currentPos);
-            model = glm::scale(model, ball_radius * glm::vec3(1.0f));
-            shader.setMat4("model", model);
-
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, ballTexture);
-
-            glBindVertexArray(sphereVAO);
-            glDrawArrays(GL_TRIANGLES, 0, nSphereVert);
-            glBindVertexArray(0);
-
-            glBindTexture(GL_TEXTURE_2D, 0);
-        };
-
-        if (ball_hasStopped)
-        {
-            ball_stopTimer += deltaTime;
-            LOG_INFO("Waiting... {:.2f}", ball_stopTimer);
-
-            // Reset ball's properties
-            if (ball_stopTimer > ball_stopTimerInitialValue)
-            {
-                LOG_INFO("Waiting done. Resetting ball.");
-                ball_hasStopped = false;
-                ball_stopTimer = 0.0f;
-                ball_velocity = gravity_strength * ball_initialShootingDirection;
-                ball_currentPos = ball_initialPos;
-            }
-
-            drawBall();
-            return;
-        }
-
-        ball_velocity *= drag;
-
-        ball_currentPos = ball_currentPos + ball_velocity * deltaTime + 0.5f * gravity * deltaTime * deltaTime;
-        ball_velocity += gravity * deltaTime;
+        model = glm::translate(glm::identity<glm::mat4>(), ball_currentPos);
+        model = glm::scale(model, ball_radius * glm::vec3(1.0f));
+        shader.setMat4("model", model);
 
-        bool isTowardGravity = glm::dot(ball_velocity, gravity) > 0.0f;
-        // ball_radius가 반지름이 아니라 지름으로 적용되는 것 같아서 
-        // 땅바닥으로부터 반지름 길이만큼 떠있는지 검사하기 위해 0.52f 곱함
-        if (isTowardGravity && ball_currentPos.y <= ball_radius * 0.52f)
-        {
-            ball_velocity = 0.8f * glm::reflect(ball_velocity, glm::vec3(0.0f, 1.0f, 0.0f));
-        }
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, ballTexture);
 
-        // Finished bouncing
-        if (glm::length(ball_velocity) < 0.1f && ball_currentPos.y <= ball_radius * 0.52f)
-        {
-            LOG_INFO("Ball animation ended.");
-            ball_currentPos.y = ball_radius * 0.52f;
-            ball_hasStopped = true;
-        }
+        glBindVertexArray(sphereVAO);
+        sphere.draw(Sphere::selectLod(model, camera.Position, glm::radians(camera.Zoom), SCR_HEIGHT));
+        glBindVertexArray(0);
 
-        drawBall();
+        glBindTexture(GL_TEXTURE_2D, 0);
     }
 #pragma endregion
 }
@@ -678,162 +767,4 @@ void loadTexture(GLuint &textureID, const char *path)
         LOG_ERROR("Failed to load texture at: {}", path);
     }
     stbi_image_free(data);
-}
-
-// initalize vertices of a sphere : position, normal, tex_coords.
-// void initSphere(std::vector <float> data, int* nVert, int* nAttr)
-void init_sphere(float **vertices, int *nVert, int *nAttr)
-{
-    //----------------------------------------
-    // sphere: set up vertex data and configure vertex attributes
-    float pi = acosf(-1.0f); // pi = 3.14152...
-    float pi2 = 2.0f * pi;
-    int nu = 40, nv = 20;
-    const double du = pi2 / nu;
-    const double dv = pi / nv;
-
-    *nVert = (nv - 1) * nu * 6; // two triangles
-    *nAttr = 8;
-    *vertices = (float *)malloc(sizeof(float) * (*nVert) * (*nAttr));
-
-    float u, v;
-    int k = 0;
-
-    v = 0.0f;
-    u = 0.0f;
-    for (v = (-0.5f) * pi + dv; v < 0.5f * pi - dv; v += dv)
-    {
-        for (u = 0.0f; u < pi2; u += du)
-        {
-            // p(u,v)
-            (*vertices)[k++] = cosf(v) * cosf(u);
-            (*vertices)[k++] = cosf(v) * sinf(u);
-            (*vertices)[k++] = sinf(v); // position
-            (*vertices)[k++] = cosf(v) * cosf(u);
-            (*vertices)[k++] = cosf(v) * sinf(u);
-            (*vertices)[k++] = sinf(v); // normal
-            (*vertices)[k++] = u / pi2;
-            (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-            // p(u+du,v)
-            (*vertices)[k++] = cosf(v) * cosf(u + du);
-            (*vertices)[k++] = cosf(v) * sinf(u + du);
-            (*vertices)[k++] = sinf(v); // position
-            (*vertices)[k++] = cosf(v) * cosf(u + du);
-            (*vertices)[k++] = cosf(v) * sinf(u + du);
-            (*vertices)[k++] = sinf(v); // normal
-            (*vertices)[k++] = (u + du) / pi2;
-            (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-            // p(u,v+dv)
-            (*vertices)[k++] = cosf(v + dv) * cosf(u);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u);
-            (*vertices)[k++] = sinf(v + dv); // position
-            (*vertices)[k++] = cosf(v + dv) * cosf(u);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u);
-            (*vertices)[k++] = sinf(v + dv); // normal
-            (*vertices)[k++] = u / pi2;
-            (*vertices)[k++] = (v + dv + 0.5f * pi) / pi; // texture coords
-
-            // p(u+du,v)
-            (*vertices)[k++] = cosf(v) * cosf(u + du);
-            (*vertices)[k++] = cosf(v) * sinf(u + du);
-            (*vertices)[k++] = sinf(v); // position
-            (*vertices)[k++] = cosf(v) * cosf(u + du);
-            (*vertices)[k++] = cosf(v) * sinf(u + du);
-            (*vertices)[k++] = sinf(v); // normal
-            (*vertices)[k++] = (u + du) / pi2;
-            (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-            // p(u+du,v+dv)
-            (*vertices)[k++] = cosf(v + dv) * cosf(u + du);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u + du);
-            (*vertices)[k++] = sinf(v + dv); // position
-            (*vertices)[k++] = cosf(v + dv) * cosf(u + du);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u + du);
-            (*vertices)[k++] = sinf(v + dv); // normal
-            (*vertices)[k++] = (u + du) / pi2;
-            (*vertices)[k++] = (v + dv + 0.5f * pi) / pi; // texture coords
-
-            // p(u,v+dv)
-            (*vertices)[k++] = cosf(v + dv) * cosf(u);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u);
-            (*vertices)[k++] = sinf(v + dv); // position
-            (*vertices)[k++] = cosf(v + dv) * cosf(u);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u);
-            (*vertices)[k++] = sinf(v + dv); // normal
-            (*vertices)[k++] = u / pi2;
-            (*vertices)[k++] = (v + dv + 0.5f * pi) / pi; // texture coords
-        }
-    }
-    // triangles around north pole and south pole
-    for (u = 0.0f; u < pi2; u += du)
-    {
-        // triangles around north pole
-        // p(u,pi/2-dv)
-        v = 0.5f * pi - dv;
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = u / pi2;
-        (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-        // p(u+du,pi/2-dv)
-        v = 0.5f * pi - dv;
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = (u + du) / pi2;
-        (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-        // p(u,pi/2) = (0, 1. 0)  ~ north pole
-        v = 0.5f * pi;
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = (u + du) / pi2;
-        (*vertices)[k++] = 1.0f; // texture coords
-
-        // triangles around south pole
-        // p(u,-pi/2) = (0, -1, 0)  ~ south pole
-        v = (-0.5f) * pi;
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = u / pi2;
-        (*vertices)[k++] = 0.0f; // texture coords
-
-        // p(u+du,-pi/2+dv)
-        v = (-0.5f) * pi + dv;
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = (u + du) / pi2;
-        (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-        // p(u,-pi/2+dv)
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = u / pi2;
-        (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-    }
 }
\ No newline at end of file
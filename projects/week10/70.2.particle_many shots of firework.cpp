@@ -11,25 +11,55 @@
 #include <glm/gtc/random.hpp>
 
 #include "_shader.h"
+#include "gl_extensions.hpp"
 #include "camera.h"
-
+#include "billboard_renderer.hpp"
+#include "gpu_timer.hpp"
+#include "job_system.hpp"
+#include "particle_pool.hpp"
+#include "particle_sort.hpp"
+#include "stream_buffer.hpp"
+#include "weighted_oit.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <string>
 #include <vector>
 
-#define nParticles 1000
-#define nVertAttri 6
+#define nParticles 100000
+#define nParticleCapacity (1u << 20)
 
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void processInput(GLFWwindow* window);
+int runBenchmark(GLFWwindow* window);
 unsigned int loadTexture(const char* path);
 unsigned int loadCubemap(std::vector<std::string> faces);
 
 // settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
+int framebufferWidth = SCR_WIDTH;
+int framebufferHeight = SCR_HEIGHT;
+
+const float nearPlane = 0.1f;
+const float farPlane = 100.0f;
+
+// how the transparent particles are blended, M cycles through them
+enum BlendMode
+{
+	BLEND_UNSORTED,	// buffer order: cheap, wrong wherever shells overlap
+	BLEND_SORTED,	// back to front by a parallel radix sort on the CPU
+	BLEND_OIT,		// weighted blended order-independent transparency, no sort
+	BLEND_MODE_COUNT
+};
+const char* blendModeNames[BLEND_MODE_COUNT] = { "unsorted", "depth sorted", "weighted blended OIT" };
+BlendMode blendMode = BLEND_SORTED;
+bool isMKeyPressed = false;
 
 // camera
 Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
@@ -40,8 +70,36 @@ bool firstMouse = true;
 // timing
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
+const float shotInterval = 0.5f;
+
+using GameProgramming::Particle::ParticleVertex;
 
-int main()
+// The GL side of the demo, shared by the render loop and the benchmark: an opaque ground, whose depth the
+// particles fade against (soft particles), and the particles as billboards in one of the blend modes.
+struct FireworkRenderer
+{
+	Shader billboardShader;
+	Shader oitShader;
+	Shader compositeShader;
+	Shader groundShader;
+	GameProgramming::GL::WeightedBlendedOit oit;
+	GameProgramming::GL::GpuTimer gpuTimer; // the particle passes only
+	unsigned int groundVAO, groundVBO;
+	unsigned int sceneDepthFBO, sceneDepthTexture;
+	int width, height;
+
+	FireworkRenderer(int width, int height);
+	~FireworkRenderer();
+	void draw(BlendMode mode, GameProgramming::Particle::BillboardRenderer& billboards, GLintptr offset, GLsizei count,
+		const glm::mat4& view, const glm::mat4& projection);
+};
+
+GLintptr updateParticles(BlendMode mode, GameProgramming::Particle::ParticlePool& particles, GameProgramming::Particle::DepthSorter& sorter,
+	std::vector<ParticleVertex>& unsortedVertices, GameProgramming::GL::StreamBuffer& particleVBO, float dt, const glm::vec3& gravity, float drag,
+	const glm::mat4& view);
+
+// run with --benchmark to print frame times of every blend mode at 10k, 100k and 1M particles
+int main(int argc, char** argv)
 {
 	// glfw: initialize and configure
 	// ------------------------------
@@ -64,6 +122,7 @@ int main()
 		return -1;
 	}
 	glfwMakeContextCurrent(window);
+	glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
 	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 	glfwSetCursorPosCallback(window, mouse_callback);
 	glfwSetScrollCallback(window, scroll_callback);
@@ -78,109 +137,105 @@ int main()
 		std::cout << "Failed to initialize GLAD" << std::endl;
 		return -1;
 	}
+	GameProgramming::GL::loadExtensions((GLADloadproc)glfwGetProcAddress);
+
+	if (argc > 1 && std::strcmp(argv[1], "--benchmark") == 0)
+		return runBenchmark(window);
 
 	// configure global opengl state
 	// -----------------------------
-	glDisable(GL_DEPTH_TEST);
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glPointSize(10.0f);
 
 
-	// build and compile shaders
-	// -------------------------
-	Shader particleShader(
-		RESOURCE_PATH_PREFIX "shaders/70.1.particle.vs",
-		RESOURCE_PATH_PREFIX "shaders/70.1.particle.fs");
+	// build and compile shaders, ground and render targets
+	// ----------------------------------------------------
+	FireworkRenderer renderer(framebufferWidth, framebufferHeight);
 
-	// set up vertex data (and buffer(s)) and configure vertex attributes
-	// ------------------------------------------------------------------
+	// particles live in a structure-of-arrays pool, integrated on every core
+	// ---------------------------------------------------------------------
 	float lifetime = 5.0f;
-	glm::vec3 gravity(0.0f, -0.1f, 0.0f);
+	// 70.1.particle.vs moves by gravity * t^2, i.e. accelerates by twice its gravity
+	glm::vec3 gravity(0.0f, -0.2f, 0.0f);
+	// 1/s, slows the sparks in proportion to their speed; 0 keeps the original ballistic arcs
+	float drag = 0.0f;
+
+	GameProgramming::Job::JobSystem jobs;
+	GameProgramming::Particle::ParticlePool particles(nParticleCapacity, jobs);
+	GameProgramming::Particle::DepthSorter sorter(jobs);
 
-	particleShader.use();
-	particleShader.setVec3("gravity", gravity);
-	particleShader.setFloat("lifetime", lifetime);
+	// the pool writes straight into a ring of mapped VBO regions the GPU is not reading from; when sorting, into
+	// unsortedVertices first and the sorter into the VBO. Every vertex is one billboard instance.
+	std::vector<ParticleVertex> unsortedVertices(nParticleCapacity);
+	GameProgramming::GL::StreamBuffer particleVBO(GL_ARRAY_BUFFER, nParticleCapacity * sizeof(ParticleVertex));
+	GameProgramming::Particle::BillboardRenderer billboards(particleVBO.buffer());
 
-	// particle data
-	float particles[nParticles * nVertAttri];
+	float shotTimer = shotInterval;
+	float titleTimer = 0.0f;
+	int titleFrames = 0;
 
 	// render loop
 	// -----------
 	while (!glfwWindowShouldClose(window))
 	{
-		glm::vec3 initVel = glm::vec3(glm::linearRand(glm::vec3(-0.2f, 0.6f, -0.3f), glm::vec3(0.2f, 0.8f, 0.3f)));
-		glm::vec3 initCol = glm::vec3(glm::linearRand(glm::vec3(0.5f, 0.5f, 0.5f), glm::vec3(0.8f, 0.8f, 0.8f)));
-
-		for (int i = 0; i < nParticles * nVertAttri; i += nVertAttri)
+		// per-frame time logic
+		// --------------------
+		float currentFrame = glfwGetTime();
+		deltaTime = currentFrame - lastFrame;
+		lastFrame = currentFrame;
+
+		// input
+		// -----
+		processInput(window);
+
+		// a new shot every shotInterval, overlapping the ones still burning
+		shotTimer += deltaTime;
+		if (shotTimer >= shotInterval)
 		{
-			// particle velocity
-			particles[i + 0] = initVel.x + glm::gaussRand(-0.2f, 0.2f);
-			particles[i + 1] = initVel.y + glm::gaussRand(-0.2f, 0.2f);
-			particles[i + 2] = initVel.z + glm::gaussRand(-0.2f, 0.2f);
-			// particle color
-			particles[i + 3] = initCol.x + glm::linearRand(-0.2f, 0.2f);
-			particles[i + 4] = initCol.y + glm::linearRand(-0.2f, 0.2f);
-			particles[i + 5] = initCol.z + glm::linearRand(-0.2f, 0.2f);
+			shotTimer = 0.0f;
+
+			GameProgramming::Particle::Shot shot;
+			shot.origin = glm::linearRand(glm::vec3(-1.0f, -0.5f, -1.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+			// glm::gaussRand(-0.2f, 0.2f) had a mean of -0.2 and, as glm scales by the deviation squared, a deviation of 0.04
+			shot.velocity = glm::linearRand(glm::vec3(-0.2f, 0.6f, -0.3f), glm::vec3(0.2f, 0.8f, 0.3f)) - glm::vec3(0.2f);
+			shot.velocityDeviation = 0.04f;
+			shot.color = glm::linearRand(glm::vec3(0.5f, 0.5f, 0.5f), glm::vec3(0.8f, 0.8f, 0.8f));
+			shot.colorJitter = 0.2f;
+			shot.lifetime = lifetime;
+			shot.count = nParticles;
+			particles.spawn(shot);
 		}
 
-		// particle VAO
-		unsigned int particleVAO, particleVBO;
-		glGenVertexArrays(1, &particleVAO);
-		glGenBuffers(1, &particleVBO);
-		glBindVertexArray(particleVAO);
-		glBindBuffer(GL_ARRAY_BUFFER, particleVBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(particles), &particles, GL_STATIC_DRAW);
-		// initial velocity
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, nVertAttri * sizeof(float), (void*)0);
-		glEnableVertexAttribArray(0);
-		// initial color 
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, nVertAttri * sizeof(float), (void*)(3 * sizeof(float)));
-		glEnableVertexAttribArray(1);
-
-		float animationTime = 0.0f;
-		while (animationTime < lifetime)
+		glm::mat4 view = camera.GetViewMatrix();
+		glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, nearPlane, farPlane);
+
+		// integrate and write the vertices
+		// --------------------------------
+		const GLintptr offset = updateParticles(blendMode, particles, sorter, unsortedVertices, particleVBO, deltaTime, gravity, drag, view);
+
+		// render
+		// ------
+		renderer.draw(blendMode, billboards, offset, particles.liveCount(), view, projection);
+		particleVBO.fence();
+
+		// blend mode, live particle count and frame times in the title, once a second
+		titleTimer += deltaTime;
+		++titleFrames;
+		if (titleTimer >= 1.0f)
 		{
-			// per-frame time logic
-			// --------------------
-			float currentFrame = glfwGetTime();
-			deltaTime = currentFrame - lastFrame;
-			lastFrame = currentFrame;
-
-			// input
-			// -----
-			processInput(window);
-
-			// render
-			// ------
-			glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-			// be sure to activate shader when setting uniforms/drawing objects
-			glm::mat4 model = glm::mat4(1.0f);
-			// model = glm::scale(model, glm::vec3(.1f, .1f, .1f));
-			glm::mat4 view = camera.GetViewMatrix();
-			glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-			particleShader.setMat4("model", model);
-			particleShader.setMat4("view", view);
-			particleShader.setMat4("projection", projection);
-			animationTime += deltaTime;
-			//animationTime += 0.01f;
-			particleShader.setFloat("time", animationTime);
-
-			// draw the particles
-			glBindVertexArray(particleVAO);
-			glPointSize(0.25f);
-			glDrawArrays(GL_POINTS, 0, nParticles);
-			glBindVertexArray(0);
-
-			// glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-			// -------------------------------------------------------------------------------
-			glfwSwapBuffers(window);
-			glfwPollEvents();
+			const std::string title = std::string(blendModeNames[blendMode]) + " (M): " + std::to_string(particles.liveCount()) + " live on " +
+				std::to_string(jobs.threadCount()) + " threads (" + particles.kernels().name + "), " +
+				std::to_string(1000.0f * titleTimer / titleFrames) + " ms/frame, GPU " + std::to_string(renderer.gpuTimer.averageMs()) + " ms";
+			glfwSetWindowTitle(window, title.c_str());
+			titleTimer = 0.0f;
+			titleFrames = 0;
+			renderer.gpuTimer.reset();
 		}
-		glDeleteVertexArrays(1, &particleVAO);
-		glDeleteBuffers(1, &particleVBO);
+
+		// glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+		// -------------------------------------------------------------------------------
+		glfwSwapBuffers(window);
+		glfwPollEvents();
 	}
 
 	// optional: de-allocate all resources once they've outlived their purpose:
@@ -189,6 +244,225 @@ int main()
 	return 0;
 }
 
+FireworkRenderer::FireworkRenderer(int width, int height)
+	: billboardShader(RESOURCE_PATH_PREFIX "shaders/70.2.billboard.vs", RESOURCE_PATH_PREFIX "shaders/70.2.billboard.fs"),
+	oitShader(RESOURCE_PATH_PREFIX "shaders/70.2.billboard.vs", RESOURCE_PATH_PREFIX "shaders/70.2.billboard_oit.fs"),
+	compositeShader(RESOURCE_PATH_PREFIX "shaders/70.2.oit_composite.vs", RESOURCE_PATH_PREFIX "shaders/70.2.oit_composite.fs"),
+	groundShader(RESOURCE_PATH_PREFIX "shaders/70.2.ground.vs", RESOURCE_PATH_PREFIX "shaders/70.2.ground.fs"),
+	oit(width, height), width(width), height(height)
+{
+	for (Shader* shader : { &billboardShader, &oitShader })
+	{
+		shader->use();
+		shader->setMat4("model", glm::mat4(1.0f));
+		// size over life: sparks shrink as they burn out
+		shader->setFloat("sizeStart", 0.02f);
+		shader->setFloat("sizeEnd", 0.005f);
+		// soft particles: fade over the last 5 cm in front of the ground
+		shader->setInt("sceneDepth", 2);
+		shader->setFloat("nearPlane", nearPlane);
+		shader->setFloat("farPlane", farPlane);
+		shader->setFloat("softness", 0.05f);
+	}
+	compositeShader.use();
+	compositeShader.setInt("accumulation", 0);
+	compositeShader.setInt("weight", 1);
+	groundShader.use();
+	groundShader.setMat4("model", glm::mat4(1.0f));
+	groundShader.setVec3("color", glm::vec3(0.15f, 0.15f, 0.18f));
+
+	// the ground, level with the lowest launch points
+	float groundVertices[] = {
+		-4.0f, -0.5f, -4.0f,
+		 4.0f, -0.5f, -4.0f,
+		-4.0f, -0.5f,  4.0f,
+		 4.0f, -0.5f,  4.0f,
+	};
+	glGenVertexArrays(1, &groundVAO);
+	glGenBuffers(1, &groundVBO);
+	glBindVertexArray(groundVAO);
+	glBindBuffer(GL_ARRAY_BUFFER, groundVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(groundVertices), groundVertices, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+	glBindVertexArray(0);
+
+	// depth of the opaque scene, sampled by the particles
+	glGenTextures(1, &sceneDepthTexture);
+	glBindTexture(GL_TEXTURE_2D, sceneDepthTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glGenFramebuffers(1, &sceneDepthFBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, sceneDepthFBO);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, sceneDepthTexture, 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+FireworkRenderer::~FireworkRenderer()
+{
+	glDeleteVertexArrays(1, &groundVAO);
+	glDeleteBuffers(1, &groundVBO);
+	glDeleteFramebuffers(1, &sceneDepthFBO);
+	glDeleteTextures(1, &sceneDepthTexture);
+}
+
+void FireworkRenderer::draw(BlendMode mode, GameProgramming::Particle::BillboardRenderer& billboards, GLintptr offset, GLsizei count,
+	const glm::mat4& view, const glm::mat4& projection)
+{
+	if (framebufferWidth != width || framebufferHeight != height)
+	{
+		width = framebufferWidth;
+		height = framebufferHeight;
+		glBindTexture(GL_TEXTURE_2D, sceneDepthTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+		oit.resize(width, height);
+	}
+
+	groundShader.use();
+	groundShader.setMat4("view", view);
+	groundShader.setMat4("projection", projection);
+	glBindVertexArray(groundVAO);
+	glEnable(GL_DEPTH_TEST);
+
+	// 1. depth of the opaque scene for the soft particles
+	glBindFramebuffer(GL_FRAMEBUFFER, sceneDepthFBO);
+	glViewport(0, 0, width, height);
+	glClear(GL_DEPTH_BUFFER_BIT);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+	// 2. the opaque scene itself
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	glBindVertexArray(0);
+
+	// 3. the particles: occlusion and the fade near the ground both come from the scene depth
+	glDisable(GL_DEPTH_TEST);
+	glActiveTexture(GL_TEXTURE2);
+	glBindTexture(GL_TEXTURE_2D, sceneDepthTexture);
+	glActiveTexture(GL_TEXTURE0);
+	gpuTimer.begin();
+	if (mode == BLEND_OIT)
+	{
+		oit.beginAccumulate();
+		oitShader.use();
+		oitShader.setMat4("view", view);
+		oitShader.setMat4("projection", projection);
+		billboards.draw(offset, count);
+		compositeShader.use();
+		oit.composite();
+	}
+	else
+	{
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		billboardShader.use();
+		billboardShader.setMat4("view", view);
+		billboardShader.setMat4("projection", projection);
+		billboards.draw(offset, count);
+	}
+	gpuTimer.end();
+	gpuTimer.poll();
+}
+
+// integrates the particles into the next region of the stream buffer, back to front when sorting; returns the
+// region's byte offset
+GLintptr updateParticles(BlendMode mode, GameProgramming::Particle::ParticlePool& particles, GameProgramming::Particle::DepthSorter& sorter,
+	std::vector<ParticleVertex>& unsortedVertices, GameProgramming::GL::StreamBuffer& particleVBO, float dt, const glm::vec3& gravity, float drag,
+	const glm::mat4& view)
+{
+	auto* vertices = static_cast<ParticleVertex*>(particleVBO.beginWrite());
+	if (mode == BLEND_SORTED)
+	{
+		particles.update(dt, gravity, drag, unsortedVertices.data());
+		sorter.sort(unsortedVertices.data(), particles.liveCount(), view, vertices);
+	}
+	else
+	{
+		particles.update(dt, gravity, drag, vertices);
+	}
+	return particleVBO.endWrite();
+}
+
+// one static shell of 10k, 100k and 1M particles drawn in every blend mode without vsync; prints the CPU time
+// (update, sort, submit), the GPU time of the particle passes and the whole frame, averaged over many frames
+// ---------------------------------------------------------------------------------------------------------
+int runBenchmark(GLFWwindow* window)
+{
+	const int warmupFrames = 30;
+	const int measuredFrames = 200;
+	const float frameTime = 1.0f / 60.0f;
+	const glm::vec3 gravity(0.0f, -0.2f, 0.0f);
+
+	glfwSwapInterval(0);
+	glEnable(GL_BLEND);
+
+	FireworkRenderer renderer(framebufferWidth, framebufferHeight);
+	glm::mat4 view = camera.GetViewMatrix();
+	glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, nearPlane, farPlane);
+
+	GameProgramming::Job::JobSystem jobs;
+	GameProgramming::Particle::DepthSorter sorter(jobs);
+
+	std::printf("%d frames per row, %u threads, %s kernels, %dx%d\n", measuredFrames, jobs.threadCount(),
+		GameProgramming::Particle::bestKernels().name, framebufferWidth, framebufferHeight);
+	for (unsigned int count : { 10000u, 100000u, 1000000u })
+	{
+		GameProgramming::Particle::ParticlePool particles(count, jobs);
+		GameProgramming::Particle::Shot shot;
+		shot.velocity = glm::vec3(0.0f, 0.5f, 0.0f);
+		shot.velocityDeviation = 0.3f;
+		shot.color = glm::vec3(0.65f);
+		shot.lifetime = 1e6f; // none dies during the run
+		shot.count = count;
+		particles.spawn(shot);
+
+		std::vector<ParticleVertex> unsortedVertices(count);
+		GameProgramming::GL::StreamBuffer particleVBO(GL_ARRAY_BUFFER, count * sizeof(ParticleVertex));
+		GameProgramming::Particle::BillboardRenderer billboards(particleVBO.buffer());
+
+		std::printf("%u particles\n", count);
+		for (int mode = 0; mode < BLEND_MODE_COUNT; ++mode)
+		{
+			double cpuMs = 0.0;
+			auto runStart = std::chrono::steady_clock::now();
+			for (int frame = 0; frame < warmupFrames + measuredFrames; ++frame)
+			{
+				if (frame == warmupFrames)
+				{
+					glFinish();
+					renderer.gpuTimer.poll(true);
+					renderer.gpuTimer.reset();
+					cpuMs = 0.0;
+					runStart = std::chrono::steady_clock::now();
+				}
+				const auto cpuStart = std::chrono::steady_clock::now();
+
+				const GLintptr offset = updateParticles(static_cast<BlendMode>(mode), particles, sorter, unsortedVertices, particleVBO,
+					frameTime, gravity, 0.0f, view);
+				renderer.draw(static_cast<BlendMode>(mode), billboards, offset, particles.liveCount(), view, projection);
+				particleVBO.fence();
+
+				cpuMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cpuStart).count();
+				glfwSwapBuffers(window);
+				glfwPollEvents();
+			}
+			glFinish();
+			renderer.gpuTimer.poll(true);
+			const double frameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - runStart).count() / measuredFrames;
+			std::printf("  %-22s cpu %7.3f ms  gpu %7.3f ms  frame %7.3f ms\n", blendModeNames[mode], cpuMs / measuredFrames,
+				renderer.gpuTimer.averageMs(), frameMs);
+		}
+	}
+
+	glfwTerminate();
+	return 0;
+}
+
 // process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
 // ---------------------------------------------------------------------------------------------------------
 void processInput(GLFWwindow* window)
@@ -204,6 +478,17 @@ void processInput(GLFWwindow* window)
 		camera.ProcessKeyboard(LEFT, deltaTime);
 	if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
 		camera.ProcessKeyboard(RIGHT, deltaTime);
+
+	if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS)
+	{
+		if (!isMKeyPressed)
+			blendMode = static_cast<BlendMode>((blendMode + 1) % BLEND_MODE_COUNT);
+		isMKeyPressed = true;
+	}
+	else
+	{
+		isMKeyPressed = false;
+	}
 }
 
 // glfw: whenever the window size changed (by OS or user resize) this callback function executes
@@ -213,6 +498,8 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 	// make sure the viewport matches the new window dimensions; note that width and 
 	// height will be significantly larger than specified on retina displays.
 	glViewport(0, 0, width, height);
+	framebufferWidth = width;
+	framebufferHeight = height;
 }
 
 // glfw: whenever the mouse moves, this callback is called
@@ -0,0 +1,235 @@
+#include <glad/glad.h>
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/random.hpp>
+
+#include "camera.h"
+#include "gl_extensions.hpp"
+#include "gpu_particles.hpp"
+#include "logger.hpp"
+#include "shader.hpp"
+
+#include <iostream>
+#include <string>
+
+// ring capacity; at the rates below about 1.6M particles are alive at any time
+#define nParticleCapacity (1u << 21)
+#define nParticlesPerShot 20000u
+
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void processInput(GLFWwindow* window);
+
+// settings
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+const float shotsPerSecond = 20.0f;
+const float lifetime = 4.0f;
+
+// camera
+Camera camera(glm::vec3(0.0f, 0.5f, 6.0f));
+float lastX = (float)SCR_WIDTH / 2.0;
+float lastY = (float)SCR_HEIGHT / 2.0;
+bool firstMouse = true;
+
+// timing
+float deltaTime = 0.0f;
+float lastFrame = 0.0f;
+
+int main()
+{
+	GameProgramming::Logger::init();
+
+	// glfw: initialize and configure
+	// ------------------------------
+	glfwInit();
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+#ifdef __APPLE__
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+
+	// glfw window creation
+	// --------------------
+	GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Jieun Lee", NULL, NULL);
+	if (window == NULL)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+	glfwSetCursorPosCallback(window, mouse_callback);
+	glfwSetScrollCallback(window, scroll_callback);
+
+	// tell GLFW to capture our mouse
+	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+	// glad: load all OpenGL function pointers
+	// ---------------------------------------
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		std::cout << "Failed to initialize GLAD" << std::endl;
+		return -1;
+	}
+	GameProgramming::GL::loadExtensions((GLADloadproc)glfwGetProcAddress);
+
+	// configure global opengl state
+	// -----------------------------
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE); // additive: overlapping shells brighten instead of hiding each other
+	glPointSize(1.0f);
+
+	// build and compile shaders
+	// -------------------------
+	using GameProgramming::Particle::GpuParticleSystem;
+	GameProgramming::Shader::ShaderProgram updateShader(
+		RESOURCE_PATH_PREFIX "shaders/70.3.particle_update.vs", GpuParticleSystem::FeedbackVaryings);
+	GameProgramming::Shader::ShaderProgram particleShader(
+		RESOURCE_PATH_PREFIX "shaders/70.3.particle.vs",
+		RESOURCE_PATH_PREFIX "shaders/70.1.particle.fs");
+
+	// particle state stays on the GPU; shells are emitted into its ring buffer
+	// ------------------------------------------------------------------------
+	GpuParticleSystem particles(nParticleCapacity);
+	const glm::vec3 gravity(0.0f, -0.2f, 0.0f);
+	float shotTimer = 0.0f;
+
+	float titleTimer = 0.0f;
+	int titleFrames = 0;
+
+	// render loop
+	// -----------
+	while (!glfwWindowShouldClose(window))
+	{
+		// per-frame time logic
+		// --------------------
+		float currentFrame = glfwGetTime();
+		deltaTime = currentFrame - lastFrame;
+		lastFrame = currentFrame;
+
+		// input
+		// -----
+		processInput(window);
+
+		// launch shells at a steady rate, however long the frame took
+		shotTimer += deltaTime;
+		while (shotTimer >= 1.0f / shotsPerSecond)
+		{
+			shotTimer -= 1.0f / shotsPerSecond;
+
+			GameProgramming::Particle::Burst burst;
+			burst.origin = glm::linearRand(glm::vec3(-3.0f, -1.0f, -3.0f), glm::vec3(3.0f, 1.0f, 0.0f));
+			burst.velocity = glm::linearRand(glm::vec3(-0.1f, 0.2f, -0.1f), glm::vec3(0.1f, 0.4f, 0.1f));
+			burst.spread = 0.6f;
+			burst.color = glm::linearRand(glm::vec3(0.3f, 0.3f, 0.3f), glm::vec3(1.0f, 1.0f, 1.0f));
+			burst.colorJitter = 0.2f;
+			burst.lifetime = lifetime;
+			burst.count = nParticlesPerShot;
+			particles.emit(burst);
+		}
+
+		// simulate
+		// --------
+		particles.update(updateShader, deltaTime, gravity);
+
+		// render
+		// ------
+		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		glm::mat4 view = camera.GetViewMatrix();
+		glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
+		particleShader.use();
+		particleShader.setUniformMatrix4f("view", view);
+		particleShader.setUniformMatrix4f("projection", projection);
+		particles.draw();
+
+		// live particle count and frame time in the title, once a second
+		titleTimer += deltaTime;
+		++titleFrames;
+		if (titleTimer >= 1.0f)
+		{
+			const std::string title = "GPU particles: " + std::to_string(particles.liveCount()) + " live, " +
+				std::to_string(1000.0f * titleTimer / titleFrames) + " ms/frame";
+			glfwSetWindowTitle(window, title.c_str());
+			titleTimer = 0.0f;
+			titleFrames = 0;
+		}
+
+		// glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+		// -------------------------------------------------------------------------------
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	// optional: de-allocate all resources once they've outlived their purpose:
+	// ------------------------------------------------------------------------
+	glfwTerminate();
+	return 0;
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+
+	if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+		camera.ProcessKeyboard(FORWARD, deltaTime);
+	if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+		camera.ProcessKeyboard(BACKWARD, deltaTime);
+	if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+		camera.ProcessKeyboard(LEFT, deltaTime);
+	if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+		camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	// make sure the viewport matches the new window dimensions; note that width and 
+	// height will be significantly larger than specified on retina displays.
+	glViewport(0, 0, width, height);
+}
+
+// glfw: whenever the mouse moves, this callback is called
+// -------------------------------------------------------
+void mouse_callback(GLFWwindow* window, double xpos, double ypos)
+{
+	if (firstMouse)
+	{
+		lastX = xpos;
+		lastY = ypos;
+		firstMouse = false;
+	}
+
+	float xoffset = xpos - lastX;
+	float yoffset = lastY - ypos; // reversed since y-coordinates go from bottom to top
+
+	lastX = xpos;
+	lastY = ypos;
+
+	camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+// glfw: whenever the mouse scroll wheel scrolls, this callback is called
+// ----------------------------------------------------------------------
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+	camera.ProcessMouseScroll(yoffset);
+}
+
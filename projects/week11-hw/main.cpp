@@ -9,6 +9,7 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "_shader.h"
+#include "gl_extensions.hpp"
 #include "camera.h"
 //#include <learnopengl/model.h>
 
@@ -72,6 +73,7 @@ int main()
 		std::cout << "Failed to initialize GLAD" << std::endl;
 		return -1;
 	}
+	GameProgramming::GL::loadExtensions((GLADloadproc)glfwGetProcAddress);
 
 	// configure global opengl state
 	// -----------------------------
@@ -11,14 +11,21 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "_shader.h"
+#include "gl_extensions.hpp"
+#include "shader_watcher.hpp"
+#include "cascaded_shadow_map.hpp"
+#include "gpu_timer.hpp"
+#include "shadow_filter.hpp"
 #include "camera.h"
 //#include <learnopengl/model.h>
-#include "teapot_loader.h"
+#include "mesh_file.hpp"
 
+#include <array>
 #include <iostream>
+#include <string>
 
-struct TeapotData { GLuint vao, vbo, nVertexNum; };
-TeapotData g_teapotData {.vao = 0, .vbo = 0, };
+struct TeapotData { GLuint vao, vbo, ebo, nIndexNum; GLenum indexType; };
+TeapotData g_teapotData {.vao = 0, .vbo = 0, .ebo = 0, };
 GLuint woodTexture, floorTexture;
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -34,6 +41,15 @@ void renderTeapot();
 // settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
+// shadows: the view frustum up to SHADOW_DISTANCE, cut into SHADOW_CASCADES maps of SHADOW_RESOLUTION^2
+const unsigned int SHADOW_CASCADES = 4;
+const int SHADOW_RESOLUTION = 1024;
+const float SHADOW_DISTANCE = 30.0f;
+const float LIGHT_ANGLE = 0.03f; // PCSS penumbra width per unit of blocker to receiver distance
+
+// shadow filtering, cycled with F
+GameProgramming::GL::ShadowFilter shadowFilter = GameProgramming::GL::ShadowFilter::Pcss;
+bool isFKeyPressed = false;
 
 // camera
 Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
@@ -85,6 +101,7 @@ int main()
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
+    GameProgramming::GL::loadExtensions((GLADloadproc)glfwGetProcAddress);
 
     // configure global opengl state
     // -----------------------------
@@ -133,49 +150,31 @@ int main()
     woodTexture = loadTexture(RESOURCE_PATH_PREFIX "textures/wood.jpg");
     floorTexture = loadTexture(RESOURCE_PATH_PREFIX "textures/Marble018_1K-JPG_Color.jpg");
 
-    // configure depth map FBO
-    // -----------------------
-    const unsigned int SHADOW_WIDTH = 1024, SHADOW_HEIGHT = 1024;
-    unsigned int depthMapFBO;
-    glGenFramebuffers(1, &depthMapFBO);
-    // create depth texture
-    unsigned int depthMap;
-    glGenTextures(1, &depthMap);
-    glBindTexture(GL_TEXTURE_2D, depthMap);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // attach depth texture as FBO's depth buffer
-    glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthMap, 0);
-    glDrawBuffer(GL_NONE);  // A framebuffer object however is not complete without a color buffer 
-    glReadBuffer(GL_NONE);  // so we need to explicitly tell OpenGL we're not going to render any color data.
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    std::vector<float> data{};
-    Teapot teapot{RESOURCE_PATH_PREFIX "other/teapot.vbo", data, 8};
-    g_teapotData.nVertexNum = teapot.nVertNum;
-    glGenVertexArrays(1, &g_teapotData.vao);
-    glGenBuffers(1, &g_teapotData.vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, g_teapotData.vbo);
-    glBufferData(GL_ARRAY_BUFFER, teapot.nVertNum * teapot.nVertFloats * sizeof(float), &data[0],
-                 GL_STATIC_DRAW);
+    // configure cascaded shadow maps
+    // ------------------------------
+    GameProgramming::GL::CascadedShadowMap cascades(SHADOW_CASCADES, SHADOW_RESOLUTION);
+    GameProgramming::GL::ShadowSamplers shadowSamplers;
+    // GPU time of the lit pass with each filter, shown in the title
+    std::array<GameProgramming::GL::GpuTimer, GameProgramming::GL::ShadowFilterCount> filterTimers;
+    float titleTimer = 0.0f;
 
-    glBindVertexArray(g_teapotData.vao);
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, teapot.nVertFloats * sizeof(float), (void *)0);
-    glEnableVertexAttribArray(0);
-    // texCoord attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, teapot.nVertFloats * sizeof(float),
-                          (void *)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    // normal attribute
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, teapot.nVertFloats * sizeof(float),
-                          (void *)(5 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-    glBindVertexArray(0);
+    // teapot.mesh is generated from teapot.vbo by mesh-converter (welded, indexed); the mapped payloads go to the VBO/EBO as is
+    {
+        GameProgramming::Mesh::MeshFile teapotMesh{RESOURCE_PATH_PREFIX "other/teapot.mesh"};
+        g_teapotData.nIndexNum = teapotMesh.indexCount();
+        g_teapotData.indexType = static_cast<GLenum>(teapotMesh.indexType());
+        glGenVertexArrays(1, &g_teapotData.vao);
+        glGenBuffers(1, &g_teapotData.vbo);
+        glGenBuffers(1, &g_teapotData.ebo);
+        glBindVertexArray(g_teapotData.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, g_teapotData.vbo);
+        teapotMesh.uploadVertexData(GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_teapotData.ebo);
+        teapotMesh.uploadIndexData(GL_STATIC_DRAW);
+        // position(0), texCoord(1), normal(2) attributes as recorded in the file
+        teapotMesh.setupVertexAttributes();
+        glBindVertexArray(0);
+    }
 
 
     // shader configuration
@@ -183,9 +182,16 @@ int main()
     shader.use();
     shader.setInt("diffuseTexture", 0);
     shader.setInt("shadowMap", 1);
+    shader.setInt("shadowCompareMap", 2);
     debugDepthQuad.use();
     debugDepthQuad.setInt("depthMap", 0);
 
+    // edited shader files are rebuilt in the background and swapped in between frames
+    GameProgramming::Shader::ShaderWatcher shaderWatcher;
+    shaderWatcher.watch(shader);
+    shaderWatcher.watch(simpleDepthShader);
+    shaderWatcher.watch(debugDepthQuad);
+
     // lighting info
     // -------------
     glm::vec3 lightPos(-2.0f, 4.0f, -1.0f);
@@ -200,6 +206,8 @@ int main()
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
+        shaderWatcher.update();
+
         // input
         // -----
         processInput(window);
@@ -209,28 +217,29 @@ int main()
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // 1. render depth of scene to texture (from light's perspective)
-        // --------------------------------------------------------------
-        glm::mat4 lightProjection, lightView;
-        glm::mat4 lightSpaceMatrix;
-        float near_plane = 1.0f, far_plane = 7.5f;
-        lightProjection = glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, near_plane, far_plane);
-        lightView = glm::lookAt(lightPos, glm::vec3(0.0f), glm::vec3(0.0, 1.0, 0.0));
-        lightSpaceMatrix = lightProjection * lightView;
-        // render scene from light's point of view
+        // 1. render depth of scene to the cascades (from light's perspective)
+        // -------------------------------------------------------------------
+        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
+        glm::mat4 view = camera.GetViewMatrix();
+        // a directional light shining from lightPos towards the origin
+        cascades.update(view, glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, SHADOW_DISTANCE, glm::normalize(-lightPos));
+        cascades.upload();
+        // render scene from light's point of view, once per cascade. Nothing in it moves, so a cascade is only
+        // drawn again when the camera moved it; otherwise its cached depth is copied
         simpleDepthShader.use();
-        simpleDepthShader.setMat4("lightSpaceMatrix", lightSpaceMatrix);
-
-        glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-        glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-        glClear(GL_DEPTH_BUFFER_BIT);
-        //glActiveTexture(GL_TEXTURE0);
-        //glBindTexture(GL_TEXTURE_2D, woodTexture);
-        renderScene(simpleDepthShader);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-        
-        // 2. render scene as normal using the generated depth/shadow map  
+        const auto lightSpaceUniform = simpleDepthShader.uniform<glm::mat4>("lightSpaceMatrix");
+        for (unsigned int i = 0; i < cascades.cascadeCount(); ++i)
+        {
+            if (cascades.beginStatic(i))
+            {
+                simpleDepthShader.set(lightSpaceUniform, cascades.matrix(i));
+                renderScene(simpleDepthShader);
+            }
+            cascades.beginDynamic(i); // moving casters would be drawn here
+        }
+        cascades.end();
+
+        // 2. render scene as normal using the generated depth/shadow maps
         // --------------------------------------------------------------
         // reset viewport
         int framebufferWidth, framebufferHeight;
@@ -238,28 +247,39 @@ int main()
         glViewport(0, 0, framebufferWidth, framebufferHeight);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         shader.use();
-        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-        glm::mat4 view = camera.GetViewMatrix();
         shader.setMat4("projection", projection);
         shader.setMat4("view", view);
         // set light uniforms
         shader.setVec3("viewPos", camera.Position);
         shader.setVec3("lightPos", lightPos);
-        shader.setMat4("lightSpaceMatrix", lightSpaceMatrix);
+        shader.setInt("shadowFilter", static_cast<int>(shadowFilter));
+        shader.setFloat("lightAngle", LIGHT_ANGLE);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, woodTexture);
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, depthMap);
+        cascades.bindTexture(1);
+        cascades.bindTexture(2);
+        shadowSamplers.bind(1, 2);
+        GameProgramming::GL::GpuTimer &filterTimer = filterTimers[static_cast<unsigned int>(shadowFilter)];
+        filterTimer.begin();
         renderScene(shader);
-
-        // render Depth map to quad for visual debugging
-        // ---------------------------------------------
-        // debugDepthQuad.use();
-        // debugDepthQuad.setFloat("near_plane", near_plane);
-        // debugDepthQuad.setFloat("far_plane", far_plane);
-        // glActiveTexture(GL_TEXTURE0);
-        // glBindTexture(GL_TEXTURE_2D, depthMap);
-        // renderQuad();
+        filterTimer.end();
+        GameProgramming::GL::ShadowSamplers::unbind(1, 2);
+        for (GameProgramming::GL::GpuTimer &timer : filterTimers)
+            timer.poll();
+
+        titleTimer += deltaTime;
+        if (titleTimer >= 0.5f)
+        {
+            titleTimer = 0.0f;
+            std::string title = "2291012 남윤혁 | F: shadow filter |";
+            for (unsigned int i = 0; i < GameProgramming::GL::ShadowFilterCount; ++i)
+            {
+                const auto filter = static_cast<GameProgramming::GL::ShadowFilter>(i);
+                title += (filter == shadowFilter ? " [" : " ") + std::string(GameProgramming::GL::shadowFilterName(filter)) + " " +
+                         std::to_string(filterTimers[i].averageMs()) + " ms" + (filter == shadowFilter ? "]" : "");
+            }
+            glfwSetWindowTitle(window, title.c_str());
+        }
 
         // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
         // -------------------------------------------------------------------------------
@@ -280,9 +300,11 @@ int main()
 // --------------------
 void renderScene(const Shader& shader)
 {
+    const auto modelUniform = shader.uniform<glm::mat4>("model");
+
     // floor
     glm::mat4 model = glm::mat4(1.0f);
-    shader.setMat4("model", model);
+    shader.set(modelUniform, model);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, floorTexture);
     glBindVertexArray(planeVAO);
@@ -295,23 +317,23 @@ void renderScene(const Shader& shader)
     model = glm::mat4(1.0f);
     model = glm::translate(model, glm::vec3(0.0f, 1.5f, 0.0));
     model = glm::scale(model, glm::vec3(0.5f));
-    shader.setMat4("model", model);
+    shader.set(modelUniform, model);
     renderCube();
     model = glm::mat4(1.0f);
     model = glm::translate(model, glm::vec3(2.0f, 0.0f, 1.0));
     model = glm::scale(model, glm::vec3(0.5f));
-    shader.setMat4("model", model);
+    shader.set(modelUniform, model);
     renderCube();
     model = glm::mat4(1.0f);
     model = glm::translate(model, glm::vec3(-1.0f, 0.0f, 2.0));
     model = glm::rotate(model, glm::radians(60.0f), glm::normalize(glm::vec3(1.0, 0.0, 1.0)));
     model = glm::scale(model, glm::vec3(0.25));
-    shader.setMat4("model", model);
+    shader.set(modelUniform, model);
     renderCube();
 
     model = glm::translate(glm::identity<glm::mat4>(), glm::vec3(-3.f, 0.5f, 2.f));
     model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-    shader.setMat4("model", model);
+    shader.set(modelUniform, model);
     renderTeapot();
 }
 
@@ -425,7 +447,7 @@ void renderQuad()
 void renderTeapot()
 {
     glBindVertexArray(g_teapotData.vao);
-    glDrawArrays(GL_TRIANGLES, 0, g_teapotData.nVertexNum);
+    glDrawElements(GL_TRIANGLES, g_teapotData.nIndexNum, g_teapotData.indexType, nullptr);
     glBindVertexArray(0);
 }
 
@@ -448,6 +470,11 @@ void processInput(GLFWwindow* window)
         camera.ProcessKeyboard(UP, deltaTime);
     if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS)
         camera.ProcessKeyboard(DOWN, deltaTime);
+
+    const bool fPressed = glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS;
+    if (fPressed && !isFKeyPressed)
+        shadowFilter = static_cast<GameProgramming::GL::ShadowFilter>((static_cast<unsigned int>(shadowFilter) + 1) % GameProgramming::GL::ShadowFilterCount);
+    isFKeyPressed = fPressed;
 }
 
 // glfw: whenever the window size changed (by OS or user resize) this callback function executes
@@ -9,18 +9,22 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "_shader.h"
+#include "gl_extensions.hpp"
+#include "constant_buffers.hpp"
 #include "camera.h"
-#include "teapot_loader.h"
+#include "mesh_file.hpp"
+#include "sphere.hpp"
 // #include "model.h"
 
 #include <iostream>
 #include <vector>
 
-struct TeapotData { GLuint vao, vbo, nVertexNum; };
-TeapotData g_teapotData {.vao = 0, .vbo = 0, };
+struct TeapotData { GLuint vao, vbo, ebo, nIndexNum; GLenum indexType; };
+TeapotData g_teapotData {.vao = 0, .vbo = 0, .ebo = 0, };
 
-struct SphereData { GLuint vao, vbo; int nSphereVert, nSphereAttr; };
-SphereData g_sphereData { .vao = 0, .vbo = 0 };
+using Sphere = GameProgramming::Mesh::SphereLodChain<8, 128>;
+struct SphereData { GLuint vao, vbo, ebo; };
+SphereData g_sphereData { .vao = 0, .vbo = 0, .ebo = 0 };
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
@@ -28,7 +32,6 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void processInput(GLFWwindow *window);
 GLuint loadTexture(const char *path);
 GLuint loadCubemap(std::vector<std::string> faces);
-void init_sphere(float **vertices, int *nVert, int *nAttr);
 
 // settings
 const unsigned int SCR_WIDTH = 800;
@@ -81,6 +84,7 @@ int main()
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
+    GameProgramming::GL::loadExtensions((GLADloadproc)glfwGetProcAddress);
 
     // configure global opengl state
     // -----------------------------
@@ -182,48 +186,45 @@ int main()
          1.0f, -1.0f,  1.0f
     };
 
-    std::vector<float> teapot_data{};
-    Teapot teapot{RESOURCE_PATH_PREFIX "other/teapot.vbo", teapot_data, 8};
-    g_teapotData.nVertexNum = teapot.nVertNum;
-    glGenVertexArrays(1, &g_teapotData.vao);
-    glGenBuffers(1, &g_teapotData.vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, g_teapotData.vbo);
-    glBufferData(GL_ARRAY_BUFFER, teapot.nVertNum * teapot.nVertFloats * sizeof(float), &teapot_data[0],
-                 GL_STATIC_DRAW);
-
-    glBindVertexArray(g_teapotData.vao);
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, teapot.nVertFloats * sizeof(float), (void *)0);
-    glEnableVertexAttribArray(0);
-    // texCoord attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, teapot.nVertFloats * sizeof(float),
-                          (void *)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    // normal attribute
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, teapot.nVertFloats * sizeof(float),
-                          (void *)(5 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-    glBindVertexArray(0);
+    // teapot.mesh is generated from teapot.vbo by mesh-converter (welded, indexed); the mapped payloads go to the VBO/EBO as is
+    {
+        GameProgramming::Mesh::MeshFile teapotMesh{RESOURCE_PATH_PREFIX "other/teapot.mesh"};
+        g_teapotData.nIndexNum = teapotMesh.indexCount();
+        g_teapotData.indexType = static_cast<GLenum>(teapotMesh.indexType());
+        glGenVertexArrays(1, &g_teapotData.vao);
+        glGenBuffers(1, &g_teapotData.vbo);
+        glGenBuffers(1, &g_teapotData.ebo);
+        glBindVertexArray(g_teapotData.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, g_teapotData.vbo);
+        teapotMesh.uploadVertexData(GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_teapotData.ebo);
+        teapotMesh.uploadIndexData(GL_STATIC_DRAW);
+        // position(0), texCoord(1), normal(2) attributes as recorded in the file
+        teapotMesh.setupVertexAttributes();
+        glBindVertexArray(0);
+    }
 
-    // innitialize sphere
-    float *sphereVerts = nullptr;
-    init_sphere(&sphereVerts, &g_sphereData.nSphereVert, &g_sphereData.nSphereAttr);
+    // innitialize sphere: every LOD shares one VBO/EBO
+    const Sphere sphere;
     glGenVertexArrays(1, &g_sphereData.vao);
     glBindVertexArray(g_sphereData.vao);
     {
         glGenBuffers(1, &g_sphereData.vbo);
         glBindBuffer(GL_ARRAY_BUFFER, g_sphereData.vbo);
-        glBufferData(GL_ARRAY_BUFFER, g_sphereData.nSphereVert * g_sphereData.nSphereAttr * sizeof(float), sphereVerts, GL_STATIC_DRAW);
-        free(sphereVerts);
+        sphere.mesh().uploadVertexData(GL_STATIC_DRAW);
+        glGenBuffers(1, &g_sphereData.ebo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_sphereData.ebo);
+        sphere.mesh().uploadIndexData(GL_STATIC_DRAW);
 
+        constexpr GLsizei stride = Sphere::FloatsPerVertex * sizeof(float);
         // position attribute
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, g_sphereData.nSphereAttr * sizeof(float), (const GLvoid *)0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (const GLvoid *)0);
         glEnableVertexAttribArray(0);
         // normal attribute
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, g_sphereData.nSphereAttr * sizeof(float), (const GLvoid *)(3 * sizeof(float)));
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (const GLvoid *)(3 * sizeof(float)));
         glEnableVertexAttribArray(1);
         // texCoord attribute
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, g_sphereData.nSphereAttr * sizeof(float), (const GLvoid *)(6 * sizeof(float)));
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (const GLvoid *)(6 * sizeof(float)));
         glEnableVertexAttribArray(2);
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -273,6 +274,9 @@ int main()
     skyboxShader.use();
     skyboxShader.setInt("skybox", 0);
 
+    // view, projection and eye position for both programs, one uniform buffer upload per frame
+    GameProgramming::Shader::ConstantBuffers constants;
+
     // render loop
     // -----------
     while (!glfwWindowShouldClose(window))
@@ -293,23 +297,24 @@ int main()
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         // draw scene as normal
-        shader.use();
-        glm::mat4 model = glm::mat4(1.0f);
-        glm::mat4 view = camera.GetViewMatrix();
-        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-        shader.setMat4("model", model);
-        shader.setMat4("view", view);
-        shader.setMat4("projection", projection);
-        shader.setVec3("eyePos", camera.Position);
+        GameProgramming::Shader::PassConstants &pass = constants.pass(0);
+        pass.view = camera.GetViewMatrix();
+        pass.projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
+        pass.viewProjection = pass.projection * pass.view;
+        pass.viewPos = camera.Position;
+        constants.frame().time = currentFrame;
+        constants.upload();
+        constants.bindPass(0);
 
-        model = glm::identity<glm::mat4>();
+        shader.use();
+        glm::mat4 model = glm::identity<glm::mat4>();
         model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
         shader.setMat4("model", model);
         // draw teapot
         glBindVertexArray(g_teapotData.vao);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
-        glDrawArrays(GL_TRIANGLES, 0, g_teapotData.nVertexNum);
+        glDrawElements(GL_TRIANGLES, g_teapotData.nIndexNum, g_teapotData.indexType, nullptr);
         glBindVertexArray(0); 
 
         // draw sphere 1
@@ -320,7 +325,7 @@ int main()
         glBindVertexArray(g_sphereData.vao);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
-        glDrawArrays(GL_TRIANGLES, 0, g_sphereData.nSphereVert);
+        sphere.draw(Sphere::selectLod(model, camera.Position, glm::radians(camera.Zoom), SCR_HEIGHT));
         glBindVertexArray(0);
 
         // draw sphere 2
@@ -331,7 +336,7 @@ int main()
         glBindVertexArray(g_sphereData.vao);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
-        glDrawArrays(GL_TRIANGLES, 0, g_sphereData.nSphereVert);
+        sphere.draw(Sphere::selectLod(model, camera.Position, glm::radians(camera.Zoom), SCR_HEIGHT));
         glBindVertexArray(0);
 
         // draw sphere 3
@@ -342,16 +347,13 @@ int main()
         glBindVertexArray(g_sphereData.vao);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
-        glDrawArrays(GL_TRIANGLES, 0, g_sphereData.nSphereVert);
+        sphere.draw(Sphere::selectLod(model, camera.Position, glm::radians(camera.Zoom), SCR_HEIGHT));
         glBindVertexArray(0);
 
         // draw skybox as last
         glDepthFunc(GL_LEQUAL);  // change depth function so depth test passes when values are equal to depth buffer's content
         {
-            skyboxShader.use();
-            view = glm::mat4(glm::mat3(camera.GetViewMatrix())); // remove translation from the view matrix
-            skyboxShader.setMat4("view", view);
-            skyboxShader.setMat4("projection", projection);
+            skyboxShader.use(); // 60.1.skybox.vs drops the translation of the pass view matrix itself
             // skybox cube
             glBindVertexArray(skyboxVAO);
             glActiveTexture(GL_TEXTURE0);
@@ -373,6 +375,7 @@ int main()
     glDeleteBuffers(1, &skyboxVBO);
     glDeleteVertexArrays(1, &g_sphereData.vao);
     glDeleteBuffers(1, &g_sphereData.vbo);
+    glDeleteBuffers(1, &g_sphereData.ebo);
 
     glfwTerminate();
     return 0;
@@ -513,163 +516,4 @@ GLuint loadCubemap(std::vector<std::string> faces)
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
     return textureID;
-}
-
-
-// initalize vertices of a sphere : position, normal, tex_coords.
-// void initSphere(std::vector <float> data, int* nVert, int* nAttr)
-void init_sphere(float **vertices, int *nVert, int *nAttr)
-{
-    //----------------------------------------
-    // sphere: set up vertex data and configure vertex attributes
-    float pi = acosf(-1.0f); // pi = 3.14152...
-    float pi2 = 2.0f * pi;
-    int nu = 40, nv = 20;
-    const double du = pi2 / nu;
-    const double dv = pi / nv;
-
-    *nVert = (nv - 1) * nu * 6; // two triangles
-    *nAttr = 8;
-    *vertices = (float *)malloc(sizeof(float) * (*nVert) * (*nAttr));
-
-    float u, v;
-    int k = 0;
-
-    v = 0.0f;
-    u = 0.0f;
-    for (v = (-0.5f) * pi + dv; v < 0.5f * pi - dv; v += dv)
-    {
-        for (u = 0.0f; u < pi2; u += du)
-        {
-            // p(u,v)
-            (*vertices)[k++] = cosf(v) * cosf(u);
-            (*vertices)[k++] = cosf(v) * sinf(u);
-            (*vertices)[k++] = sinf(v); // position
-            (*vertices)[k++] = cosf(v) * cosf(u);
-            (*vertices)[k++] = cosf(v) * sinf(u);
-            (*vertices)[k++] = sinf(v); // normal
-            (*vertices)[k++] = u / pi2;
-            (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-            // p(u+du,v)
-            (*vertices)[k++] = cosf(v) * cosf(u + du);
-            (*vertices)[k++] = cosf(v) * sinf(u + du);
-            (*vertices)[k++] = sinf(v); // position
-            (*vertices)[k++] = cosf(v) * cosf(u + du);
-            (*vertices)[k++] = cosf(v) * sinf(u + du);
-            (*vertices)[k++] = sinf(v); // normal
-            (*vertices)[k++] = (u + du) / pi2;
-            (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-            // p(u,v+dv)
-            (*vertices)[k++] = cosf(v + dv) * cosf(u);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u);
-            (*vertices)[k++] = sinf(v + dv); // position
-            (*vertices)[k++] = cosf(v + dv) * cosf(u);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u);
-            (*vertices)[k++] = sinf(v + dv); // normal
-            (*vertices)[k++] = u / pi2;
-            (*vertices)[k++] = (v + dv + 0.5f * pi) / pi; // texture coords
-
-            // p(u+du,v)
-            (*vertices)[k++] = cosf(v) * cosf(u + du);
-            (*vertices)[k++] = cosf(v) * sinf(u + du);
-            (*vertices)[k++] = sinf(v); // position
-            (*vertices)[k++] = cosf(v) * cosf(u + du);
-            (*vertices)[k++] = cosf(v) * sinf(u + du);
-            (*vertices)[k++] = sinf(v); // normal
-            (*vertices)[k++] = (u + du) / pi2;
-            (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-            // p(u+du,v+dv)
-            (*vertices)[k++] = cosf(v + dv) * cosf(u + du);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u + du);
-            (*vertices)[k++] = sinf(v + dv); // position
-            (*vertices)[k++] = cosf(v + dv) * cosf(u + du);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u + du);
-            (*vertices)[k++] = sinf(v + dv); // normal
-            (*vertices)[k++] = (u + du) / pi2;
-            (*vertices)[k++] = (v + dv + 0.5f * pi) / pi; // texture coords
-
-            // p(u,v+dv)
-            (*vertices)[k++] = cosf(v + dv) * cosf(u);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u);
-            (*vertices)[k++] = sinf(v + dv); // position
-            (*vertices)[k++] = cosf(v + dv) * cosf(u);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u);
-            (*vertices)[k++] = sinf(v + dv); // normal
-            (*vertices)[k++] = u / pi2;
-            (*vertices)[k++] = (v + dv + 0.5f * pi) / pi; // texture coords
-        }
-    }
-    // triangles around north pole and south pole
-    for (u = 0.0f; u < pi2; u += du)
-    {
-        // triangles around north pole
-        // p(u,pi/2-dv)
-        v = 0.5f * pi - dv;
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = u / pi2;
-        (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-        // p(u+du,pi/2-dv)
-        v = 0.5f * pi - dv;
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = (u + du) / pi2;
-        (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-        // p(u,pi/2) = (0, 1. 0)  ~ north pole
-        v = 0.5f * pi;
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = (u + du) / pi2;
-        (*vertices)[k++] = 1.0f; // texture coords
-
-        // triangles around south pole
-        // p(u,-pi/2) = (0, -1, 0)  ~ south pole
-        v = (-0.5f) * pi;
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = u / pi2;
-        (*vertices)[k++] = 0.0f; // texture coords
-
-        // p(u+du,-pi/2+dv)
-        v = (-0.5f) * pi + dv;
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = (u + du) / pi2;
-        (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-        // p(u,-pi/2+dv)
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = u / pi2;
-        (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-    }
 }
\ No newline at end of file
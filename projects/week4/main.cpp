@@ -13,11 +13,11 @@
 #include <backends/imgui_impl_opengl3.h>
 
 #include "shader.hpp"
+#include "gl_extensions.hpp"
 #include "logger.hpp"
 #include "type.hpp"
 #include "camera.h"
-
-#include "teapot_loader.h"
+#include "mesh_file.hpp"
 
 void framebuffer_size_callback(GLFWwindow *window, int width, int height);
 void mouse_callback(GLFWwindow *window, double xpos, double ypos);
@@ -85,6 +85,7 @@ int main()
         glfwTerminate();
         exit(EXIT_FAILURE);
     }
+    GameProgramming::GL::loadExtensions(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
     glfwSwapInterval(1);
 
     // ImGUI setup
@@ -147,28 +148,26 @@ int main()
     glEnableVertexAttribArray(0);
 
     // teapot VAO and VBO
-    std::vector<float> data;
-    Teapot teapot(RESOURCE_PATH_PREFIX "other/teapot.vbo", data, 8);
+    // teapot.mesh is generated from teapot.vbo by mesh-converter (welded, indexed); the mapped payloads go to the VBO/EBO as is
+    unsigned int teapotVBO, teapotEBO, teapotVAO, teapotIndexCount;
+    GLenum teapotIndexType;
+    {
+        GameProgramming::Mesh::MeshFile teapotMesh{RESOURCE_PATH_PREFIX "other/teapot.mesh"};
+        teapotIndexCount = teapotMesh.indexCount();
+        teapotIndexType = static_cast<GLenum>(teapotMesh.indexType());
 
-    unsigned int teapotVBO, teapotVAO;
-    glGenVertexArrays(1, &teapotVAO);
-    glGenBuffers(1, &teapotVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, teapotVBO);
-    glBufferData(GL_ARRAY_BUFFER, teapot.nVertNum * teapot.nVertFloats * sizeof(float), &data[0],
-                 GL_STATIC_DRAW);
+        glGenVertexArrays(1, &teapotVAO);
+        glGenBuffers(1, &teapotVBO);
+        glGenBuffers(1, &teapotEBO);
+        glBindBuffer(GL_ARRAY_BUFFER, teapotVBO);
+        teapotMesh.uploadVertexData(GL_STATIC_DRAW);
 
-    glBindVertexArray(teapotVAO);
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, teapot.nVertFloats * sizeof(float), (void *)0);
-    glEnableVertexAttribArray(0);
-    // texCoord attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, teapot.nVertFloats * sizeof(float),
-                          (void *)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    // normal attribute
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, teapot.nVertFloats * sizeof(float),
-                          (void *)(5 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+        glBindVertexArray(teapotVAO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, teapotEBO);
+        teapotMesh.uploadIndexData(GL_STATIC_DRAW);
+        // position(0), texCoord(1), normal(2) attributes as recorded in the file
+        teapotMesh.setupVertexAttributes();
+    }
 
     // configure global opengl state
     // -----------------------------
@@ -232,7 +231,7 @@ int main()
         teapotShader1.setUniformMatrix4f("model", model);
         // render the teapot
         glBindVertexArray(teapotVAO);
-        glDrawArrays(GL_TRIANGLES, 0, teapot.nVertNum);
+        glDrawElements(GL_TRIANGLES, teapotIndexCount, teapotIndexType, nullptr);
 
         // draw the teapot object 2
         // light properties
@@ -257,7 +256,7 @@ int main()
         teapotShader1.setUniformMatrix4f("model", model);
         // render the teapot
         glBindVertexArray(teapotVAO);
-        glDrawArrays(GL_TRIANGLES, 0, teapot.nVertNum);
+        glDrawElements(GL_TRIANGLES, teapotIndexCount, teapotIndexType, nullptr);
 
         // draw the teapot object 3
         // light properties
@@ -284,7 +283,7 @@ int main()
         teapotShader1.setUniformMatrix4f("model", model);
         // render the teapot
         glBindVertexArray(teapotVAO);
-        glDrawArrays(GL_LINES, 0, teapot.nVertNum);
+        glDrawElements(GL_LINES, teapotIndexCount, teapotIndexType, nullptr);
 
         // also draw the lamp object
         lampShader.use();
@@ -329,6 +328,7 @@ int main()
     glDeleteVertexArrays(1, &teapotVAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &teapotVBO);
+    glDeleteBuffers(1, &teapotEBO);
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
     // ------------------------------------------------------------------
@@ -10,6 +10,7 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "_shader.h"
+#include "gl_extensions.hpp"
 #include "camera.h"
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -73,6 +74,7 @@ int main()
 		std::cout << "Failed to initialize GLAD" << std::endl;
 		return -1;
 	}
+	GameProgramming::GL::loadExtensions((GLADloadproc)glfwGetProcAddress);
 
 	// configure global opengl state
 	// -----------------------------
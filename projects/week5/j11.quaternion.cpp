@@ -8,6 +8,7 @@
 #include <iostream>
 
 #include "_shader.h"
+#include "gl_extensions.hpp"
 #include "camera.h"
 
 
@@ -17,7 +18,7 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void processInput(GLFWwindow *window);
 
 // object drawing
-void drawLShape(unsigned int VAO, unsigned int nVert, bool bSolid, bool bColor, glm::mat4 model_curr, Shader shader);
+void drawLShape(unsigned int VAO, unsigned int nVert, bool bSolid, bool bColor, glm::mat4 model_curr, const Shader &shader);
 
 // settings
 const unsigned int SCR_WIDTH = 800;
@@ -73,6 +74,7 @@ int main()
 		std::cout << "Failed to initialize GLAD" << std::endl;
 		return -1;
 	}
+	GameProgramming::GL::loadExtensions((GLADloadproc)glfwGetProcAddress);
 
 	// configure global opengl state
 	// -----------------------------
@@ -270,7 +272,7 @@ int main()
 }
 
 // draw L shape
-void drawLShape(unsigned int VAO, unsigned int nVert, bool bSolid, bool bColor, glm::mat4 model_curr, Shader shader)
+void drawLShape(unsigned int VAO, unsigned int nVert, bool bSolid, bool bColor, glm::mat4 model_curr, const Shader &shader)
 {
 	glm::vec3 color1 = glm::vec3(1.0f, 0.0f, 1.0f);
 	glm::vec3 color2 = glm::vec3(0.0f, 1.0f, 1.0f);
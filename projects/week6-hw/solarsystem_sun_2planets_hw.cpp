@@ -20,104 +20,11 @@
 #include <filesystem>
 #include <string>
 
-// Shader classes
-namespace GameProgramming::Shader
-{
-
-enum class ShaderType
-{
-    Vertex = GL_VERTEX_SHADER,
-    Fragment = GL_FRAGMENT_SHADER,
-    Geometry = GL_GEOMETRY_SHADER
-};
-
-class ShaderProgram
-{
-public:
-    ShaderProgram(std::filesystem::path vertexShaderSrc = "./shader.vert",
-                  std::filesystem::path fragmentShaderSrc = "./shader.frag");
-    ~ShaderProgram();
-    ShaderProgram(const ShaderProgram &) = delete;
-    ShaderProgram &operator=(const ShaderProgram &) = delete;
-    ShaderProgram(ShaderProgram &&) = delete;
-    ShaderProgram &operator=(ShaderProgram &&) = delete;
-
-    void use() const noexcept
-    {
-        glUseProgram(m_program);
-    }
-
-    [[nodiscard]] GLuint get() const noexcept
-    {
-        return m_program;
-    }
-    [[nodiscard]] GLint getUniformLocation(const char *uniformName) const noexcept
-    {
-        return glGetUniformLocation(m_program, uniformName);
-    }
-
-    void setUniformMatrix4f(const char *uniformName, const GLfloat *matrix) const noexcept
-    {
-        glUniformMatrix4fv(glGetUniformLocation(m_program, uniformName), 1, GL_FALSE, matrix);
-    }
-
-    void setUniformMatrix4f(const char *uniformName, const glm::mat4 &matrix) const noexcept
-    {
-        glUniformMatrix4fv(glGetUniformLocation(m_program, uniformName), 1, GL_FALSE,
-                           glm::value_ptr(matrix));
-    }
-
-    void setUniformVec3(const char *uniformName, const GLfloat *vector) const noexcept
-    {
-        glUniform3fv(glGetUniformLocation(m_program, uniformName), 1, vector);
-    }
-
-    void setUniformVec3(const char *uniformName, const glm::vec3 &vector) const noexcept
-    {
-        glUniform3fv(glGetUniformLocation(m_program, uniformName), 1, glm::value_ptr(vector));
-    }
-
-    void setUniformVec3(const char *uniformName, GLfloat x, GLfloat y, GLfloat z) const noexcept
-    {
-        glUniform3f(glGetUniformLocation(m_program, uniformName), x, y, z);
-    }
+#include "sphere.hpp"
 
-    void setUniformFloat(const char *uniformName, const GLfloat value) const noexcept
-    {
-        glUniform1f(glad_glGetUniformLocation(m_program, uniformName), value);
-    }
-
-private:
-    GLuint m_program;
-};
-
-class ShaderObject
-{
-public:
-    ShaderObject(std::filesystem::path src, ShaderType shaderType);
-    ~ShaderObject();
-    ShaderObject(const ShaderObject &) = delete;
-    ShaderObject operator=(const ShaderObject &) = delete;
-    ShaderObject(ShaderObject &&) = delete;
-    ShaderObject operator=(ShaderObject &&) = delete;
-
-    [[nodiscard]] GLuint getID() const noexcept
-    {
-        return m_shader;
-    }
-
-private:
-    GLuint m_shader;
-    std::filesystem::path m_shaderPath;
-};
-
-class ShaderLoader
-{
-public:
-    static std::string loadShaderScript(const std::filesystem::path &src);
-};
-
-} // namespace GameProgramming::Shader
+// Shader classes
+#include "shader.hpp"
+#include "gl_extensions.hpp"
 
 // Camera class
 namespace
@@ -276,7 +183,6 @@ void framebuffer_size_callback(GLFWwindow *window, int width, int height);
 void mouse_callback(GLFWwindow *window, double xpos, double ypos);
 void scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
 void processInput(GLFWwindow* window);
-void init_sphere(float **, int *, int *);
 void init_textures();
 
 #ifndef RESOURCE_PATH_PREFIX
@@ -350,6 +256,8 @@ constexpr float radi_neptune = 0.4f; // 24622.0f;
 GLuint texture_sun, texture_mercury, texture_venus, texture_earth, texture_moon;
 GLuint texture_mars, texture_jupiter, texture_saturn, texture_uranus, texture_neptune;
 
+using Sphere = GameProgramming::Mesh::SphereLodChain<8, 128>;
+
 void drawPlanet(
     float distance,
     float radius,
@@ -359,7 +267,7 @@ void drawPlanet(
     const GameProgramming::Shader::ShaderProgram &_planetShader,
     GLuint textureID,
     GLuint &sphereVAO, 
-    int &nSphereVert)
+    const Sphere &sphere)
 {
     // mercury
     // -----------
@@ -382,7 +290,7 @@ void drawPlanet(
 
     // render the sphere
     glBindVertexArray(sphereVAO);
-    glDrawArrays(GL_TRIANGLES, 0, nSphereVert);
+    sphere.draw(Sphere::selectLod(model, camera.Position, glm::radians(camera.Zoom), SCR_HEIGHT));
 }
 
 int main()
@@ -424,6 +332,7 @@ int main()
         glfwTerminate();
         exit(EXIT_FAILURE);
     }
+    GameProgramming::GL::loadExtensions(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
     glfwSwapInterval(1);
 
     // configure global opengl state
@@ -443,20 +352,20 @@ int main()
         RESOURCE_PATH_PREFIX "shaders/solarsystem_star.fs"
     };
 
-    // sphere VAO and VBO
-    // std::vector <float> data;
-    float *sphereVerts = nullptr;
-    int nSphereVert, nSphereAttr;
-    init_sphere(&sphereVerts, &nSphereVert, &nSphereAttr);
+    // sphere VAO, VBO and EBO: every LOD of the sphere lives in the same buffers
+    const Sphere sphere;
+    constexpr int nSphereAttr = Sphere::FloatsPerVertex;
 
-    GLuint sphereVBO, sphereVAO;
+    GLuint sphereVBO, sphereEBO, sphereVAO;
     glGenVertexArrays(1, &sphereVAO);
     glGenBuffers(1, &sphereVBO);
+    glGenBuffers(1, &sphereEBO);
     glBindBuffer(GL_ARRAY_BUFFER, sphereVBO);
-    glBufferData(GL_ARRAY_BUFFER, nSphereVert * nSphereAttr * sizeof(float), sphereVerts,
-                 GL_STATIC_DRAW);
+    sphere.mesh().uploadVertexData(GL_STATIC_DRAW);
 
     glBindVertexArray(sphereVAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphereEBO);
+    sphere.mesh().uploadIndexData(GL_STATIC_DRAW);
     // position attribute
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, nSphereAttr * sizeof(float), (const GLvoid *)0);
     glEnableVertexAttribArray(0);
@@ -469,8 +378,6 @@ int main()
                           (const GLvoid *)(6 * sizeof(float)));
     glEnableVertexAttribArray(2);
 
-    free(sphereVerts);
-
     // init textures
     init_textures();
 
@@ -522,7 +429,7 @@ int main()
 
         // render the sphere
         glBindVertexArray(sphereVAO);
-        glDrawArrays(GL_TRIANGLES, 0, nSphereVert);
+        sphere.draw(Sphere::selectLod(model, camera.Position, glm::radians(camera.Zoom), SCR_HEIGHT));
 
         // Planets, moon
         // -----------
@@ -555,18 +462,18 @@ int main()
         // -----------
         // world transformation
         float dist = radi_sun + 3 * radi_mercury;
-        drawPlanet(dist, radi_mercury, revp_mercury, rotp_mercury, sun_model, _planetShader, texture_mercury, sphereVAO, nSphereVert);
+        drawPlanet(dist, radi_mercury, revp_mercury, rotp_mercury, sun_model, _planetShader, texture_mercury, sphereVAO, sphere);
 
         // venus
         // -----------
         // world transformation
         dist = dist + 3 * radi_venus;
-        drawPlanet(dist, radi_venus, revp_venus, rotp_venus, sun_model, _planetShader, texture_venus, sphereVAO, nSphereVert);
+        drawPlanet(dist, radi_venus, revp_venus, rotp_venus, sun_model, _planetShader, texture_venus, sphereVAO, sphere);
 
         // earth
         // -----------
         dist = dist + 3 * radi_earth;
-        // drawPlanet(dist, radi_earth, revp_earth, rotp_earth, sun_model, _planetShader, texture_earth, sphereVAO, nSphereVert);
+        // drawPlanet(dist, radi_earth, revp_earth, rotp_earth, sun_model, _planetShader, texture_earth, sphereVAO, sphere);
         model = sun_model;
         // the revolution of the earth
         model = glm::rotate(model, (float)glfwGetTime() * rot_speed / revp_earth, glm::vec3(0.0f, 1.0f, 0.0f));
@@ -585,7 +492,7 @@ int main()
 
         // render the sphere
         glBindVertexArray(sphereVAO);
-        glDrawArrays(GL_TRIANGLES, 0, nSphereVert);
+        sphere.draw(Sphere::selectLod(model, camera.Position, glm::radians(camera.Zoom), SCR_HEIGHT));
 
         // moon
         // -----------
@@ -604,32 +511,32 @@ int main()
 
         // render the sphere
         glBindVertexArray(sphereVAO);
-        glDrawArrays(GL_TRIANGLES, 0, nSphereVert);
+        sphere.draw(Sphere::selectLod(model, camera.Position, glm::radians(camera.Zoom), SCR_HEIGHT));
 
         // mars
         // -----------
         dist = dist + 3 * radi_mars;
-        drawPlanet(dist, radi_mars, revp_mars, rotp_mars, sun_model, _planetShader, texture_mars, sphereVAO, nSphereVert);
+        drawPlanet(dist, radi_mars, revp_mars, rotp_mars, sun_model, _planetShader, texture_mars, sphereVAO, sphere);
 
         // jupiter
         // -----------
         dist = dist + 3 * radi_jupiter;
-        drawPlanet(dist, radi_jupiter, revp_jupiter, rotp_jupiter, sun_model, _planetShader, texture_jupiter, sphereVAO, nSphereVert);
+        drawPlanet(dist, radi_jupiter, revp_jupiter, rotp_jupiter, sun_model, _planetShader, texture_jupiter, sphereVAO, sphere);
 
         // saturn
         // -----------
         dist = dist + 3 * radi_saturn;
-        drawPlanet(dist, radi_saturn, revp_saturn, rotp_saturn, sun_model, _planetShader, texture_saturn, sphereVAO, nSphereVert);
+        drawPlanet(dist, radi_saturn, revp_saturn, rotp_saturn, sun_model, _planetShader, texture_saturn, sphereVAO, sphere);
 
         // uranus
         // -----------
         dist = dist + 3 * radi_uranus;
-        drawPlanet(dist, radi_uranus, revp_uranus, rotp_uranus, sun_model, _planetShader, texture_uranus, sphereVAO, nSphereVert);
+        drawPlanet(dist, radi_uranus, revp_uranus, rotp_uranus, sun_model, _planetShader, texture_uranus, sphereVAO, sphere);
 
         // neptune
         // -----------
         dist = dist + 3 * radi_neptune;
-        drawPlanet(dist, radi_neptune, revp_neptune, rotp_neptune, sun_model, _planetShader, texture_neptune, sphereVAO, nSphereVert);
+        drawPlanet(dist, radi_neptune, revp_neptune, rotp_neptune, sun_model, _planetShader, texture_neptune, sphereVAO, sphere);
         
         // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
         // -------------------------------------------------------------------------------
@@ -640,6 +547,7 @@ int main()
     // ------------------------------------------------------------------------
     glDeleteVertexArrays(1, &sphereVAO);
     glDeleteBuffers(1, &sphereVBO);
+    glDeleteBuffers(1, &sphereEBO);
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
     // ------------------------------------------------------------------
@@ -700,164 +608,6 @@ void scroll_callback(GLFWwindow *window, double xoffset, double yoffset)
     camera.ProcessMouseScroll(yoffset);
 }
 
-// initalize vertices of a sphere : position, normal, tex_coords.
-// void initSphere(std::vector <float> data, int* nVert, int* nAttr)
-void init_sphere(float **vertices, int *nVert, int *nAttr)
-{
-    //----------------------------------------
-    // sphere: set up vertex data and configure vertex attributes
-    float pi = acosf(-1.0f); // pi = 3.14152...
-    float pi2 = 2.0f * pi;
-    int nu = 40, nv = 20;
-    const double du = pi2 / nu;
-    const double dv = pi / nv;
-
-    *nVert = (nv - 1) * nu * 6; // two triangles
-    *nAttr = 8;
-    *vertices = (float *)malloc(sizeof(float) * (*nVert) * (*nAttr));
-
-    float u, v;
-    int k = 0;
-
-    v = 0.0f;
-    u = 0.0f;
-    for (v = (-0.5f) * pi + dv; v < 0.5f * pi - dv; v += dv)
-    {
-        for (u = 0.0f; u < pi2; u += du)
-        {
-            // p(u,v)
-            (*vertices)[k++] = cosf(v) * cosf(u);
-            (*vertices)[k++] = cosf(v) * sinf(u);
-            (*vertices)[k++] = sinf(v); // position
-            (*vertices)[k++] = cosf(v) * cosf(u);
-            (*vertices)[k++] = cosf(v) * sinf(u);
-            (*vertices)[k++] = sinf(v); // normal
-            (*vertices)[k++] = u / pi2;
-            (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-            // p(u+du,v)
-            (*vertices)[k++] = cosf(v) * cosf(u + du);
-            (*vertices)[k++] = cosf(v) * sinf(u + du);
-            (*vertices)[k++] = sinf(v); // position
-            (*vertices)[k++] = cosf(v) * cosf(u + du);
-            (*vertices)[k++] = cosf(v) * sinf(u + du);
-            (*vertices)[k++] = sinf(v); // normal
-            (*vertices)[k++] = (u + du) / pi2;
-            (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-            // p(u,v+dv)
-            (*vertices)[k++] = cosf(v + dv) * cosf(u);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u);
-            (*vertices)[k++] = sinf(v + dv); // position
-            (*vertices)[k++] = cosf(v + dv) * cosf(u);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u);
-            (*vertices)[k++] = sinf(v + dv); // normal
-            (*vertices)[k++] = u / pi2;
-            (*vertices)[k++] = (v + dv + 0.5f * pi) / pi; // texture coords
-
-            // p(u+du,v)
-            (*vertices)[k++] = cosf(v) * cosf(u + du);
-            (*vertices)[k++] = cosf(v) * sinf(u + du);
-            (*vertices)[k++] = sinf(v); // position
-            (*vertices)[k++] = cosf(v) * cosf(u + du);
-            (*vertices)[k++] = cosf(v) * sinf(u + du);
-            (*vertices)[k++] = sinf(v); // normal
-            (*vertices)[k++] = (u + du) / pi2;
-            (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-            // p(u+du,v+dv)
-            (*vertices)[k++] = cosf(v + dv) * cosf(u + du);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u + du);
-            (*vertices)[k++] = sinf(v + dv); // position
-            (*vertices)[k++] = cosf(v + dv) * cosf(u + du);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u + du);
-            (*vertices)[k++] = sinf(v + dv); // normal
-            (*vertices)[k++] = (u + du) / pi2;
-            (*vertices)[k++] = (v + dv + 0.5f * pi) / pi; // texture coords
-
-            // p(u,v+dv)
-            (*vertices)[k++] = cosf(v + dv) * cosf(u);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u);
-            (*vertices)[k++] = sinf(v + dv); // position
-            (*vertices)[k++] = cosf(v + dv) * cosf(u);
-            (*vertices)[k++] = cosf(v + dv) * sinf(u);
-            (*vertices)[k++] = sinf(v + dv); // normal
-            (*vertices)[k++] = u / pi2;
-            (*vertices)[k++] = (v + dv + 0.5f * pi) / pi; // texture coords
-        }
-    }
-    // triangles around north pole and south pole
-    for (u = 0.0f; u < pi2; u += du)
-    {
-        // triangles around north pole
-        // p(u,pi/2-dv)
-        v = 0.5f * pi - dv;
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = u / pi2;
-        (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-        // p(u+du,pi/2-dv)
-        v = 0.5f * pi - dv;
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = (u + du) / pi2;
-        (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-        // p(u,pi/2) = (0, 1. 0)  ~ north pole
-        v = 0.5f * pi;
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = (u + du) / pi2;
-        (*vertices)[k++] = 1.0f; // texture coords
-
-        // triangles around south pole
-        // p(u,-pi/2) = (0, -1, 0)  ~ south pole
-        v = (-0.5f) * pi;
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = u / pi2;
-        (*vertices)[k++] = 0.0f; // texture coords
-
-        // p(u+du,-pi/2+dv)
-        v = (-0.5f) * pi + dv;
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u + du);
-        (*vertices)[k++] = cosf(v) * sinf(u + du);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = (u + du) / pi2;
-        (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-
-        // p(u,-pi/2+dv)
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // position
-        (*vertices)[k++] = cosf(v) * cosf(u);
-        (*vertices)[k++] = cosf(v) * sinf(u);
-        (*vertices)[k++] = sinf(v); // normal
-        (*vertices)[k++] = u / pi2;
-        (*vertices)[k++] = (v + 0.5f * pi) / pi; // texture coords
-    }
-}
-
 void loadTexture(GLuint &textureID, const char *path)
 {
     glGenTextures(1, &textureID);
@@ -1,38 +1,75 @@
 #pragma once
 
+#include "animation_state.hpp"
+#include "baked_animation.hpp"
+#include "j13.human.h"
+
 #include <cstdint>
+#include <initializer_list>
+#include <utility>
 
+// States of the Human state machine, in the order BuildHumanAnimation adds them
 enum AnimationState : uint8_t
 {
     ANIM_WALKING = 0,
-    ANIM_WALKING_TO_GREETING,
     ANIM_GREETING,
-    ANIM_GREETING_TO_WALKING
 };
 
-struct AnimationController
+// Walks two cycles, fades into the greeting, waves twice and fades back into walking.
+//   walk  : walk_1 -0.5s- walk_2 -0.9s- walk_3 -0.5s- walk_4 -0.9s- back to walk_1
+//   greet : greet_0 -1.0s- greet_1 -0.3s- greet_2 -0.4s- greet_3 -0.3s- greet_4 -0.4s- back to greet_2
+inline GameProgramming::Animation::AnimationStateMachine BuildHumanAnimation(const Human &human)
+{
+    using GameProgramming::Animation::AnimationClip;
+
+    const auto buildClip = [&](std::initializer_list<std::pair<Human_Pose, float>> keys, u32 loopKey, float loopDuration)
+    {
+        AnimationClip clip(BoneCount);
+        for (const auto &[pose, time] : keys)
+            clip.addKey(time, human.PoseRotations(pose));
+        clip.setLoop(loopKey, loopDuration);
+        return clip;
+    };
+
+    GameProgramming::Animation::AnimationStateMachine machine(BoneCount);
+    const u32 walk = machine.addClip(buildClip({{walk_1, 0.0f}, {walk_2, 0.5f}, {walk_3, 1.4f}, {walk_4, 1.9f}}, 0, 2.8f));
+    const u32 greet = machine.addClip(
+        buildClip({{greet_0, 0.0f}, {greet_1, 1.0f}, {greet_2, 1.3f}, {greet_3, 1.7f}, {greet_4, 2.0f}}, 2, 2.4f));
+
+    machine.addState("WALKING", walk);
+    machine.addState("GREETING", greet);
+    machine.setExit(ANIM_WALKING, 2, ANIM_GREETING, 1.5f);
+    machine.setExit(ANIM_GREETING, 2, ANIM_WALKING, 1.0f);
+    return machine;
+}
+
+// Clips baked by BakeHumanAnimation, in order
+enum BakedHumanClip : uint8_t
+{
+    BAKED_WALKING = 0, // the walk cycle
+    BAKED_GREETING,    // the wave, greet_2 to greet_4 and back
+    BAKED_ROUTINE,     // the whole machine: two walk cycles, the greeting and back, as BuildHumanAnimation plays it
+};
+
+// The Human clips as skinning palettes of a mesh bound with `inverseBind`, 30 frames a second.
+inline GameProgramming::Animation::BakedAnimation BakeHumanAnimation(const GameProgramming::Animation::AnimationStateMachine &machine,
+                                                                      const glm::mat4 *inverseBind)
 {
-    const char *currentStateStr() const
+    using GameProgramming::Animation::AnimationPlayer;
+
+    // how long a state plays before it leaves through its exit's fade
+    const auto stateTime = [&](u32 state)
     {
-        switch (currentState)
-        {
-        case ANIM_WALKING:
-            return "WALKING";
-        case ANIM_WALKING_TO_GREETING:
-            return "WALKING_TO_GREETING";
-        case ANIM_GREETING:
-            return "GREETING";
-        case ANIM_GREETING_TO_WALKING:
-            return "GREETING_TO_WALKING";
-        default:
-            return "UNKNOWN";
-        }
-    }
-
-    AnimationState currentState = ANIM_WALKING;
-    int walkingCycleCount = 0;
-    int greetingCycleCount = 0;
-
-    const int MAX_WALKING_CYCLES = 2;
-    const int MAX_GREETING_CYCLES = 2;
-};
\ No newline at end of file
+        const GameProgramming::Animation::AnimationState &s = machine.state(state);
+        const GameProgramming::Animation::AnimationClip &clip = machine.clip(s.clip);
+        return clip.duration() + (s.exitLoops - 1) * (clip.duration() - clip.loopStart()) + s.fadeDuration;
+    };
+    const GameProgramming::Animation::AnimationClip &walk = machine.clip(machine.state(ANIM_WALKING).clip);
+    const GameProgramming::Animation::AnimationClip &greet = machine.clip(machine.state(ANIM_GREETING).clip);
+
+    GameProgramming::Animation::BakedAnimation baked(Human::SharedSkeleton(), inverseBind, 30.0f);
+    baked.addClip(AnimationPlayer(machine, ANIM_WALKING), walk.duration());
+    baked.addClip(AnimationPlayer(machine, ANIM_GREETING, greet.loopStart()), greet.duration() - greet.loopStart());
+    baked.addClip(AnimationPlayer(machine, ANIM_WALKING), stateTime(ANIM_WALKING) + stateTime(ANIM_GREETING));
+    return baked;
+}
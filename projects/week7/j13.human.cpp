@@ -12,11 +12,25 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
 #include <vector>
-#include <cstdio>
 
 #include "_shader.h"
+#include "animation_state.hpp"
+#include "bone_renderer.hpp"
+#include "crowd_animation.hpp"
+#include "gl_extensions.hpp"
+#include "baked_crowd_renderer.hpp"
+#include "job_system.hpp"
+#include "skinned_renderer.hpp"
+#include "shader_watcher.hpp"
 #include "camera.h"
 #include "j13.human.h"
 #include "AnimationState.h"
@@ -43,6 +57,19 @@ const unsigned int SCR_HEIGHT = 1200;
 bool isF1KeyPressed = false;
 bool showImGuiOverlay = true;
 
+// how the humans are drawn; I cycles through them
+enum DrawPath
+{
+    DRAW_PER_BONE,  // 20 rigid cubes per human, one draw call each
+    DRAW_INSTANCED, // every cube of every human in one instanced draw
+    DRAW_SKINNED,   // one skinned mesh per human, every human in one instanced draw
+    DRAW_BAKED,     // the crowd skinned from baked clips on the GPU alone, in one instanced draw
+    DRAW_PATH_COUNT
+};
+const char *const DrawPathNames[DRAW_PATH_COUNT] = {"per bone", "instanced", "skinned", "baked"};
+DrawPath drawPath = DRAW_SKINNED;
+bool isIKeyPressed = false;
+
 // camera
 Camera camera(glm::vec3(0.0f, 0.0f, 20.0f));
 float lastX = SCR_WIDTH / 2.0f;
@@ -56,8 +83,23 @@ float lastFrame = 0.0f;
 // lighting
 glm::vec3 lightPos(1.2f, 10.0f, 20.0f);
 
-int main()
+void drawBoneInstances(const Shader &shader, unsigned int cubeVAO, const GameProgramming::Animation::BoneInstance *bones, int count);
+glm::mat4 crowdModel(int index, int crowdSize);
+
+// run with --crowd N to add N humans walking in place behind the animated one, animated on --threads T
+// threads (all hardware threads by default)
+int main(int argc, char **argv)
 {
+    int crowdSize = 0;
+    u32 workerCount = GameProgramming::Job::JobSystem::defaultWorkerCount();
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--crowd") == 0)
+            crowdSize = std::max(0, std::atoi(argv[i + 1]));
+        else if (std::strcmp(argv[i], "--threads") == 0)
+            workerCount = static_cast<u32>(std::max(1, std::atoi(argv[i + 1])) - 1);
+    }
+
     // glfw: initialize and configure
     // ------------------------------
     glfwInit();
@@ -96,6 +138,7 @@ int main()
         ERROR("Failed to initialize GLAD\n");
         return -1;
     }
+    GameProgramming::GL::loadExtensions((GLADloadproc)glfwGetProcAddress);
     glfwSwapInterval(1);
 
     // configure global opengl state
@@ -106,6 +149,12 @@ int main()
     // ------------------------------------
     Shader boneShader(RESOURCE_PATH_PREFIX "j13.human.vs",
                       RESOURCE_PATH_PREFIX "j13.human.fs");
+    Shader instancedShader(RESOURCE_PATH_PREFIX "j13.human_instanced.vs",
+                           RESOURCE_PATH_PREFIX "j13.human.fs");
+    Shader skinnedShader(RESOURCE_PATH_PREFIX "j13.human_skinned.vs",
+                         RESOURCE_PATH_PREFIX "j13.human.fs");
+    Shader bakedShader(RESOURCE_PATH_PREFIX "j13.human_baked.vs",
+                       RESOURCE_PATH_PREFIX "j13.human.fs");
     // set up vertex data (and buffer(s)) and configure vertex attributes
     // ------------------------------------------------------------------
     float vertices[] = {
@@ -161,9 +210,52 @@ int main()
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)0);
     glEnableVertexAttribArray(0);
 
-    // Human
+    // Human, walking and greeting by BuildHumanAnimation's state machine
     Human human{};
-    Human_Pose currentPose{walk_1}, nextPose{walk_2};
+    const GameProgramming::Animation::AnimationStateMachine humanAnimation = BuildHumanAnimation(human);
+    GameProgramming::Animation::AnimationPlayer animation(humanAnimation, ANIM_WALKING);
+    float walkedDistance = 0.0f;
+
+    // every crowd human runs the same state machine from its own point in time, animated in chunks on every
+    // thread straight into the instance buffer; two regions, so the GPU draws one frame while the threads
+    // write the next. The per-bone path has them write to plain memory and draws from there.
+    GameProgramming::Job::JobSystem jobs(workerCount);
+    GameProgramming::Animation::CrowdAnimation crowd(humanAnimation, Human::SharedSkeleton(), Human::BoneColors(), jobs);
+    for (int i = 0; i < crowdSize; ++i)
+        crowd.add(crowdModel(i, crowdSize), ANIM_WALKING, std::fmod(0.618034f * i, 20.0f));
+    std::vector<GameProgramming::Animation::BoneInstance> crowdBones;
+    const int humanCount = crowdSize + 1;
+    GameProgramming::Animation::BoneRenderer boneRenderer(VBO, 36, static_cast<u32>(humanCount * BoneCount), 2);
+
+    // the skinned path: the bone shapes as one mesh bound in the base pose, and one palette per human
+    const GameProgramming::Animation::SkinnedMesh skinnedMesh = GameProgramming::Animation::buildSkinnedBones(
+        Human::SharedSkeleton(), human.PoseRotations(base), Human::BoneColors());
+    GameProgramming::Animation::SkinnedRenderer skinnedRenderer(skinnedMesh, static_cast<u32>(humanCount), 2);
+    skinnedShader.use();
+    skinnedShader.setInt("palette", GameProgramming::Animation::SkinnedRenderer::PaletteUnit);
+    skinnedShader.setInt("boneCount", BoneCount);
+
+    // the baked path: the crowd plays the whole routine from a texture baked once here, each human from its
+    // own offset; only the animated human in front is still skinned on the CPU
+    const GameProgramming::Animation::BakedAnimation bakedAnimation = BakeHumanAnimation(humanAnimation, skinnedMesh.inverseBind.data());
+    std::vector<GameProgramming::Animation::BakedInstance> bakedInstances;
+    bakedInstances.reserve(crowdSize);
+    for (int i = 0; i < crowdSize; ++i)
+        bakedInstances.push_back({glm::vec3(crowdModel(i, crowdSize)[3]), std::fmod(0.618034f * i, 20.0f), BAKED_ROUTINE});
+    GameProgramming::Animation::BakedCrowdRenderer bakedRenderer(skinnedMesh, bakedAnimation, bakedInstances);
+    bakedShader.use();
+    bakedRenderer.setUniforms(bakedShader.uniformTable());
+
+    // edits to j13.human.vs/.fs are rebuilt in the background and swapped in between frames
+    GameProgramming::Shader::ShaderWatcher shaderWatcher;
+    shaderWatcher.watch(boneShader);
+    shaderWatcher.watch(instancedShader);
+    shaderWatcher.watch(skinnedShader);
+    shaderWatcher.watch(bakedShader);
+
+    float titleTimer = 0.0f;
+    int titleFrames = 0;
+    double animationMs = 0.0; // the crowd's update, summed over the title's frames
 
     // render loop
     // -----------
@@ -177,6 +269,8 @@ int main()
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
+        shaderWatcher.update();
+
         // input
         // -----
         processInput(window);
@@ -186,189 +280,85 @@ int main()
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // be sure to activate shader when setting uniforms/drawing objects
-        boneShader.use();
-        boneShader.setVec3("lightColor", 1.0f, 1.0f, 1.0f);
-        boneShader.setVec3("lightPos", lightPos);
-        boneShader.setVec3("viewPos", camera.Position);
-
-        // view/projection transformations
+        // view/projection transformations; far enough for the back rows of a crowd
         glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom),
-                                                (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
+                                                (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 500.0f);
         glm::mat4 view = camera.GetViewMatrix();
-        boneShader.setMat4("projection", projection);
-        boneShader.setMat4("view", view);
-
-        // world transformation
-        static AnimationController animationController{};
-        glm::mat4 model = glm::mat4(1.0f);
-        static glm::mat4 lastModel = model;
-        static float s = 0.0f;
-        if (animationController.walkingCycleCount < animationController.MAX_WALKING_CYCLES)
-        {
-            s += deltaTime;
-            model = glm::translate(model, glm::vec3(0.0f, 0.0f, s));
-            lastModel = model;
-        }
-        else
+
+        // be sure to activate shader when setting uniforms/drawing objects
+        for (Shader *shader : {&boneShader, &instancedShader, &skinnedShader, &bakedShader})
         {
-            model = lastModel;
+            shader->use();
+            shader->setVec3("lightColor", 1.0f, 1.0f, 1.0f);
+            shader->setVec3("lightPos", lightPos);
+            shader->setVec3("viewPos", camera.Position);
+            shader->setMat4("projection", projection);
+            shader->setMat4("view", view);
         }
 
-        boneShader.setMat4("model", model);
+        // animation: the human walks forward only while in the walking state
+        animation.update(deltaTime, human.BoneRotate);
+        if (animation.state() == ANIM_WALKING && !animation.fading())
+            walkedDistance += deltaTime;
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, walkedDistance));
 
         // render a human
         // human.SetBoneRotation(upperarmL, glm::angleAxis(glm::radians(30.f), glm::vec3(0.f,
         // 0.f, 1.f))); human.SetBoneRotation(forearmL, glm::angleAxis(glm::radians(60.f),
         // glm::vec3(0.f, 0.f, 1.f))); human.SetPose(armLeftUp);
-        static float t = 0.0f;
-        static float animationDuration = 1.0f;
-        static std::vector<glm::quat> BoneSnapshot;
-        float dt = deltaTime;
-        human.DrawHuman(boneShader, cubeVAO, model);
-        // human.MixPose(currentPose, nextPose, t);
-        if ((animationController.currentState == ANIM_GREETING) || 
-            (animationController.currentState == ANIM_WALKING))
+        if (drawPath == DRAW_SKINNED)
         {
-            human.MixPose(currentPose, nextPose, t);
+            glm::mat4 *palettes = skinnedRenderer.beginFrame();
+            human.WriteSkinningPalette(model, skinnedMesh.inverseBind.data(), palettes);
+            const auto animationStart = std::chrono::steady_clock::now();
+            crowd.updateSkinning(deltaTime, skinnedMesh.inverseBind.data(), palettes + BoneCount);
+            animationMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - animationStart).count();
+            skinnedShader.use();
+            skinnedRenderer.draw(static_cast<u32>(humanCount), skinnedShader.uniform<int>("paletteOffset").location);
+        }
+        else if (drawPath == DRAW_BAKED)
+        {
+            human.WriteSkinningPalette(model, skinnedMesh.inverseBind.data(), skinnedRenderer.beginFrame());
+            skinnedShader.use();
+            skinnedRenderer.draw(1, skinnedShader.uniform<int>("paletteOffset").location);
+            bakedShader.use();
+            bakedRenderer.draw(currentFrame, bakedShader.uniform<float>("time").location);
+        }
+        else if (drawPath == DRAW_INSTANCED)
+        {
+            GameProgramming::Animation::BoneInstance *instances = boneRenderer.beginFrame();
+            human.WriteBoneInstances(model, instances);
+            const auto animationStart = std::chrono::steady_clock::now();
+            crowd.update(deltaTime, instances + BoneCount);
+            animationMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - animationStart).count();
+            instancedShader.use();
+            boneRenderer.draw(static_cast<u32>(humanCount * BoneCount));
         }
         else
         {
-            human.MixPose(BoneSnapshot, nextPose, t);
+            crowdBones.resize(crowdSize * BoneCount);
+            const auto animationStart = std::chrono::steady_clock::now();
+            crowd.update(deltaTime, crowdBones.data());
+            animationMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - animationStart).count();
+            boneShader.use();
+            human.DrawHuman(boneShader, cubeVAO, model);
+            drawBoneInstances(boneShader, cubeVAO, crowdBones.data(), crowdSize * BoneCount);
         }
-        t = t + (dt / animationDuration);
-        static bool greetingStarted = false;
-        if (t > 1.0f)
+
+        // draw path, human count, frame time and the crowd's animation time in the title, once a second
+        titleTimer += deltaTime;
+        ++titleFrames;
+        if (titleTimer >= 1.0f)
         {
-            t = 0.0f;
-
-            switch (animationController.currentState)
-            {
-            case ANIM_WALKING:
-            {
-                switch (nextPose)
-                {
-                case walk_2:
-                {
-                    currentPose = walk_2;
-                    nextPose = walk_3;
-                    animationDuration = 0.9f;
-                }
-                break;
-
-                case walk_3:
-                {
-                    currentPose = walk_3;
-                    nextPose = walk_4;
-                    animationDuration = 0.5f;
-                }
-                break;
-
-                case walk_4:
-                {
-                    currentPose = walk_4;
-                    nextPose = walk_1;
-                    animationDuration = 0.9f;
-                }
-                break;
-
-                case walk_1:
-                {
-                    animationController.walkingCycleCount++;
-                    currentPose = walk_1;
-                    nextPose = walk_2;
-                    animationDuration = 0.5f;
-
-                    if (animationController.walkingCycleCount >=
-                        animationController.MAX_WALKING_CYCLES)
-                    {
-                        animationController.currentState = ANIM_WALKING_TO_GREETING;
-                        human.CloneCurrentBoneRotation(BoneSnapshot);
-                        nextPose = greet_0;
-                        animationDuration = 1.5f;
-                    }
-                }
-                break;
-
-                default:
-                    break;
-                }
-            }
-            break;
-
-            case ANIM_WALKING_TO_GREETING:
-            {
-                currentPose = nextPose;
-                nextPose = greet_1;
-                animationController.currentState = ANIM_GREETING;
-                animationController.greetingCycleCount = 0;
-                animationDuration = 1.0f;
-            }
-            break;
-
-            case ANIM_GREETING:
-            {
-                switch (nextPose)
-                {
-                case greet_1:
-                {
-                    currentPose = greet_1;
-                    nextPose = greet_2;
-                    animationDuration = 0.3f;
-                }
-                break;
-
-                case greet_2:
-                {
-                    currentPose = greet_2;
-                    nextPose = greet_3;
-                    animationDuration = 0.4f;
-                }
-                break;
-
-                case greet_3:
-                {
-                    currentPose = greet_3;
-                    nextPose = greet_4;
-                    animationDuration = 0.3f;
-                }
-                break;
-
-                case greet_4:
-                {
-                    currentPose = greet_4;
-                    nextPose = greet_2;
-                    animationController.greetingCycleCount++;
-                    animationDuration = 0.4f;
-
-                    // Check if we should transition back to walking
-                    if (animationController.greetingCycleCount >=
-                        animationController.MAX_GREETING_CYCLES)
-                    {
-                        human.CloneCurrentBoneRotation(BoneSnapshot);
-                        animationController.currentState = ANIM_GREETING_TO_WALKING;
-                        nextPose = walk_1;
-                        animationDuration = 1.f;
-                    }
-                }
-                break;
-
-                default:
-                    break;
-                }
-            }
-            break;
-
-            case ANIM_GREETING_TO_WALKING:
-            {
-                currentPose = nextPose;
-                nextPose = walk_2;
-                animationController.currentState = ANIM_WALKING;
-                animationController.walkingCycleCount = 0;
-                animationDuration = 0.5f;
-            }
-            break;
-            }
+            const int drawCalls = drawPath == DRAW_PER_BONE ? humanCount * BoneCount : drawPath == DRAW_BAKED ? 2 : 1;
+            const std::string title = std::string(DrawPathNames[drawPath]) + " (I): " + std::to_string(humanCount) +
+                                      " humans, " + std::to_string(drawCalls) + " draw calls, " +
+                                      std::to_string(1000.0f * titleTimer / titleFrames) + " ms/frame, animation " +
+                                      std::to_string(animationMs / titleFrames) + " ms on " + std::to_string(jobs.threadCount()) + " threads";
+            glfwSetWindowTitle(window, title.c_str());
+            titleTimer = 0.0f;
+            titleFrames = 0;
+            animationMs = 0.0;
         }
 
         // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
@@ -404,6 +394,35 @@ void processInput(GLFWwindow *window)
         camera.ProcessKeyboard(LEFT, deltaTime);
     if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
         camera.ProcessKeyboard(RIGHT, deltaTime);
+
+    const bool iPressed = glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS;
+    if (iPressed && !isIKeyPressed)
+        drawPath = static_cast<DrawPath>((drawPath + 1) % DRAW_PATH_COUNT);
+    isIKeyPressed = iPressed;
+}
+
+// one draw call per bone, as Human::DrawHuman does, for bones animated elsewhere
+// ---------------------------------------------------------------------------------------------------------
+void drawBoneInstances(const Shader &shader, unsigned int cubeVAO, const GameProgramming::Animation::BoneInstance *bones, int count)
+{
+    glBindVertexArray(cubeVAO);
+    for (int i = 0; i < count; i++)
+    {
+        shader.setMat4("model", bones[i].model);
+        shader.setVec3("objectColor", bones[i].color);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+}
+
+// crowd humans stand on a square grid behind the animated one, facing the camera
+// ------------------------------------------------------------------------------
+glm::mat4 crowdModel(int index, int crowdSize)
+{
+    const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(crowdSize))));
+    const int row = index / columns;
+    const int column = index % columns;
+    const float spacing = 4.0f;
+    return glm::translate(glm::mat4(1.0f), glm::vec3((column - 0.5f * (columns - 1)) * spacing, 0.0f, -10.0f - row * spacing));
 }
 
 // glfw: whenever the window size changed (by OS or user resize) this callback function executes
@@ -13,6 +13,8 @@
 #include <glm/gtc/quaternion.hpp>
 
 #include "_shader.h"
+#include "bone_renderer.hpp"
+#include "skeleton.hpp"
 
 #include <string>
 #include <vector>
@@ -85,28 +87,6 @@ public:
     // Constructor
     Human()
     {
-        // bone length
-        BoneLength[pelvis] = 1.0f;
-        BoneLength[spine] = 3.0f;
-        BoneLength[neck] = 1.0f;
-        BoneLength[head] = 1.0f;
-        BoneLength[clavicleL] = 1.0f;
-        BoneLength[upperarmL] = 2.0f;
-        BoneLength[forearmL] = 1.5f;
-        BoneLength[handL] = 1.0f;
-        BoneLength[clavicleR] = 1.0f;
-        BoneLength[upperarmR] = 2.0f;
-        BoneLength[forearmR] = 1.5f;
-        BoneLength[handR] = 1.0f;
-        BoneLength[thighL] = 2.5f;
-        BoneLength[calfL] = 2.0f;
-        BoneLength[footL] = 1.0f;
-        BoneLength[toeL] = 0.5f;
-        BoneLength[thighR] = 2.5f;
-        BoneLength[calfR] = 2.0f;
-        BoneLength[footR] = 1.0f;
-        BoneLength[toeR] = 0.5f;
-
         // setup poses
         SetupPoses();
         // bone rotation - base pose
@@ -145,179 +125,136 @@ public:
             BoneRotate[i] = glm::slerp(boneRotations[i], Pose[to][i], t);
     }
 
-    void DrawHuman(Shader shader, unsigned int cubeVAO, glm::mat4 model)
+    // one draw call per bone
+    void DrawHuman(const Shader &shader, unsigned int cubeVAO, glm::mat4 model) const
     {
-        glm::mat4 bone = model;
-        glm::mat4 mpelvis = model;
-        glm::mat4 mspine;
-
-        auto drawCall = [&](Human_Bone boneType, float r, float g, float b) -> void
+        glm::mat4 bones[BONENUM];
+        ComputeBoneMatrices(model, bones);
+        glBindVertexArray(cubeVAO);
+        for (int i = pelvis; i < BoneCount; i++)
         {
-            shader.setMat4("model", bone);
-            shader.setVec3("objectColor", r, g, b);
-            glBindVertexArray(cubeVAO);
+            shader.setMat4("model", bones[i]);
+            shader.setVec3("objectColor", BoneColor[i]);
             glDrawArrays(GL_TRIANGLES, 0, 36);
-        };
-
-        // glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        //  draw pelvis
-        //  2. 모델 행렬을 곱해서 월드 변환 <- 1. 뼈들을 미리 회전변환하고
-        //                     bone   *  glm::mat4_cast(...);
-        bone = bone * glm::mat4_cast(BoneRotate[pelvis]);
-        bone = glm::scale(bone, glm::vec3(1.0f, BoneLength[pelvis], 1.0f));
-        drawCall(pelvis, 1.0f, 1.0f, 0.0f);
-        bone = glm::scale(bone, glm::vec3(1.0f, 1.0f / BoneLength[pelvis], 1.0f));
-
-        // draw spine
-        bone = glm::translate(bone, glm::vec3(0.0f, BoneLength[pelvis], 0.0f));
-        bone = bone * glm::mat4_cast(BoneRotate[spine]);
-        bone = glm::scale(bone, glm::vec3(1.0f, BoneLength[spine], 1.0f));
-        drawCall(spine, 1.0f, 0.5f, 0.3f);
-        bone = glm::scale(bone, glm::vec3(1.0f, 1.0f / BoneLength[spine], 1.0f));
-        mspine = bone;
-
-        // draw neck
-        bone = glm::translate(bone, glm::vec3(0.0f, BoneLength[spine], 0.0f));
-        bone = bone * glm::mat4_cast(BoneRotate[neck]);
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[neck], 0.5f));
-        drawCall(neck, 0.0f, 0.5f, 1.0f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[neck], 2.0f));
-
-        // draw head
-        bone = glm::translate(bone, glm::vec3(0.0f, BoneLength[neck], 0.0f));
-        bone = bone * glm::mat4_cast(BoneRotate[head]);
-        bone = glm::scale(bone, glm::vec3(1.0f, BoneLength[head], 1.0f));
-        drawCall(head, 0.5f, 0.5f, 1.0f);
-        bone = glm::scale(bone, glm::vec3(1.0f, 1.0f / BoneLength[head], 1.0f));
-
-        // draw clavicleL
-        bone = mspine;
-        bone = glm::translate(bone, glm::vec3(0.5f, BoneLength[spine], 0.0f));
-        bone = bone * glm::mat4_cast(BoneRotate[clavicleL]);
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[clavicleL], 0.5f));
-        drawCall(clavicleL, 0.0f, 0.7f, 0.0f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[clavicleL], 2.0f));
-
-        // draw upperarmL
-        bone = mspine;
-        bone = glm::translate(bone, glm::vec3(0.5f, BoneLength[spine], 0.0f));
-        bone = glm::translate(bone, glm::vec3(BoneLength[clavicleL], 0.0f, 0.0f));
-        bone = bone * glm::mat4_cast(BoneRotate[upperarmL]);
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[upperarmL], 0.5f));
-        drawCall(upperarmL, 0.3f, 0.0f, 0.7f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[upperarmL], 2.0f));
-
-        // draw forearmL
-        bone = glm::translate(bone, glm::vec3(0.0f, BoneLength[upperarmL], 0.0f));
-        bone = bone * glm::mat4_cast(BoneRotate[forearmL]);
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[forearmL], 0.5f));
-        drawCall(forearmL, 0.7f, 0.0f, 0.5f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[forearmL], 2.0f));
-
-        // draw handL
-        bone = glm::translate(bone, glm::vec3(0.0f, BoneLength[forearmL], 0.0f));
-        bone = bone * glm::mat4_cast(BoneRotate[handL]);
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[handL], 0.5f));
-        drawCall(handL, 0.0f, 0.5f, 0.5f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[handL], 2.0f));
-
-        // draw clavicleR
-        bone = mspine;
-        bone = glm::translate(bone, glm::vec3(-0.5f, BoneLength[spine], 0.0f));
-        bone = bone * glm::mat4_cast(BoneRotate[clavicleR]);
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[clavicleR], 0.5f));
-        drawCall(clavicleR, 0.0f, 0.7f, 0.0f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[clavicleR], 2.0f));
-
-        // draw upperarmR
-        bone = mspine;
-        bone = glm::translate(bone, glm::vec3(-0.5f, BoneLength[spine], 0.0f));
-        bone = glm::translate(bone, glm::vec3(-BoneLength[clavicleR], 0.0f, 0.0f));
-        bone = bone * glm::mat4_cast(BoneRotate[upperarmR]);
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[upperarmR], 0.5f));
-        drawCall(upperarmR, 0.3f, 0.0f, 0.7f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[upperarmR], 2.0f));
-
-        // draw forearmR
-        bone = glm::translate(bone, glm::vec3(0.0f, BoneLength[upperarmR], 0.0f));
-        bone = bone * glm::mat4_cast(BoneRotate[forearmR]);
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[forearmR], 0.5f));
-        drawCall(forearmR, 0.7f, 0.0f, 0.5f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[forearmR], 2.0f));
-
-        // draw handR
-        bone = glm::translate(bone, glm::vec3(0.0f, BoneLength[forearmR], 0.0f));
-        bone = bone * glm::mat4_cast(BoneRotate[handR]);
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[handR], 0.5f));
-        drawCall(handR, 0.0f, 0.5f, 0.5f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[handR], 2.0f));
-
-        // ================================ 다리 ================================
-        // draw thighL
-        bone = mpelvis;
-        bone = bone * glm::mat4_cast(BoneRotate[thighL]);
-        bone = glm::translate(bone, glm::vec3(.5f, -BoneLength[thighL], 0.f));
-        bone = glm::scale(bone, glm::vec3(.5f, BoneLength[thighL], .5f));
-        drawCall(thighL, 0.5f, 0.5f, 0.5f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[thighL], 2.0f));
-
-        // draw calfL
-        bone = bone * glm::mat4_cast(BoneRotate[calfL]);
-        bone = glm::translate(bone, glm::vec3(0.f, -BoneLength[calfL], 0.0f));
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[calfL], 0.5f));
-        drawCall(calfL, 0.0f, 0.5f, 0.5f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[calfL], 2.0f));
-
-        // draw footL
-        bone = bone * glm::mat4_cast(BoneRotate[footL]);
-        bone = glm::translate(bone, glm::vec3(0.f, -BoneLength[footL], 0.f));
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[footL], 0.5f));
-        drawCall(footL, 0.5f, 0.0f, 0.5f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[footL], 2.0f));
-
-        // draw toeL
-        bone = bone * glm::mat4_cast(BoneRotate[toeL]);
-        bone = glm::translate(bone, glm::vec3(0.f, -BoneLength[toeL], 0.f));
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[toeL], 0.5f));
-        drawCall(toeL, 0.5f, 0.5f, 0.0f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[toeL], 2.0f));
-
-        // draw thighR
-        bone = mpelvis;
-        bone = bone * glm::mat4_cast(BoneRotate[thighR]);
-        bone = glm::translate(bone, glm::vec3(-.5f, -BoneLength[thighR], 0.f));
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[thighR], 0.5f));
-        drawCall(thighR, 0.5f, 0.5f, 0.5f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[thighR], 2.0f));
-
-        // draw calfR
-        bone = bone * glm::mat4_cast(BoneRotate[calfR]);
-        bone = glm::translate(bone, glm::vec3(0.f, -BoneLength[calfR], 0.0f));
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[calfR], 0.5f));
-        drawCall(calfR, 0.0f, 0.5f, 0.5f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[calfR], 2.0f));
-
-        // draw footR
-        bone = bone * glm::mat4_cast(BoneRotate[footR]);
-        bone = glm::translate(bone, glm::vec3(0.f, -BoneLength[footR], 0.f));
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[footR], 0.5f));
-        drawCall(footR, 0.5f, 0.0f, 0.5f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[footR], 2.0f));
-
-        // draw toeR
-        bone = bone * glm::mat4_cast(BoneRotate[toeR]);
-        bone = glm::translate(bone, glm::vec3(0.f, -BoneLength[toeR], 0.f));
-        bone = glm::scale(bone, glm::vec3(0.5f, BoneLength[toeR], 0.5f));
-        drawCall(toeR, 0.5f, 0.5f, 0.0f);
-        bone = glm::scale(bone, glm::vec3(2.0f, 1.0f / BoneLength[toeR], 2.0f));
-
-        // glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        }
+    }
+
+    // The same bones as DrawHuman, written as BoneCount instances for BoneRenderer instead of drawn.
+    void WriteBoneInstances(const glm::mat4 &model, GameProgramming::Animation::BoneInstance *out) const
+    {
+        WriteBoneInstances(BoneRotate, model, out);
+    }
+
+    // The cube's model matrix of every bone for the current rotations, in Human_Bone order.
+    void ComputeBoneMatrices(const glm::mat4 &model, glm::mat4 *bones) const
+    {
+        ComputeBoneMatrices(BoneRotate, model, bones);
+    }
+
+    // The same for BoneCount `rotations` posed elsewhere, e.g. blended for a whole crowd at once.
+    static void WriteBoneInstances(const glm::quat *rotations, const glm::mat4 &model, GameProgramming::Animation::BoneInstance *out)
+    {
+        glm::mat4 bones[BONENUM];
+        ComputeBoneMatrices(rotations, model, bones);
+        for (int i = pelvis; i < BoneCount; i++)
+            out[i] = {bones[i], BoneColor[i], 0.0f};
+    }
+
+    // The skinning palette of the current rotations for a mesh bound with `inverseBind`, see SkinnedRenderer.
+    void WriteSkinningPalette(const glm::mat4 &model, const glm::mat4 *inverseBind, glm::mat4 *palette) const
+    {
+        // the world matrices are read back while walking the hierarchy: keep them out of `palette`, which may be
+        // write-combined mapped memory
+        const GameProgramming::Animation::Skeleton &skeleton = SharedSkeleton();
+        glm::mat4 world[BONENUM];
+        skeleton.computeWorld(model, BoneRotate, world);
+        skeleton.computeSkinning(world, inverseBind, palette);
+    }
+
+    static void ComputeBoneMatrices(const glm::quat *rotations, const glm::mat4 &model, glm::mat4 *bones)
+    {
+        const GameProgramming::Animation::Skeleton &skeleton = SharedSkeleton();
+        skeleton.computeWorld(model, rotations, bones);
+        skeleton.computeShapes(bones, bones);
+    }
+
+    // The bone rotations of a key pose, in Human_Bone order.
+    const glm::quat *PoseRotations(Human_Pose pose) const
+    {
+        return Pose[pose];
+    }
+
+    // The color of every bone, in Human_Bone order.
+    static const glm::vec3 *BoneColors()
+    {
+        return BoneColor;
+    }
+
+    // The hierarchy every Human shares, built once from BoneLength.
+    static const GameProgramming::Animation::Skeleton &SharedSkeleton()
+    {
+        static const GameProgramming::Animation::Skeleton skeleton = BuildSkeleton();
+        return skeleton;
     }
 
 private:
-    float BoneLength[BONENUM];
+    static constexpr glm::vec3 BoneColor[BONENUM] = {
+        {1.0f, 1.0f, 0.0f}, {1.0f, 0.5f, 0.3f}, {0.0f, 0.5f, 1.0f}, {0.5f, 0.5f, 1.0f}, // pelvis, spine, neck, head
+        {0.0f, 0.7f, 0.0f}, {0.3f, 0.0f, 0.7f}, {0.7f, 0.0f, 0.5f}, {0.0f, 0.5f, 0.5f}, // left arm
+        {0.0f, 0.7f, 0.0f}, {0.3f, 0.0f, 0.7f}, {0.7f, 0.0f, 0.5f}, {0.0f, 0.5f, 0.5f}, // right arm
+        {0.5f, 0.5f, 0.5f}, {0.0f, 0.5f, 0.5f}, {0.5f, 0.0f, 0.5f}, {0.5f, 0.5f, 0.0f}, // left leg
+        {0.5f, 0.5f, 0.5f}, {0.0f, 0.5f, 0.5f}, {0.5f, 0.0f, 0.5f}, {0.5f, 0.5f, 0.0f}, // right leg
+    };
+
+    static constexpr float BoneLength[BONENUM] = {
+        1.0f, 3.0f, 1.0f, 1.0f,  // pelvis, spine, neck, head
+        1.0f, 2.0f, 1.5f, 1.0f,  // clavicleL, upperarmL, forearmL, handL
+        1.0f, 2.0f, 1.5f, 1.0f,  // clavicleR, upperarmR, forearmR, handR
+        2.5f, 2.0f, 1.0f, 0.5f,  // thighL, calfL, footL, toeL
+        2.5f, 2.0f, 1.0f, 0.5f,  // thighR, calfR, footR, toeR
+    };
     glm::quat Pose[POSENUM][BONENUM];
 
+    // Arms and the upper body hang their joints off the parent's end (offset, then rotate); legs rotate at the
+    // hip or the knee and then reach down to their end (tail), where the next leg bone attaches. The arms
+    // attach to the spine, next to their clavicle, and the thighs to the model itself, not the rotated pelvis.
+    static GameProgramming::Animation::Skeleton BuildSkeleton()
+    {
+        using glm::vec3;
+        constexpr i32 root = GameProgramming::Animation::Skeleton::Root;
+        const auto thin = [](Human_Bone bone) { return vec3(0.5f, BoneLength[bone], 0.5f); };
+        const auto along = [](Human_Bone bone) { return vec3(0.0f, BoneLength[bone], 0.0f); };
+        const auto down = [](Human_Bone bone, float x) { return vec3(x, -BoneLength[bone], 0.0f); };
+        const vec3 none(0.0f);
+
+        GameProgramming::Animation::Skeleton skeleton;
+        skeleton.addBone(root, none, none, vec3(1.0f, BoneLength[pelvis], 1.0f));
+        skeleton.addBone(pelvis, along(pelvis), none, vec3(1.0f, BoneLength[spine], 1.0f));
+        skeleton.addBone(spine, along(spine), none, thin(neck));
+        skeleton.addBone(neck, along(neck), none, vec3(1.0f, BoneLength[head], 1.0f));
+
+        skeleton.addBone(spine, vec3(0.5f, BoneLength[spine], 0.0f), none, thin(clavicleL));
+        skeleton.addBone(spine, vec3(0.5f + BoneLength[clavicleL], BoneLength[spine], 0.0f), none, thin(upperarmL));
+        skeleton.addBone(upperarmL, along(upperarmL), none, thin(forearmL));
+        skeleton.addBone(forearmL, along(forearmL), none, thin(handL));
+
+        skeleton.addBone(spine, vec3(-0.5f, BoneLength[spine], 0.0f), none, thin(clavicleR));
+        skeleton.addBone(spine, vec3(-0.5f - BoneLength[clavicleR], BoneLength[spine], 0.0f), none, thin(upperarmR));
+        skeleton.addBone(upperarmR, along(upperarmR), none, thin(forearmR));
+        skeleton.addBone(forearmR, along(forearmR), none, thin(handR));
+
+        skeleton.addBone(root, none, down(thighL, 0.5f), thin(thighL));
+        skeleton.addBone(thighL, none, down(calfL, 0.0f), thin(calfL));
+        skeleton.addBone(calfL, none, down(footL, 0.0f), thin(footL));
+        skeleton.addBone(footL, none, down(toeL, 0.0f), thin(toeL));
+
+        skeleton.addBone(root, none, down(thighR, -0.5f), thin(thighR));
+        skeleton.addBone(thighR, none, down(calfR, 0.0f), thin(calfR));
+        skeleton.addBone(calfR, none, down(footR, 0.0f), thin(footR));
+        skeleton.addBone(footR, none, down(toeR, 0.0f), thin(toeR));
+        return skeleton;
+    }
+
     void SetupPoses()
     {
         using glm::angleAxis;
@@ -4,12 +4,19 @@ out vec4 FragColor;
 in vec3 Normal;
 in vec3 Position;
 
-uniform vec3 eyePos;
+layout (std140) uniform PassConstants
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec3 viewPos;
+};
+
 uniform samplerCube skybox;
 
 void main()
 {    
-    vec3 I = normalize(Position - eyePos);
+    vec3 I = normalize(Position - viewPos);
     vec3 R = reflect(I, normalize(Normal));
     FragColor = vec4(texture(skybox, R).rgb, 1.0);
 }
\ No newline at end of file
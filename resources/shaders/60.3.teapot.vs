@@ -6,13 +6,19 @@ layout (location = 2) in vec3 aNormal;
 out vec3 Normal;
 out vec3 Position;
 
+layout (std140) uniform PassConstants
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec3 viewPos;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main()
 {
     Normal = mat3(transpose(inverse(model))) * aNormal;
     Position = vec3(model * vec4(aPos, 1.0));
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = viewProjection * vec4(Position, 1.0);
 }
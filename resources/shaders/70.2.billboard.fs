@@ -0,0 +1,34 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec4 Color;
+in vec2 Corner;
+in float ViewDepth;
+
+// depth of the opaque scene, to fade particles that touch it (soft particles)
+uniform sampler2D sceneDepth;
+uniform float nearPlane;
+uniform float farPlane;
+// view space distance over which a particle fades in front of the scene
+uniform float softness;
+
+float linearDepth(float depth)
+{
+	float z = depth * 2.0 - 1.0;
+	return 2.0 * nearPlane * farPlane / (farPlane + nearPlane - z * (farPlane - nearPlane));
+}
+
+void main()
+{
+	// round sprite with a soft rim
+	float shape = 1.0 - smoothstep(0.5, 1.0, length(Corner));
+	// instead of a hard line where the quad cuts into the scene, fade with the distance to it; behind the scene
+	// the fade is 0, which also hides what is occluded
+	float scene = linearDepth(texelFetch(sceneDepth, ivec2(gl_FragCoord.xy), 0).r);
+	float fade = clamp((scene - ViewDepth) / softness, 0.0, 1.0);
+
+	float alpha = Color.a * shape * fade;
+	if (alpha <= 0.0)
+		discard;
+	FragColor = vec4(Color.rgb, alpha);
+}
@@ -0,0 +1,31 @@
+#version 330 core
+// one camera-facing quad per particle instance, see common/billboard_renderer.hpp
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec4 aColor; // alpha = 1 - age / lifetime
+
+out vec4 Color;
+out vec2 Corner;
+out float ViewDepth;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+// quad width in world units when the particle is born and when it dies
+uniform float sizeStart;
+uniform float sizeEnd;
+
+void main()
+{
+	// triangle strip corners (-1,-1) (1,-1) (-1,1) (1,1)
+	Corner = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2.0 - 1.0;
+	Color = aColor;
+
+	// size over life; dead particles collapse to nothing and are never rasterized
+	float size = aColor.a > 0.0 ? mix(sizeEnd, sizeStart, aColor.a) : 0.0;
+
+	// offset in view space, so the quad always faces the camera
+	vec4 viewPos = view * model * vec4(aPos, 1.0);
+	viewPos.xy += Corner * (0.5 * size);
+	ViewDepth = -viewPos.z;
+	gl_Position = projection * viewPos;
+}
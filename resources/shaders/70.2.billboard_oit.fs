@@ -0,0 +1,35 @@
+#version 330 core
+// 70.2.billboard.fs for the accumulation pass of weighted blended OIT, see common/weighted_oit.hpp
+layout (location = 0) out vec4 Accumulation;
+layout (location = 1) out float Weight;
+
+in vec4 Color;
+in vec2 Corner;
+in float ViewDepth;
+
+uniform sampler2D sceneDepth;
+uniform float nearPlane;
+uniform float farPlane;
+uniform float softness;
+
+float linearDepth(float depth)
+{
+	float z = depth * 2.0 - 1.0;
+	return 2.0 * nearPlane * farPlane / (farPlane + nearPlane - z * (farPlane - nearPlane));
+}
+
+void main()
+{
+	float shape = 1.0 - smoothstep(0.5, 1.0, length(Corner));
+	float scene = linearDepth(texelFetch(sceneDepth, ivec2(gl_FragCoord.xy), 0).r);
+	float fade = clamp((scene - ViewDepth) / softness, 0.0, 1.0);
+
+	float a = Color.a * shape * fade;
+	if (a <= 0.0)
+		discard;
+	// nearer and more opaque counts more (McGuire, Bavoil eq. 9, rescaled to the few units of the scene);
+	// capped so that hundreds of overlapping particles still fit half floats
+	float w = a * clamp(10.0 / (1e-5 + pow(ViewDepth / 5.0, 2.0)), 1e-2, 30.0);
+	Accumulation = vec4(Color.rgb * a * w, a);
+	Weight = a * w;
+}
@@ -0,0 +1,23 @@
+#version 330 core
+layout (location = 0) in vec4 aPositionAge;
+layout (location = 1) in vec4 aVelocityLife;
+layout (location = 2) in vec4 aColor;
+
+out vec4 Color;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+	float life = aPositionAge.w / aVelocityLife.w;
+	if (life >= 1.0)
+	{
+		// dead particles inside the live range are clipped away
+		Color = vec4(0.0);
+		gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+		return;
+	}
+	Color = vec4(aColor.rgb, 1.0 - life);
+	gl_Position = projection * view * vec4(aPositionAge.xyz, 1.0);
+}
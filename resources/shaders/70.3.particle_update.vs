@@ -0,0 +1,85 @@
+#version 330 core
+// One transform feedback step of GpuParticleSystem (projects/common/gpu_particles.hpp): spawns the slots of
+// this update's bursts and integrates everything else. Runs with GL_RASTERIZER_DISCARD.
+layout (location = 0) in vec4 aPositionAge;
+layout (location = 1) in vec4 aVelocityLife;
+layout (location = 2) in vec4 aColor;
+
+out vec4 outPositionAge;
+out vec4 outVelocityLife;
+out vec4 outColor;
+
+const int MaxBursts = 16; // GpuParticleSystem::MaxBurstsPerUpdate
+
+uniform float deltaTime;
+uniform vec3 gravity;
+uniform int capacity;
+uniform int seed;
+
+uniform int burstCount;
+uniform vec4 burstOrigin[MaxBursts];   // xyz, lifetime
+uniform vec4 burstVelocity[MaxBursts]; // xyz, spread
+uniform vec4 burstColor[MaxBursts];    // rgb, jitter
+uniform int burstFirst[MaxBursts];
+uniform int burstSize[MaxBursts];
+
+uint hash(uint x)
+{
+    x ^= x >> 16u;
+    x *= 0x7feb352du;
+    x ^= x >> 15u;
+    x *= 0x846ca68bu;
+    x ^= x >> 16u;
+    return x;
+}
+
+// uniform in [0, 1), advances the state
+float random(inout uint state)
+{
+    state = hash(state);
+    return float(state >> 8u) * (1.0 / 16777216.0);
+}
+
+void spawn(int burst, uint slot)
+{
+    uint state = hash(slot ^ hash(uint(seed)));
+
+    // direction uniform on the sphere, radius biased outwards like the gaussian shells of 70.2
+    float z = random(state) * 2.0 - 1.0;
+    float phi = random(state) * 6.28318530718;
+    float r = sqrt(1.0 - z * z);
+    float speed = burstVelocity[burst].w * (0.5 + 0.5 * random(state));
+    vec3 offset = vec3(r * cos(phi), r * sin(phi), z) * speed;
+
+    vec3 jitter = vec3(random(state), random(state), random(state)) * 2.0 - 1.0;
+    float lifetime = burstOrigin[burst].w * (0.75 + 0.25 * random(state));
+
+    outPositionAge = vec4(burstOrigin[burst].xyz, 0.0);
+    outVelocityLife = vec4(burstVelocity[burst].xyz + offset, lifetime);
+    outColor = vec4(clamp(burstColor[burst].rgb + jitter * burstColor[burst].w, 0.0, 1.0), 1.0);
+}
+
+void main()
+{
+    // newest first: bursts of one update that wrap all the way around the ring overlap the older ones
+    uint slot = uint(gl_VertexID);
+    for (int i = burstCount - 1; i >= 0; --i)
+    {
+        if ((slot + uint(capacity) - uint(burstFirst[i])) % uint(capacity) < uint(burstSize[i]))
+        {
+            spawn(i, slot);
+            return;
+        }
+    }
+
+    outColor = aColor;
+    outVelocityLife = aVelocityLife;
+    if (aPositionAge.w >= aVelocityLife.w)
+    {
+        outPositionAge = aPositionAge; // dead, stays dead
+        return;
+    }
+    vec3 velocity = aVelocityLife.xyz + gravity * deltaTime;
+    outVelocityLife.xyz = velocity;
+    outPositionAge = vec4(aPositionAge.xyz + velocity * deltaTime, aPositionAge.w + deltaTime);
+}
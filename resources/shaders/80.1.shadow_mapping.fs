@@ -5,29 +5,119 @@ in VS_OUT {
     vec3 FragPos;
     vec3 Normal;
     vec2 TexCoords;
-    vec4 FragPosLightSpace;
+    float ViewDepth;
 } fs_in;
 
 uniform sampler2D diffuseTexture;
-uniform sampler2D shadowMap;
+uniform sampler2DArray shadowMap;              // a layer per cascade: raw depth
+uniform sampler2DArrayShadow shadowCompareMap; // the same texture, compared by the texture unit
 
 uniform vec3 lightPos;
 uniform vec3 viewPos;
 
-float ShadowCalculation(vec4 fragPosLightSpace, float bias)
+layout (std140) uniform ShadowCascades
 {
-    // perform perspective divide
-    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
-    // transform to [0,1] range
-    projCoords = projCoords * 0.5 + 0.5;
-    // get closest depth value from light's perspective (using [0,1] range fragPosLight as coords)
-    float closestDepth = texture(shadowMap, projCoords.xy).r; 
-    // get depth of current fragment from light's perspective
-    float currentDepth = projCoords.z;
-    // check whether current frag pos is in shadow
-    float shadow = currentDepth - bias > closestDepth  ? 1.0 : 0.0;
-
-    return shadow;
+    mat4 cascadeMatrices[4];
+    vec4 cascadeSplits[4]; // x: view depth the cascade ends at, y: world size of a texel, z: depth per world unit
+    int cascadeCount;
+};
+
+// GameProgramming::GL::ShadowFilter
+const int SHADOW_HARD = 0;
+const int SHADOW_HARDWARE_PCF = 1;
+const int SHADOW_POISSON_PCF = 2;
+const int SHADOW_PCSS = 3;
+uniform int shadowFilter;
+uniform float lightAngle; // PCSS: penumbra width per unit of distance from blocker to receiver, tan of the light's angular radius
+
+const float PCSS_MAX_RADIUS = 12.0; // texels
+
+const vec2 poissonDisk[16] = vec2[](
+    vec2(-0.94201624, -0.39906216), vec2(0.94558609, -0.76890725), vec2(-0.09418410, -0.92938870), vec2(0.34495938, 0.29387760),
+    vec2(-0.91588581, 0.45771432), vec2(-0.81544232, -0.87912464), vec2(-0.38277543, 0.27676845), vec2(0.97484398, 0.75648379),
+    vec2(0.44323325, -0.97511554), vec2(0.53742981, -0.47373420), vec2(-0.26496911, -0.41893023), vec2(0.79197514, 0.19090188),
+    vec2(-0.24188840, 0.99706507), vec2(-0.81409955, 0.91437590), vec2(0.19984126, 0.78641367), vec2(0.14383161, -0.14100790));
+
+// a different rotation of the disk at every pixel (interleaved gradient noise, Jimenez 2014)
+mat2 DiskRotation()
+{
+    float angle = 6.28318531 * fract(52.9829189 * fract(dot(gl_FragCoord.xy, vec2(0.06711056, 0.00583715))));
+    float s = sin(angle);
+    float c = cos(angle);
+    return mat2(c, s, -s, c);
+}
+
+// shadowed fraction of 16 comparison samples within `radius` texels
+float PoissonPcf(vec2 uv, float layer, float reference, float radius, mat2 rotation)
+{
+    vec2 scale = radius / vec2(textureSize(shadowMap, 0).xy);
+    float lit = 0.0;
+    for (int i = 0; i < 16; ++i)
+        lit += texture(shadowCompareMap, vec4(uv + rotation * poissonDisk[i] * scale, layer, reference));
+    return 1.0 - lit / 16.0;
+}
+
+// percentage closer soft shadows (Fernando 2005): the further the blockers are above the receiver, the wider
+// the penumbra and the disk PCF filters over
+float Pcss(vec2 uv, float layer, float reference, int cascade)
+{
+    mat2 rotation = DiskRotation();
+    vec2 searchScale = PCSS_MAX_RADIUS / vec2(textureSize(shadowMap, 0).xy);
+
+    // 1. mean depth of the blockers within the widest penumbra
+    float blockerDepth = 0.0;
+    float blockers = 0.0;
+    for (int i = 0; i < 16; ++i)
+    {
+        float depth = texture(shadowMap, vec3(uv + rotation * poissonDisk[i] * searchScale, layer)).r;
+        if (depth < reference)
+        {
+            blockerDepth += depth;
+            blockers += 1.0;
+        }
+    }
+    if (blockers == 0.0)
+        return 0.0;
+    blockerDepth /= blockers;
+
+    // 2. penumbra width, from the blocker to receiver distance in world units, in texels of this cascade
+    float blockerDistance = (reference - blockerDepth) / cascadeSplits[cascade].z;
+    float radius = clamp(blockerDistance * lightAngle / cascadeSplits[cascade].y, 1.0, PCSS_MAX_RADIUS);
+
+    // 3. filter over it
+    return PoissonPcf(uv, layer, reference, radius, rotation);
+}
+
+float ShadowCalculation(vec3 fragPos, vec3 normal, vec3 lightDir)
+{
+    // the first cascade reaching past the fragment; nothing is shadowed beyond the last one
+    int cascade = 0;
+    while (cascade < cascadeCount && fs_in.ViewDepth >= cascadeSplits[cascade].x)
+        ++cascade;
+    if (cascade == cascadeCount)
+        return 0.0;
+
+    // biases in texels of this cascade, so they stay the same on screen whichever cascade is used:
+    // look up from a point pushed off the surface, further where the light grazes it, then compare a texel closer
+    float texel = cascadeSplits[cascade].y;
+    float cosTheta = clamp(dot(normal, lightDir), 0.0, 1.0);
+    vec3 offsetPos = fragPos + normal * (1.5 * texel * sqrt(1.0 - cosTheta * cosTheta));
+    vec4 fragPosLightSpace = cascadeMatrices[cascade] * vec4(offsetPos, 1.0);
+
+    // orthographic: no perspective divide needed; transform to [0,1] range
+    vec3 projCoords = fragPosLightSpace.xyz * 0.5 + 0.5;
+    float layer = float(cascade);
+    float reference = projCoords.z - texel * cascadeSplits[cascade].z;
+
+    if (shadowFilter == SHADOW_HARDWARE_PCF)
+        return 1.0 - texture(shadowCompareMap, vec4(projCoords.xy, layer, reference));
+    if (shadowFilter == SHADOW_POISSON_PCF)
+        return PoissonPcf(projCoords.xy, layer, reference, 2.5, DiskRotation());
+    if (shadowFilter == SHADOW_PCSS)
+        return Pcss(projCoords.xy, layer, reference, cascade);
+
+    float closestDepth = texture(shadowMap, vec3(projCoords.xy, layer)).r;
+    return reference > closestDepth ? 1.0 : 0.0;
 }
 
 void main()
@@ -49,8 +139,7 @@ void main()
     spec = pow(max(dot(normal, halfwayDir), 0.0), 64.0);
     vec3 specular = spec * lightColor;    
     // calculate shadow
-    float bias = max(0.05 * (1.0 - dot(normal, lightDir)), 0.005);  
-    float shadow = ShadowCalculation(fs_in.FragPosLightSpace, bias);                      
+    float shadow = ShadowCalculation(fs_in.FragPos, normal, lightDir);                      
     vec3 lighting = (ambient + (1.0 - shadow) * (diffuse + specular)) * color;    
     
     FragColor = vec4(lighting, 1.0);
@@ -9,20 +9,19 @@ out VS_OUT {
     vec3 FragPos;
     vec3 Normal;
     vec2 TexCoords;
-    vec4 FragPosLightSpace;
+    float ViewDepth;
 } vs_out;
 
 uniform mat4 projection;
 uniform mat4 view;
 uniform mat4 model;
-uniform mat4 lightSpaceMatrix;
 
 void main()
 {
     vs_out.FragPos = vec3(model * vec4(aPos, 1.0));
     vs_out.Normal = transpose(inverse(mat3(model))) * aNormal;
     vs_out.TexCoords = aTexCoords;
-    vs_out.FragPosLightSpace = lightSpaceMatrix * vec4(vs_out.FragPos, 1.0);
+    vs_out.ViewDepth = -(view * vec4(vs_out.FragPos, 1.0)).z;
     gl_Position = projection * view *  vec4(vs_out.FragPos, 1.0);
     //gl_Position = projection * view * model * vec4(aPos, 1.0);
 }
\ No newline at end of file
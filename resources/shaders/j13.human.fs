@@ -3,11 +3,11 @@ out vec4 FragColor;
 
 in vec3 Normal;  
 in vec3 FragPos;  
+in vec3 ObjectColor;
   
 uniform vec3 lightPos; 
 uniform vec3 viewPos; 
 uniform vec3 lightColor;
-uniform vec3 objectColor;
 
 void main()
 {
@@ -28,7 +28,7 @@ void main()
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), 64);
     vec3 specular = specularStrength * spec * lightColor;  
         
-    vec3 result = (ambient + diffuse + specular) * objectColor;
-    // vec3 result = 1.0 * objectColor;
+    vec3 result = (ambient + diffuse + specular) * ObjectColor;
+    // vec3 result = 1.0 * ObjectColor;
     FragColor = vec4(result, 1.0);
 } 
\ No newline at end of file
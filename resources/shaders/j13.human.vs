@@ -4,14 +4,17 @@ layout (location = 1) in vec3 aNormal;
 
 out vec3 FragPos;
 out vec3 Normal;
+out vec3 ObjectColor;
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+uniform vec3 objectColor;
 
 void main()
 {
     FragPos = vec3(model * vec4(aPos, 1.0));
+    ObjectColor = objectColor;
     Normal = mat3(transpose(inverse(model))) * aNormal;  
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
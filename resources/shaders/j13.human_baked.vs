@@ -0,0 +1,62 @@
+#version 330 core
+// a crowd playing baked clips, every human in one instanced draw, see common/baked_crowd_renderer.hpp
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec4 aColor;
+layout (location = 3) in uvec4 aBones;
+layout (location = 4) in vec4 aWeights;
+layout (location = 5) in vec4 aPlacement; // position, time offset
+layout (location = 6) in uint aClip;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec3 ObjectColor;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+const int MaxClips = 8;
+uniform sampler2D bakedPalettes; // a frame per row, three texels (the top rows of a matrix) per bone
+uniform ivec2 clipFrames[MaxClips]; // first frame, frame count
+uniform int boneCount;
+uniform float framesPerSecond;
+uniform float time;
+
+// rows of the bone's skinning matrix at `frame`, the bottom row being 0 0 0 1
+mat4 bakedMatrix(int frame, uint bone)
+{
+    int texel = 3 * int(bone);
+    vec4 r0 = texelFetch(bakedPalettes, ivec2(texel, frame), 0);
+    vec4 r1 = texelFetch(bakedPalettes, ivec2(texel + 1, frame), 0);
+    vec4 r2 = texelFetch(bakedPalettes, ivec2(texel + 2, frame), 0);
+    return transpose(mat4(r0, r1, r2, vec4(0.0, 0.0, 0.0, 1.0)));
+}
+
+void main()
+{
+    // the two frames around this instance's time and the weight between them, looping through its clip
+    ivec2 clip = clipFrames[aClip];
+    float position = mod((time + aPlacement.w) * framesPerSecond, float(clip.y));
+    int frame = int(position);
+    float t = position - float(frame);
+    int frame0 = clip.x + min(frame, clip.y - 1);
+    int frame1 = clip.x + (frame + 1) % clip.y;
+
+    mat4 skin = mat4(0.0);
+    for (int i = 0; i < 4; ++i)
+    {
+        if (aWeights[i] > 0.0)
+        {
+            mat4 m0 = bakedMatrix(frame0, aBones[i]);
+            skin += aWeights[i] * (m0 + (bakedMatrix(frame1, aBones[i]) - m0) * t);
+        }
+    }
+    // the weights sum to one, so moving the blended matrix's translation moves the whole human
+    skin[3].xyz += aPlacement.xyz;
+
+    FragPos = vec3(skin * vec4(aPos, 1.0));
+    Normal = mat3(skin) * aNormal;
+    ObjectColor = aColor.rgb;
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
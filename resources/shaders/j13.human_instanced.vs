@@ -0,0 +1,22 @@
+#version 330 core
+// every bone of every human in one instanced draw, see common/bone_renderer.hpp
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in mat4 aModel; // locations 2..5
+layout (location = 6) in vec3 aColor;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec3 ObjectColor;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    FragPos = vec3(aModel * vec4(aPos, 1.0));
+    Normal = mat3(transpose(inverse(aModel))) * aNormal;
+    ObjectColor = aColor;
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
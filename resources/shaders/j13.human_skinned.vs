@@ -0,0 +1,43 @@
+#version 330 core
+// every human as one skinned mesh, all of them in one instanced draw, see common/skinned_renderer.hpp
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec4 aColor;
+layout (location = 3) in uvec4 aBones;
+layout (location = 4) in vec4 aWeights;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec3 ObjectColor;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+uniform samplerBuffer palette; // four texels per matrix
+uniform int paletteOffset;     // first matrix of this frame's palettes
+uniform int boneCount;
+
+mat4 skinMatrix(uint bone)
+{
+    int texel = 4 * (paletteOffset + gl_InstanceID * boneCount + int(bone));
+    return mat4(texelFetch(palette, texel), texelFetch(palette, texel + 1), texelFetch(palette, texel + 2),
+                texelFetch(palette, texel + 3));
+}
+
+void main()
+{
+    // linear blend skinning; the palette matrices are rigid, so the blend also carries the normal
+    mat4 skin = aWeights.x * skinMatrix(aBones.x);
+    if (aWeights.y > 0.0)
+        skin += aWeights.y * skinMatrix(aBones.y);
+    if (aWeights.z > 0.0)
+        skin += aWeights.z * skinMatrix(aBones.z);
+    if (aWeights.w > 0.0)
+        skin += aWeights.w * skinMatrix(aBones.w);
+
+    FragPos = vec3(skin * vec4(aPos, 1.0));
+    Normal = mat3(skin) * aNormal;
+    ObjectColor = aColor.rgb;
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}